@@ -71,3 +71,15 @@ check_cxx_source_compiles("
 if(HAVE_GLIBC)
   add_definitions(-DHAVE_GLIBC=1)
 endif()
+
+# The workers can use io_uring if the kernel headers have multishot polling
+check_cxx_source_compiles("
+  #include <linux/io_uring.h>\n
+  int main(){\n
+      return IORING_POLL_ADD_MULTI | IORING_ENTER_EXT_ARG;\n
+  }\n"
+  HAVE_IO_URING)
+
+if(HAVE_IO_URING)
+  add_definitions(-DHAVE_IO_URING=1)
+endif()
@@ -87,7 +87,8 @@ typedef enum
  */
 typedef enum
 {
-    GWBUF_PARSING_INFO
+    GWBUF_PARSING_INFO,
+    GWBUF_BINLOG_READAHEAD  /*< The binlog read-ahead chunk the data points into */
 } bufobj_id_t;
 
 typedef struct buffer_object_st buffer_object_t;
@@ -430,4 +431,25 @@ void gwbuf_hexdump(GWBUF* buffer, int log_level);
  */
 extern uint8_t* gwbuf_byte_pointer(GWBUF* buffer, size_t offset);
 
+/**
+ * Statistics of the buffer pool of a routing worker.
+ */
+typedef struct
+{
+    uint64_t hits;          /*< Allocations served from the pool */
+    uint64_t misses;        /*< Allocations of a pooled size not available in the pool */
+    uint64_t fallbacks;     /*< Allocations too large to be pooled */
+    uint64_t remote_frees;  /*< Blocks freed by other threads and returned to the pool */
+    uint64_t cached;        /*< Blocks currently available in the pool */
+} GWBUF_POOL_STATS;
+
+/**
+ * Get the statistics of the buffer pool of the calling routing worker.
+ *
+ * @param pStats  On return, the statistics.
+ *
+ * @return True, if the calling thread is a routing worker and @c pStats was filled.
+ */
+extern bool gwbuf_get_pool_stats(GWBUF_POOL_STATS* pStats);
+
 MXS_END_DECLS
@@ -128,7 +128,9 @@ extern const char CN_GATEWAY[];
 extern const char CN_HAS_WHERE_CLAUSE[];
 extern const char CN_ID[];
 extern const char CN_INET[];
+extern const char CN_IO_BACKEND[];
 extern const char CN_LISTENER[];
+extern const char CN_LISTENER_MODE[];
 extern const char CN_LISTENERS[];
 extern const char CN_LOCALHOST_MATCH_WILDCARD_HOST[];
 extern const char CN_LOG_AUTH_WARNINGS[];
@@ -199,6 +201,8 @@ extern const char CN_USER[];
 extern const char CN_USERS[];
 extern const char CN_VERSION_STRING[];
 extern const char CN_WEIGHTBY[];
+extern const char CN_WORKER_AFFINITY[];
+extern const char CN_WORKER_ASSIGNMENT[];
 extern const char CN_WRITEQ_HIGH_WATER[];
 extern const char CN_WRITEQ_LOW_WATER[];
 
@@ -220,6 +224,9 @@ extern const char CN_SYSLOG[];
 extern const char CN_MAXLOG[];
 extern const char CN_LOG_AUGMENTATION[];
 extern const char CN_LOG_TO_SHM[];
+extern const char CN_LOG_ASYNC[];
+extern const char CN_LOG_ASYNC_BUFFER_SIZE[];
+extern const char CN_LOG_ASYNC_OVERFLOW[];
 
 /**
  * The config parameter
@@ -294,6 +301,7 @@ typedef struct
     char             peer_user[MAX_ADMIN_HOST_LEN];     /**< Username for maxscale-to-maxscale traffic */
     char             peer_password[MAX_ADMIN_HOST_LEN]; /**< Password for maxscale-to-maxscale traffic */
     mxb_log_target_t log_target;                        /**< Log type */
+    MXB_LOG_ASYNC    log_async;                         /**< Asynchronous logging */
 } MXS_CONFIG;
 
 /**
@@ -19,6 +19,7 @@
 #include <maxscale/cdefs.h>
 #include <netinet/in.h>
 #include <maxbase/poll.h>
+#include <maxbase/timingwheel.h>
 #include <maxscale/authenticator.h>
 #include <maxscale/buffer.h>
 #include <maxscale/log.h>
@@ -45,7 +46,9 @@ struct dcb;
 typedef struct dcbstats
 {
     int n_reads;        /*< Number of reads on this descriptor */
-    int n_writes;       /*< Number of writes on this descriptor */
+    int n_ioctls;       /*< Number of FIONREAD ioctls on this descriptor */
+    int n_writes;       /*< Number of write system calls on this descriptor */
+    int64_t n_written;  /*< Number of bytes written to this descriptor */
     int n_accepts;      /*< Number of accepts on this descriptor */
     int n_buffered;     /*< Number of buffered writes */
     int n_high_water;   /*< Number of crosses of high water mark */
@@ -177,6 +180,8 @@ typedef struct dcb
     bool                    dcb_errhandle_called;   /*< this can be called only once */
     dcb_role_t              dcb_role;
     int                     fd;                         /**< The descriptor */
+    int*                    reuseport_fds;              /**< For a listener, the SO_REUSEPORT socket of
+                                                         * each worker, or NULL if it has one socket */
     dcb_state_t             state;                      /**< Current descriptor state */
     SSL_STATE               ssl_state;                  /**< Current state of SSL if in use */
     int                     flags;                      /**< DCB flags */
@@ -198,6 +203,7 @@ typedef struct dcb
     GWBUF*   writeq;                                    /**< Write Data Queue */
     GWBUF*   delayq;                                    /**< Delay Backend Write Data Queue */
     GWBUF*   readq;                                     /**< Read queue for storing incomplete reads */
+    int      read_size;                                 /**< Size of the next read, adapted to recent reads */
     GWBUF*   fakeq;                                     /**< Fake event queue for generated events */
     uint32_t fake_event;                                /**< Fake event to be delivered to handler */
 
@@ -212,6 +218,9 @@ typedef struct dcb
     void*           authenticator_data;     /**< The authenticator data for this DCB */
     DCB_CALLBACK*   callbacks;              /**< The list of callbacks for the DCB */
     int64_t         last_read;              /*< Last time the DCB received data */
+    int64_t         connect_start;          /*< When the connection to the server was started, in
+                                             * microseconds of the monotonic clock */
+    MXB_TIMER       idle_timer;             /*< Expires when a client DCB may have been idle too long */
     struct server*  server;                 /**< The associated backend server */
     SSL*            ssl;                    /*< SSL struct for connection */
     bool            ssl_read_want_read;     /*< Flag */
@@ -304,6 +313,14 @@ int      dcb_listen(DCB* listener, const char* config, const char* protocol_name
 void     dcb_enable_session_timeouts();
 void     dcb_process_idle_sessions(int thr);
 
+/**
+ * @brief Called by a backend protocol when the authentication with the server
+ * has completed, to record the time the handshake took.
+ *
+ * @param dcb  A backend DCB
+ */
+void dcb_handshake_complete(DCB* dcb);
+
 /**
  * @brief Append a buffer the DCB's readqueue
  *
@@ -455,6 +472,9 @@ json_t* dcb_to_json(DCB* dcb);
  */
 #define DCBF_HUNG    0x0002     /*< Hangup has been dispatched */
 #define DCBF_REPLIED 0x0004     /*< DCB was written to */
+#define DCBF_IDLE    0x0008     /*< Closed while idle, may be pooled even if the session may not */
+#define DCBF_PREWARMED 0x0010   /*< Opened in the background to fill the persistent pool */
+#define DCBF_POOL_PING 0x0020   /*< Pinged while in the persistent pool, the reply is pending */
 
 #define DCB_REPLIED(d) ((d)->flags & DCBF_REPLIED)
 
@@ -54,8 +54,11 @@ bool mxs_log_init(const char* ident, const char* logdir, mxs_log_target_t target
 #define mxs_log_message mxb_log_message
 #define mxs_log_rotate  mxb_log_rotate
 
+#define mxs_log_get_async                 mxb_log_get_async
+#define mxs_log_get_async_stats           mxb_log_get_async_stats
 #define mxs_log_get_throttling            mxb_log_get_throttling
 #define mxs_log_is_priority_enabled       mxb_log_is_priority_enabled
+#define mxs_log_set_async                 mxb_log_set_async
 #define mxs_log_set_augmentation          mxb_log_set_augmentation
 #define mxs_log_set_highprecision_enabled mxb_log_set_highprecision_enabled
 #define mxs_log_set_maxlog_enabled        mxb_log_set_maxlog_enabled
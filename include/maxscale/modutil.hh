@@ -26,5 +26,15 @@ namespace maxscale
 
 std::string extract_sql(GWBUF* buffer, size_t len = -1);
 
-std::string get_canonical(GWBUF* querybuf);
+/**
+ * Get the canonical form of a query, where literal values have been replaced
+ * with question marks and comments and repeated whitespace have been removed.
+ *
+ * @param querybuf      A COM_QUERY or COM_STMT_PREPARE packet.
+ * @param pFingerprint  If non-NULL, on return contains a 64-bit fingerprint
+ *                      of the canonical form.
+ *
+ * @return The canonical form of the query.
+ */
+std::string get_canonical(GWBUF* querybuf, uint64_t* pFingerprint = NULL);
 }
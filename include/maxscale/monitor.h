@@ -222,6 +222,7 @@ typedef struct monitored_server
     uint64_t                 mon_prev_status;   /**< Status before starting the current monitor loop */
     uint64_t                 pending_status;    /**< Status during current monitor loop */
     int64_t                  disk_space_checked;/**< When was the disk space checked the last time */
+    int64_t                  probe_latency_us;  /**< How long the latest probe took, in microseconds */
     struct monitored_server* next;              /**< The next server in the list */
 } MXS_MONITORED_SERVER;
 
@@ -269,6 +270,7 @@ struct mxs_monitor
     int64_t                disk_space_check_interval;       /**< How often should a disk space check be made
                                                              * at most. */
     uint64_t            ticks;                              /**< Number of performed monitoring intervals */
+    bool                concurrent_probing;                 /**< Whether servers are probed concurrently */
     struct mxs_monitor* next;                               /**< Next monitor in the linked list */
 };
 
@@ -279,6 +281,7 @@ extern const char CN_BACKEND_CONNECT_ATTEMPTS[];
 extern const char CN_BACKEND_CONNECT_TIMEOUT[];
 extern const char CN_BACKEND_READ_TIMEOUT[];
 extern const char CN_BACKEND_WRITE_TIMEOUT[];
+extern const char CN_CONCURRENT_PROBING[];
 extern const char CN_DISK_SPACE_CHECK_INTERVAL[];
 extern const char CN_EVENTS[];
 extern const char CN_JOURNAL_MAX_AGE[];
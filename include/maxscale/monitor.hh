@@ -15,6 +15,9 @@
 #include <maxscale/ccdefs.hh>
 
 #include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
 #include <maxbase/semaphore.hh>
 #include <maxbase/worker.hh>
 #include <maxscale/monitor.h>
@@ -148,6 +151,22 @@ protected:
      */
     void update_disk_space_status(MXS_MONITORED_SERVER* pMonitored_server);
 
+    /**
+     * @brief Probe all monitored servers.
+     *
+     * Calls @c probe for each monitored server and stores the time the call
+     * took as the probe latency of the server. If @c concurrent_probing is
+     * enabled, the calls are made concurrently from separate threads, in which
+     * case @c probe may access only the server it is called with. Otherwise the
+     * calls are made one after the other from the monitor thread.
+     *
+     * The function returns when all calls have returned, so a server that does
+     * not respond delays the return at most by the connect and read timeouts.
+     *
+     * @param probe  The function to call for each server.
+     */
+    void probe_servers(const std::function<void (MXS_MONITORED_SERVER*)>& probe);
+
     /**
      * @brief Configure the monitor.
      *
@@ -228,6 +247,12 @@ private:
     mxb::Semaphore    m_semaphore;      /**< Semaphore for synchronizing with monitor thread. */
     int64_t           m_loop_called;    /**< When was the loop called the last time. */
 
+    class ProbeWorker;
+    std::vector<std::unique_ptr<ProbeWorker>> m_probe_workers;  /**< Threads for concurrent probing. */
+
+    bool start_probe_workers(size_t n);
+    void stop_probe_workers();
+
     bool pre_run() final;
     void post_run() final;
 
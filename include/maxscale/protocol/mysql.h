@@ -346,6 +346,9 @@ typedef struct
                                              * packet type */
     bool large_query;                       /*< Whether to ignore the command byte of the next
                                              * packet*/
+    bool    compress;                       /*< Whether the compressed protocol is in use */
+    uint8_t compress_seq;                   /*< Sequence number of the next compressed packet */
+    GWBUF*  compressed_readq;               /*< Incomplete compressed packets read from the network */
 } MySQLProtocol;
 
 typedef struct
@@ -493,6 +496,7 @@ int gw_decode_mysql_server_handshake(MySQLProtocol* conn, uint8_t* payload);
  * @param with_ssl             Whether to create an SSL response or a normal response packet
  * @param ssl_established      Set to true if the SSL response has been sent
  * @param service_capabilities Capabilities of the connecting service
+ * @param compress             Whether to request the compressed protocol
  *
  * @return Generated response packet
  */
@@ -500,7 +504,8 @@ GWBUF* gw_generate_auth_response(MYSQL_session* client,
                                  MySQLProtocol* conn,
                                  bool with_ssl,
                                  bool ssl_established,
-                                 uint64_t service_capabilities);
+                                 uint64_t service_capabilities,
+                                 bool compress);
 
 /** Read the backend server's handshake */
 bool gw_read_backend_handshake(DCB* dcb, GWBUF* buffer);
@@ -514,6 +519,29 @@ int send_mysql_native_password_response(DCB* dcb);
 /** Sends an AuthSwitchRequest packet with the default auth plugin to the DCB */
 bool send_auth_switch_request_packet(DCB* dcb);
 
+/**
+ * Read data from a backend server. If the compressed protocol is in use, the
+ * data is decompressed and only complete compressed packets are returned.
+ *
+ * @param dcb       The backend DCB.
+ * @param ppBuffer  On return, the data read, preceded by the contents of the
+ *                  read queue of the DCB. NULL if there was no data.
+ *
+ * @return The number of bytes returned, or -1 on error.
+ */
+int mxs_mysql_backend_read(DCB* dcb, GWBUF** ppBuffer);
+
+/**
+ * Write data to a backend server, compressing it if the compressed protocol
+ * is in use.
+ *
+ * @param dcb     The backend DCB.
+ * @param buffer  One or more complete MySQL packets.
+ *
+ * @return The return value of dcb_write().
+ */
+int mxs_mysql_backend_write(DCB* dcb, GWBUF* buffer);
+
 /** Write an OK packet to a DCB */
 int mxs_mysql_send_ok(DCB* dcb, int sequence, uint8_t affected_rows, const char* message);
 
@@ -451,8 +451,19 @@ typedef struct QC_CACHE_PROPERTIES
     int64_t max_size;   /** The maximum size of the cache. */
 } QC_CACHE_PROPERTIES;
 
+/**
+ * The number of buckets in the histograms of QC_CACHE_STATS.
+ */
+#define QC_CACHE_STATS_BUCKETS 8
+
 /**
  * QC_CACHE_STATS provides statistics of the cache.
+ *
+ * In the histograms by size, bucket 0 counts statements shorter than 64 bytes
+ * and each following bucket doubles the limit, so that the last one counts
+ * statements of 4096 bytes or more. In the histogram by hits, bucket 0 counts
+ * entries that were never hit, bucket 1 those hit once, and bucket n those hit
+ * from 2^(n-1) to 2^n - 1 times, with the last one counting the rest.
  */
 typedef struct QC_CACHE_STATS
 {
@@ -461,6 +472,9 @@ typedef struct QC_CACHE_STATS
     int64_t hits;       /** The number of hits. */
     int64_t misses;     /** The number of misses. */
     int64_t evictions;  /** The number of evictions. */
+    int64_t hits_by_size[QC_CACHE_STATS_BUCKETS];       /** Hits by statement size. */
+    int64_t misses_by_size[QC_CACHE_STATS_BUCKETS];     /** Misses by statement size. */
+    int64_t evictions_by_hits[QC_CACHE_STATS_BUCKETS];  /** Evictions by hits of the entry. */
 } QC_CACHE_STATS;
 
 /**
@@ -188,6 +188,11 @@ public:
         clear_tmp_tables();
     }
 
+    bool have_tmp_tables() const
+    {
+        return m_have_tmp_tables;
+    }
+
     bool large_query() const
     {
         return m_large_query;
@@ -289,11 +294,6 @@ private:
         m_load_data_sent = 0;
     }
 
-    bool have_tmp_tables() const
-    {
-        return m_have_tmp_tables;
-    }
-
     void set_have_tmp_tables(bool have_tmp_tables)
     {
         m_have_tmp_tables = have_tmp_tables;
@@ -98,6 +98,31 @@ public:
      */
     static bool remove_shared_fd(int fd);
 
+    /**
+     * Add one descriptor to the epoll instance of each worker. This is intended
+     * for listening sockets that share their port using SO_REUSEPORT, so that
+     * the kernel distributes the new connections and each worker accepts only
+     * from its own socket.
+     *
+     * @param pFds    Array with one descriptor per worker, in the order of the
+     *                worker ids.
+     * @param events  Mask of epoll event types.
+     * @param pData   The poll data associated with all the descriptors.
+     *
+     * @return True, if the descriptors could be added, false otherwise. If false
+     *         is returned, none of the descriptors has been added.
+     */
+    static bool add_reuseport_fds(const int* pFds, uint32_t events, MXB_POLL_DATA* pData);
+
+    /**
+     * Remove descriptors added with @c add_reuseport_fds.
+     *
+     * @param pFds  Array with one descriptor per worker.
+     *
+     * @return True on success, false on failure.
+     */
+    static bool remove_reuseport_fds(const int* pFds);
+
     /**
      * Returns the id of the routing worker
      *
@@ -320,12 +345,144 @@ public:
      */
     static int64_t get_one_statistic(POLL_STAT what);
 
+    /**
+     * How new client connections are assigned to workers.
+     */
+    enum assignment_t
+    {
+        ASSIGN_ROUND_ROBIN,     /*< The workers are picked in turn. */
+        ASSIGN_LEAST_LOADED,    /*< The worker with the fewest descriptors, weighted by load. */
+        ASSIGN_ADDRESS_HASH,    /*< The worker is picked by hashing the client address. */
+    };
+
+    /**
+     * Set how new client connections are assigned to workers.
+     *
+     * @param assignment  The assignment policy.
+     */
+    static void set_assignment(assignment_t assignment);
+
+    /**
+     * @return How new client connections are assigned to workers.
+     */
+    static assignment_t get_assignment();
+
+    /**
+     * Convert an assignment policy to a string.
+     *
+     * @param assignment  The assignment policy.
+     *
+     * @return The policy as a string, as accepted in the configuration.
+     */
+    static const char* assignment_to_string(assignment_t assignment);
+
+    /**
+     * Convert a string to an assignment policy.
+     *
+     * @param zValue       One of "round_robin", "least_loaded" and "address_hash".
+     * @param pAssignment  On success, the corresponding policy.
+     *
+     * @return True, if the string was a valid policy, false otherwise.
+     */
+    static bool assignment_from_string(const char* zValue, assignment_t* pAssignment);
+
+    /**
+     * How listeners distribute new connections over the workers.
+     */
+    enum listener_mode_t
+    {
+        LISTENER_SHARED,        /*< One socket, in an epoll instance polled by all workers. */
+        LISTENER_REUSEPORT,     /*< One SO_REUSEPORT socket per worker, picked by the kernel. */
+        LISTENER_REUSEPORT_CPU, /*< As LISTENER_REUSEPORT, but picked by the CPU of the packet. */
+    };
+
+    /**
+     * Set how listeners that are created later distribute their connections.
+     *
+     * @param mode  The listener mode.
+     */
+    static void set_listener_mode(listener_mode_t mode);
+
+    /**
+     * @return How listeners distribute their connections.
+     */
+    static listener_mode_t get_listener_mode();
+
+    /**
+     * Convert a listener mode to a string.
+     *
+     * @param mode  The listener mode.
+     *
+     * @return The mode as a string, as accepted in the configuration.
+     */
+    static const char* listener_mode_to_string(listener_mode_t mode);
+
+    /**
+     * Convert a string to a listener mode.
+     *
+     * @param zValue  One of "shared", "reuseport" and "reuseport_cpu".
+     * @param pMode   On success, the corresponding mode.
+     *
+     * @return True, if the string was a valid mode, false otherwise.
+     */
+    static bool listener_mode_from_string(const char* zValue, listener_mode_t* pMode);
+
+    /**
+     * Set the CPUs the routing workers are bound to. Takes effect when the
+     * workers are created.
+     *
+     * @param zValue  "none", "cores" for one worker per physical core, or a
+     *                comma separated list of CPUs and CPU ranges, e.g. "0-3,8".
+     *
+     * @return True, if the value was valid, false otherwise.
+     */
+    static bool set_affinity(const char* zValue);
+
+    /**
+     * @return The affinity, as set with @c set_affinity.
+     */
+    static const char* get_affinity();
+
+    /**
+     * Map the CPUs to workers for steering new connections.
+     *
+     * @return For each CPU, the index of the worker bound to it or, if no worker
+     *         is, of a worker bound to a CPU of the same NUMA node. Empty if the
+     *         workers are not bound to CPUs.
+     */
+    static std::vector<int> get_cpu_map();
+
+    /**
+     * @return The CPU the worker is bound to, or -1 if it is not bound.
+     */
+    int cpu() const
+    {
+        return m_cpu;
+    }
+
     /**
      * Get next worker
      *
+     * If listeners have a socket per worker and this is called by a worker,
+     * the kernel has already picked the worker and the calling worker is
+     * returned.
+     *
+     * @param zAddress  The address of the client the worker is picked for,
+     *                  used when assigning by address hash. If NULL, or if
+     *                  another policy is used, the address is ignored.
+     *
      * @return The worker where work should be assigned
      */
-    static RoutingWorker* pick_worker();
+    static RoutingWorker* pick_worker(const char* zAddress = NULL);
+
+    /**
+     * @return The number of client connections assigned to this worker by
+     *         @c pick_worker.
+     */
+    uint64_t assigned_connections() const
+    {
+        return mxb::atomic::load(&m_nAssigned, mxb::atomic::RELAXED);
+    }
 
     /**
      * Worker local storage
@@ -496,6 +653,8 @@ private:
                                      *  it's up to the protocol to decide whether a new
                                      *  session is added to the map. */
     Zombies      m_zombies;         /*< DCBs to be deleted. */
+    uint64_t     m_nAssigned;       /*< Number of connections assigned to this worker. */
+    int          m_cpu;             /*< The CPU the worker is bound to, -1 if none. */
     LocalData    m_local_data;      /*< Data local to this worker */
     DataDeleters m_data_deleters;   /*< Delete functions for the local data */
 
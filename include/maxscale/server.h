@@ -39,7 +39,9 @@ extern const char CN_MONITORPW[];
 extern const char CN_MONITORUSER[];
 extern const char CN_PERSISTMAXTIME[];
 extern const char CN_PERSISTPOOLMAX[];
+extern const char CN_PERSISTPOOLMIN[];
 extern const char CN_PROXY_PROTOCOL[];
+extern const char CN_COMPRESSION[];
 
 /**
  * Maintenance mode request constants.
@@ -75,7 +77,16 @@ typedef struct
     int      n_persistent;  /**< Current persistent pool */
     uint64_t n_new_conn;    /**< Times the current pool was empty */
     uint64_t n_from_pool;   /**< Times when a connection was available from the pool */
+    uint64_t n_pool_misses; /**< Times when no connection was available from the pool */
+    uint64_t n_prewarmed;   /**< Connections opened in the background to fill the pool */
+    uint64_t n_handshakes;  /**< Completed connection handshakes */
+    uint64_t handshake_time;/**< Microseconds spent in the completed handshakes */
     uint64_t packets;       /**< Number of packets routed to this server */
+    uint64_t compressed_in;     /**< Compressed bytes read from the server */
+    uint64_t uncompressed_in;   /**< Bytes the compressed data read from the server expanded to */
+    uint64_t compressed_out;    /**< Compressed bytes written to the server */
+    uint64_t uncompressed_out;  /**< Bytes compressed before being written to the server */
+    uint64_t compression_time;  /**< Microseconds spent compressing and decompressing */
 } SERVER_STATS;
 
 /**
@@ -136,9 +147,13 @@ typedef struct server
     char monuser[MAX_SERVER_MONUSER_LEN];   /**< Monitor username, overrides monitor setting */
     char monpw[MAX_SERVER_MONPW_LEN];       /**< Monitor password, overrides monitor setting  */
     long persistpoolmax;                    /**< Maximum size of persistent connections pool */
+    long persistpoolmin;                    /**< Number of connections kept in the pool of each
+                                             *   worker, opened in the background if needed */
     long persistmaxtime;                    /**< Maximum number of seconds connection can live */
     bool proxy_protocol;                    /**< Send proxy-protocol header to backends when connecting
                                              *   routing sessions. */
+    bool compression;                       /**< Use the compressed protocol with the server, if it
+                                             *   supports it. */
     SERVER_PARAM* parameters;               /**< Additional custom parameters which may affect routing
                                              * decisions. */
     // Base variables
@@ -24,4 +24,39 @@ namespace maxscale
 
 bool server_set_status(SERVER* server, int bit, std::string* errmsg_out = NULL);
 bool server_clear_status(SERVER* server, int bit, std::string* errmsg_out = NULL);
+
+/**
+ * Set the replication position of a server
+ *
+ * Replaces the known position with the given one. Called by the monitors with
+ * the value of @c gtid_current_pos of the server.
+ *
+ * @param server    The server
+ * @param gtid_pos  A comma separated list of MariaDB GTIDs, empty if unknown
+ */
+void server_set_gtid_pos(SERVER* server, const std::string& gtid_pos);
+
+/**
+ * Advance the replication position of a server
+ *
+ * The sequence number of each domain in @c gtid_pos is raised to the given one
+ * if it is higher than the known one. Used when a server is known to have
+ * reached a position, for instance after a successful MASTER_GTID_WAIT.
+ *
+ * @param server    The server
+ * @param gtid_pos  A comma separated list of MariaDB GTIDs
+ */
+void server_advance_gtid_pos(SERVER* server, const std::string& gtid_pos);
+
+/**
+ * Check whether a server is known to have reached a replication position
+ *
+ * @param server    The server
+ * @param gtid_pos  A comma separated list of MariaDB GTIDs
+ *
+ * @return True if the known position of the server is at or beyond @c gtid_pos
+ *         in every domain of it. False if not, if the position of the server is
+ *         not known or if @c gtid_pos could not be parsed.
+ */
+bool server_has_gtid_pos(const SERVER* server, const std::string& gtid_pos);
 }
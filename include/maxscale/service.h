@@ -102,6 +102,8 @@ typedef struct service
     const char*    name;                            /**< The service name */
     int            state;                           /**< The service state */
     int            client_count;                    /**< Number of connected clients */
+    int            internal_count;                  /**< Number of internal sessions included in
+                                                     * client_count */
     int            max_connections;                 /**< Maximum client connections */
     SERV_LISTENER* ports;                           /**< Linked list of ports and
                                                      * protocols
@@ -69,6 +69,8 @@ typedef struct ssl_listener
     bool              ssl_init_done;        /*< If SSL has already been initialized for this service
                                              * */
     bool ssl_verify_peer_certificate;       /*< Enable peer certificate verification */
+    SSL_SESSION* session;                   /*< The latest session of a connection to a server, used
+                                             * to resume the sessions of new connections */
     struct ssl_listener
     * next;             /*< Next SSL configuration, currently used to store obsolete configurations */
 } SSL_LISTENER;
@@ -96,4 +98,13 @@ int ssl_authenticate_check_status(struct dcb* dcb);
 // TODO: Move this to an internal ssl.h header
 void write_ssl_config(int fd, SSL_LISTENER* ssl);
 
+/**
+ * Resume the latest session of the SSL configuration, if there is one, when
+ * connecting to a server
+ *
+ * @param ssl       The SSL configuration of the server
+ * @param ssl_conn  A new SSL connection that has not done the handshake
+ */
+void SSL_LISTENER_resume_session(SSL_LISTENER* ssl, SSL* ssl_conn);
+
 MXS_END_DECLS
@@ -39,7 +39,8 @@ MXS_BEGIN_DECLS
 /** The type of the socket */
 enum mxs_socket_type
 {
-    MXS_SOCKET_LISTENER,    /**< */
+    MXS_SOCKET_LISTENER,            /**< */
+    MXS_SOCKET_LISTENER_REUSEPORT,  /**< A listener that shares its port using SO_REUSEPORT */
     MXS_SOCKET_NETWORK,
 };
 
@@ -73,7 +74,9 @@ bool configure_network_socket(int so, int type);
  * either bind() (for listeners) or connect() (for outbound network connections).
  *
  * @param type Type of the socket, either MXS_SOCKET_LISTENER for a listener
- *             socket or MXS_SOCKET_NETWORK for a network connection socket
+ *             socket, MXS_SOCKET_LISTENER_REUSEPORT for a listener socket that
+ *             other sockets may bind to the same port with, or MXS_SOCKET_NETWORK
+ *             for a network connection socket
  * @param addr Pointer to a struct sockaddr_storage where the socket
  *             configuration is stored
  * @param host The target host for which the socket is created
@@ -393,6 +393,14 @@ public:
         return rval;
     }
 
+    /**
+     * @return The number of entries in the registry.
+     */
+    size_t size() const
+    {
+        return m_registry.size();
+    }
+
 private:
     typedef typename std::unordered_map<id_type, entry_type> ContainerType;
     ContainerType m_registry;
@@ -70,5 +70,20 @@ void store(T* t, R v, int mode = SEQ_CST)
 {
     __atomic_store_n(t, v, mode);
 }
+
+/**
+ * Perform atomic exchange operation
+ *
+ * @param t    Variable where the value is stored
+ * @param v    Value to store
+ * @param mode Memory ordering
+ *
+ * @return The old value
+ */
+template<class T, class R>
+T exchange(T* t, R v, int mode = SEQ_CST)
+{
+    return __atomic_exchange_n(t, v, mode);
+}
 }
 }
@@ -16,6 +16,7 @@
 
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <syslog.h>
 #include <unistd.h>
 
@@ -71,6 +72,28 @@ typedef struct MXB_LOG_THROTTLING
     size_t suppress_ms; // If exceeded, suppress such messages for this many ms.
 } MXB_LOG_THROTTLING;
 
+typedef enum mxb_log_overflow_t
+{
+    MXB_LOG_OVERFLOW_DROP,  // Drop messages that do not fit into the buffer.
+    MXB_LOG_OVERFLOW_BLOCK  // Wait until there is room in the buffer.
+} mxb_log_overflow_t;
+
+typedef struct MXB_LOG_ASYNC
+{
+    bool               enabled;     // Whether messages are written by a dedicated thread.
+    size_t             buffer_size; // Size of the message buffer of each thread.
+    mxb_log_overflow_t overflow;    // What to do when the buffer of a thread is full.
+} MXB_LOG_ASYNC;
+
+typedef struct MXB_LOG_ASYNC_STATS
+{
+    uint64_t written;   // Number of messages written.
+    uint64_t dropped;   // Number of messages dropped due to a full buffer.
+    uint64_t blocked;   // Number of messages that had to wait for room in a buffer.
+    uint64_t batches;   // Number of batched writes.
+    uint64_t buffers;   // Number of threads currently having a buffer.
+} MXB_LOG_ASYNC_STATS;
+
 /**
  * Prototype for function providing additional information.
  *
@@ -226,6 +249,30 @@ void mxb_log_set_throttling(const MXB_LOG_THROTTLING* throttling);
  */
 void mxb_log_get_throttling(MXB_LOG_THROTTLING* throttling);
 
+/**
+ * Set the asynchronous logging parameters.
+ *
+ * @param async  The asynchronous logging parameters.
+ *
+ * @attention The parameters take effect when the log is initialized, so this
+ *            function should be called before @c mxb_log_init().
+ */
+void mxb_log_set_async(const MXB_LOG_ASYNC* async);
+
+/**
+ * Get the asynchronous logging parameters.
+ *
+ * @param async  The asynchronous logging parameters.
+ */
+void mxb_log_get_async(MXB_LOG_ASYNC* async);
+
+/**
+ * Get the asynchronous logging statistics.
+ *
+ * @param stats  The statistics. All zero, if asynchronous logging is not in use.
+ */
+void mxb_log_get_async_stats(MXB_LOG_ASYNC_STATS* stats);
+
 /**
  * Redirect  stdout to the log file
  *
@@ -14,12 +14,19 @@
 
 #include <maxbase/ccdefs.hh>
 
+#include <atomic>
 #include <string>
 #include <mutex>
 #include <memory>
+#include <thread>
+#include <vector>
+#include <condition_variable>
 
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <maxbase/semaphore.hh>
+
 namespace maxbase
 {
 
@@ -55,6 +62,16 @@ public:
      */
     virtual bool write(const char* msg, int len) = 0;
 
+    /**
+     * Write several messages to the log
+     *
+     * @param iov  The messages to write. The array may be modified.
+     * @param n    Number of elements in @c iov
+     *
+     * @return True on success
+     */
+    virtual bool writev(struct iovec* iov, int n);
+
     /**
      * Rotate the logfile
      *
@@ -62,6 +79,13 @@ public:
      */
     virtual bool rotate() = 0;
 
+    /**
+     * Wait until all messages written so far have reached the log
+     */
+    virtual void flush()
+    {
+    }
+
     /**
      * Get the name of the log file
      *
@@ -113,6 +137,16 @@ public:
      */
     bool write(const char* msg, int len);
 
+    /**
+     * Write several messages to the log with a single system call
+     *
+     * @param iov  The messages to write. The array may be modified.
+     * @param n    Number of elements in @c iov
+     *
+     * @return True on success
+     */
+    bool writev(struct iovec* iov, int n);
+
     /**
      * Rotate the logfile by reopening it
      *
@@ -178,4 +212,110 @@ private:
     {
     }
 };
+
+/**
+ * A logger that decouples the logging threads from the actual writing.
+ *
+ * Each thread appends its messages to a buffer of its own, from where a
+ * dedicated thread moves them in batches to the underlying logger. The
+ * order of the messages of one thread is retained, but messages of different
+ * threads that are logged at roughly the same time may end up in the log in
+ * a different order.
+ */
+class AsyncLogger : public Logger
+{
+public:
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    enum overflow_t
+    {
+        DROP,   /**< Drop the message if the buffer of the thread is full. */
+        BLOCK   /**< Wait until there is room in the buffer of the thread. */
+    };
+
+    struct Stats
+    {
+        uint64_t written;   /**< Messages handed over to the underlying logger. */
+        uint64_t dropped;   /**< Messages dropped because a buffer was full. */
+        uint64_t blocked;   /**< Messages that had to wait because a buffer was full. */
+        uint64_t batches;   /**< Batches handed over to the underlying logger. */
+        uint64_t buffers;   /**< Current number of thread buffers. */
+    };
+
+    /**
+     * Create a new asynchronous logger
+     *
+     * @param sLogger      The logger the messages eventually are written to.
+     * @param buffer_size  The size of the buffer of each thread. Will be rounded
+     *                     up to the next power of 2, and to at least 64KiB.
+     * @param overflow     What to do when the buffer of a thread is full.
+     *
+     * @return New logger instance or an empty unique_ptr on error
+     */
+    static std::unique_ptr<Logger> create(std::unique_ptr<Logger> sLogger,
+                                          size_t buffer_size,
+                                          overflow_t overflow);
+
+    /**
+     * Write all pending messages to the underlying logger and close it.
+     */
+    ~AsyncLogger();
+
+    /**
+     * Append a message to the buffer of the calling thread
+     *
+     * @param msg Message to write
+     * @param len Length of message
+     *
+     * @return True, if the message was buffered, false if it was dropped.
+     */
+    bool write(const char* msg, int len);
+
+    /**
+     * Write all pending messages and rotate the underlying logger
+     *
+     * @return True if the log was rotated
+     */
+    bool rotate();
+
+    /**
+     * Write all pending messages to the underlying logger
+     */
+    void flush();
+
+    /**
+     * @return The statistics of the logger.
+     */
+    Stats stats() const;
+
+    class Buffer;
+
+private:
+    AsyncLogger(std::unique_ptr<Logger> sLogger, size_t buffer_size, overflow_t overflow);
+
+    Buffer* get_buffer();
+    void    wake_writer();
+    void    wait_for_room();
+    int     drain();
+    void    run();
+
+    std::unique_ptr<Logger>              m_sLogger;
+    const size_t                         m_buffer_size;
+    const overflow_t                     m_overflow;
+    const uint64_t                       m_id;          /**< Unique id, to tell instances apart. */
+    mutable std::mutex                   m_lock;        /**< Protects m_buffers and the draining. */
+    std::vector<std::shared_ptr<Buffer>> m_buffers;
+    std::thread                          m_thread;
+    std::atomic<bool>                    m_stop;
+    std::atomic<bool>                    m_sleeping;
+    Semaphore                            m_sem;
+    std::mutex                           m_room_lock;
+    std::condition_variable              m_room_cond;
+    std::atomic<int>                     m_waiters;
+    std::atomic<uint64_t>                m_written;
+    std::atomic<uint64_t>                m_dropped;
+    std::atomic<uint64_t>                m_blocked;
+    std::atomic<uint64_t>                m_batches;
+};
 }
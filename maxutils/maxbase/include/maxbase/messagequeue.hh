@@ -13,6 +13,7 @@
 #pragma once
 
 #include <maxbase/ccdefs.hh>
+#include <atomic>
 #include <maxbase/poll.hh>
 
 namespace maxbase
@@ -105,7 +106,13 @@ public:
 
 /**
  * The class @c MessageQueue provides a cross thread message queue implemented
- * on top of a pipe.
+ * as a bounded lock-free multi-producer/single-consumer queue, with an eventfd
+ * that wakes up the consuming worker.
+ *
+ * The eventfd is written to only when the consumer may be about to sleep, that
+ * is, when it has found the queue empty after having processed the messages.
+ * While the consumer is processing messages, messages are posted without any
+ * system calls.
  */
 class MessageQueue : private mxb::PollData
 {
@@ -133,7 +140,7 @@ public:
     /**
      * Destructor
      *
-     * Removes itself If still added to a worker and closes the pipe.
+     * Removes itself If still added to a worker and closes the eventfd.
      */
     ~MessageQueue();
 
@@ -144,9 +151,12 @@ public:
      * @param message  The message to be posted. A bitwise copy of the message
      *                 will be delivered to the handler, after an unspecified time.
      *
-     * @return True if the message could be posted, false otherwise. Note that
-     *         a return value of true only means that the message could successfully
-     *         be posted, not that it has reached the handler.
+     * @return True if the message could be posted, false otherwise, which will
+     *         be the case if the queue remains full. Note that a return value of
+     *         true only means that the message could successfully be posted, not
+     *         that it has reached the handler.
+     *
+     * @note The function is lock-free and signal safe.
      *
      * @attention Note that the message queue must have been added to a worker
      *            before a message can be posted.
@@ -181,16 +191,43 @@ private:
     static void finish();
 
 private:
-    MessageQueue(Handler* pHandler, int read_fd, int write_fd);
+    enum
+    {
+        N_CELLS   = 32768,  // The capacity of the queue, must be a power of 2.
+        MAX_BATCH = 1024    // The maximum number of messages handled per wakeup.
+    };
+
+    /**
+     * A slot of the queue. The sequence number tells whether the cell is free
+     * for the producer whose position it is, or holds a message for the
+     * consumer whose position it is.
+     */
+    struct Cell
+    {
+        std::atomic<uint64_t> seq;
+        Message               message;
+    };
+
+    MessageQueue(Handler* pHandler, int event_fd, Cell* pCells);
+
+    bool push(const Message& message) const;
+    bool pop(Message* pMessage);
+    bool is_empty() const;
+    void ring() const;
 
     uint32_t handle_poll_events(Worker* pWorker, uint32_t events);
 
     static uint32_t poll_handler(MXB_POLL_DATA* pData, MXB_WORKER* worker, uint32_t events);
 
 private:
-    Handler& m_handler;
-    int      m_read_fd;
-    int      m_write_fd;
-    Worker*  m_pWorker;
+    Handler&                      m_handler;
+    int                           m_event_fd;
+    Worker*                       m_pWorker;
+    Cell*                         m_pCells;
+    uint64_t                      m_head;       /*< The position of the consumer. */
+    char                          m_pad1[64];   /*< Keeps the positions on separate cache lines. */
+    mutable std::atomic<uint64_t> m_tail;       /*< The position of the next producer. */
+    char                          m_pad2[64];
+    mutable std::atomic<bool>     m_pending;    /*< Whether the consumer has been or will be woken up. */
 };
 }
@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxbase/cdefs.h>
+#include <stdint.h>
+
+MXB_BEGIN_DECLS
+
+/**
+ * A timer of a timing wheel. The structure is embedded in the object the timer
+ * is for and all fields are managed by the wheel. A zeroed structure is a timer
+ * that is not scheduled.
+ */
+typedef struct MXB_TIMER
+{
+    struct MXB_TIMER* prev; /*< The previous timer in the same slot. */
+    struct MXB_TIMER* next; /*< The next timer in the same slot, NULL if not scheduled. */
+    int64_t           at;   /*< When the timer expires. */
+    int32_t           slot; /*< The slot the timer is in. */
+} MXB_TIMER;
+
+MXB_END_DECLS
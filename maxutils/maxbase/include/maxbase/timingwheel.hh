@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxbase/ccdefs.hh>
+#include <stddef.h>
+#include <maxbase/timingwheel.h>
+
+namespace maxbase
+{
+
+/**
+ * A hierarchical timing wheel.
+ *
+ * The timers are kept in doubly linked lists, one per slot of the wheel, so
+ * adding and removing a timer takes constant time. The first level has a slot
+ * per tick for the next 256 ticks and each of the four following levels has 64
+ * slots, each covering 64 slots of the level below. When the time reaches the
+ * range of a slot of a higher level, the timers of the slot are cascaded down
+ * to the level below. Timers further than 2^32 ticks away are cascaded until
+ * they are within range.
+ *
+ * The unit of the time is decided by the user, for instance milliseconds, and
+ * a timer expires on the tick it is due. The wheel is not thread-safe.
+ */
+class TimingWheel
+{
+public:
+    TimingWheel(const TimingWheel&) = delete;
+    TimingWheel& operator=(const TimingWheel&) = delete;
+
+    /**
+     * Constructor
+     *
+     * @param now  The current time.
+     */
+    explicit TimingWheel(int64_t now = 0);
+
+    /**
+     * Whether a timer has been added to a wheel and has not yet been removed
+     * or returned by @c expire.
+     */
+    static bool is_scheduled(const MXB_TIMER* pTimer)
+    {
+        return pTimer->next != nullptr;
+    }
+
+    /**
+     * Add a timer.
+     *
+     * @param pTimer  A timer that is not scheduled.
+     * @param at      When the timer expires. If the time has already passed,
+     *                the timer expires with the next tick.
+     */
+    void add(MXB_TIMER* pTimer, int64_t at);
+
+    /**
+     * Remove a timer. Does nothing if the timer is not scheduled.
+     *
+     * @param pTimer  A timer of this wheel.
+     */
+    void remove(MXB_TIMER* pTimer);
+
+    /**
+     * Get an expired timer. The timer is removed from the wheel before it is
+     * returned, so the caller may add it again. Timers may be added and removed
+     * between the calls, so the timers should be fetched one at a time until
+     * NULL is returned.
+     *
+     * @param now  The current time.
+     *
+     * @return A timer due at @c now or earlier, or NULL if there is none.
+     */
+    MXB_TIMER* expire(int64_t now);
+
+    /**
+     * The time when @c expire should be called next. It is no later than the
+     * earliest expiry, but may be earlier if timers must be moved between the
+     * levels of the wheel before then.
+     *
+     * @return The time, or INT64_MAX if there are no timers.
+     */
+    int64_t next_expiry() const;
+
+    /**
+     * @return The number of scheduled timers.
+     */
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    static const int     LEVEL0_BITS = 8;
+    static const int     LEVEL0_SIZE = 1 << LEVEL0_BITS;
+    static const int     LEVEL_BITS = 6;
+    static const int     LEVEL_SIZE = 1 << LEVEL_BITS;
+    static const int     N_LEVELS = 5;
+    static const int     N_SLOTS = LEVEL0_SIZE + (N_LEVELS - 1) * LEVEL_SIZE;
+    static const int     READY = N_SLOTS;   // The slot of the expired timers.
+    static const int64_t MAX_DELTA = ((int64_t)1 << (LEVEL0_BITS + (N_LEVELS - 1) * LEVEL_BITS)) - 1;
+
+    static int shift(int level)
+    {
+        return LEVEL0_BITS + (level - 1) * LEVEL_BITS;
+    }
+
+    static int first_slot(int level)
+    {
+        return LEVEL0_SIZE + (level - 1) * LEVEL_SIZE;
+    }
+
+    bool is_empty(int slot) const
+    {
+        return m_slots[slot].next == &m_slots[slot];
+    }
+
+    void    insert(MXB_TIMER* pTimer);
+    void    link(MXB_TIMER* pTimer, int slot);
+    void    unlink(MXB_TIMER* pTimer);
+    void    cascade(int slot);
+    void    set_tick(int64_t tick);
+    int     first_occupied(int from, int to) const;
+    int64_t next_tick() const;
+
+    int64_t   m_tick;                       /*< The next tick to be processed. */
+    size_t    m_size;                       /*< The number of scheduled timers. */
+    MXB_TIMER m_slots[N_SLOTS + 1];         /*< The list heads of the slots. */
+    uint64_t  m_occupied[N_SLOTS / 64 + 1]; /*< A bit per slot that has timers. */
+};
+}
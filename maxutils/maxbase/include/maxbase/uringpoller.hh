@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxbase/ccdefs.hh>
+#include <mutex>
+#include <unordered_map>
+#include <sys/epoll.h>
+#include <maxbase/poll.h>
+
+namespace maxbase
+{
+
+/**
+ * An io_uring based replacement for the epoll_wait() and epoll_ctl() calls of
+ * a worker.
+ *
+ * Each descriptor is watched with a multishot poll request, whose completions
+ * are edge-triggered like the EPOLLET registrations of the epoll backend. The
+ * requests for adding and removing descriptors are only queued and submitted
+ * with the next wait, which is a single io_uring_enter() call. Adding or
+ * removing a descriptor thus costs no system call of its own.
+ *
+ * The epoll instance of the worker is watched as well, so that descriptors
+ * added directly to it, such as the level-triggered listener instance shared
+ * by the routing workers, keep working.
+ */
+class UringPoller
+{
+public:
+    UringPoller(const UringPoller&) = delete;
+    UringPoller& operator=(const UringPoller&) = delete;
+
+    /**
+     * Create a poller.
+     *
+     * @param epoll_fd  The epoll instance of the worker.
+     * @param entries   The size of the submission queue.
+     *
+     * @return A new poller, or NULL if io_uring is not available or the kernel
+     *         lacks the features that are needed.
+     */
+    static UringPoller* create(int epoll_fd, uint32_t entries);
+
+    ~UringPoller();
+
+    /**
+     * Start watching a descriptor. Corresponds to EPOLL_CTL_ADD.
+     *
+     * @param fd      The descriptor.
+     * @param events  Mask of epoll event types.
+     * @param pData   The poll data to be returned with the events.
+     *
+     * @return True, if the descriptor could be added. Otherwise false, with
+     *         errno set as epoll_ctl() would have set it.
+     */
+    bool add_fd(int fd, uint32_t events, MXB_POLL_DATA* pData);
+
+    /**
+     * Stop watching a descriptor. Corresponds to EPOLL_CTL_DEL.
+     *
+     * @param fd  The descriptor.
+     *
+     * @return True, if the descriptor was removed. Otherwise false, with
+     *         errno set as epoll_ctl() would have set it.
+     */
+    bool remove_fd(int fd);
+
+    /**
+     * Submit the queued requests and wait for events. Corresponds to epoll_wait().
+     *
+     * @param pEvents     Array where the events are returned.
+     * @param max_events  The size of the array.
+     * @param timeout     Timeout in milliseconds, -1 for waiting indefinitely.
+     *
+     * @return The number of events, or -1 on error with errno set.
+     */
+    int wait(struct epoll_event* pEvents, int max_events, int timeout);
+
+private:
+    struct Ring;
+
+    struct Registration
+    {
+        uint32_t       generation;  /*< Tells apart completions of earlier registrations of the fd. */
+        uint32_t       events;      /*< The epoll events being watched. */
+        MXB_POLL_DATA* pData;       /*< The poll data of the descriptor. */
+        bool           armed;       /*< Whether a poll request is active. */
+    };
+
+    UringPoller(Ring* pRing, int epoll_fd);
+
+    void arm(int fd, const Registration& registration);
+    void flush();
+
+    Ring*                                 m_pRing;          /*< The mapped io_uring. */
+    int                                   m_epoll_fd;       /*< The epoll instance of the worker. */
+    bool                                  m_epoll_armed;    /*< Whether the epoll instance is watched. */
+    uint32_t                              m_generation;     /*< The generation of the next registration. */
+    std::mutex                            m_lock;           /*< Protects the submission queue. */
+    std::unordered_map<int, Registration> m_registrations;  /*< The watched descriptors. */
+};
+}
@@ -27,12 +27,15 @@
 #include <maxbase/average.hh>
 #include <maxbase/messagequeue.hh>
 #include <maxbase/semaphore.hh>
+#include <maxbase/timingwheel.hh>
 #include <maxbase/worker.h>
 #include <maxbase/workertask.hh>
 
 namespace maxbase
 {
 
+class UringPoller;
+
 struct WORKER_STATISTICS
 {
     enum
@@ -322,6 +325,44 @@ public:
         MAX_EVENTS = 1000
     };
 
+    enum io_backend_t
+    {
+        IO_BACKEND_EPOLL,   /**< Wait for events with epoll_wait() */
+        IO_BACKEND_IO_URING /**< Wait for events with io_uring */
+    };
+
+    /**
+     * Set the I/O backend of the workers created after the call. If io_uring
+     * is requested but not supported, a worker falls back to epoll.
+     *
+     * @param backend  The backend.
+     */
+    static void set_io_backend(io_backend_t backend);
+
+    /**
+     * @return The I/O backend requested for new workers.
+     */
+    static io_backend_t get_io_backend();
+
+    /**
+     * Convert an I/O backend to a string.
+     *
+     * @param backend  The backend.
+     *
+     * @return The backend as a string.
+     */
+    static const char* io_backend_to_string(io_backend_t backend);
+
+    /**
+     * Convert a string to an I/O backend.
+     *
+     * @param zValue    The string.
+     * @param pBackend  On success, the backend.
+     *
+     * @return True, if the string was a valid backend.
+     */
+    static bool io_backend_from_string(const char* zValue, io_backend_t* pBackend);
+
     /**
      * Constructs a worker.
      *
@@ -349,6 +390,16 @@ public:
         return m_state;
     }
 
+    /**
+     * Returns the I/O backend the worker actually uses.
+     *
+     * @return The backend.
+     */
+    io_backend_t io_backend() const
+    {
+        return m_pUring ? IO_BACKEND_IO_URING : IO_BACKEND_EPOLL;
+    }
+
     /**
      * Returns statistics for this worker.
      *
@@ -742,7 +793,7 @@ private:
         return ++m_next_delayed_call_id;
     }
 
-    class DelayedCall
+    class DelayedCall : public MXB_TIMER
     {
         DelayedCall(const DelayedCall&) = delete;
         DelayedCall& operator=(const DelayedCall&) = delete;
@@ -780,7 +831,8 @@ private:
 
     protected:
         DelayedCall(int32_t delay, int32_t id)
-            : m_id(id)
+            : MXB_TIMER()
+            , m_id(id)
             , m_delay(delay)
             , m_at(get_at(delay))
         {
@@ -930,22 +982,13 @@ private:
 
     void tick();
 private:
-    class LaterAt : public std::binary_function<const DelayedCall*, const DelayedCall*, bool>
-    {
-    public:
-        bool operator()(const DelayedCall* pLhs, const DelayedCall* pRhs)
-        {
-            return pLhs->at() > pRhs->at();
-        }
-    };
-
     void run(mxb::Semaphore* pSem);
 
     typedef DelegatingTimer<Worker>                    PrivateTimer;
-    typedef std::multimap<int64_t, DelayedCall*>       DelayedCallsByTime;
     typedef std::unordered_map<uint32_t, DelayedCall*> DelayedCallsById;
 
     uint32_t           m_max_events;            /*< Maximum numer of events in each epoll_wait call. */
+    UringPoller*       m_pUring;                /*< The io_uring poller, if used instead of epoll. */
     STATISTICS         m_statistics;            /*< Worker statistics. */
     MessageQueue*      m_pQueue;                /*< The message queue of the worker. */
     std::thread        m_thread;                /*< The thread object of the worker. */
@@ -956,7 +999,7 @@ private:
     uint64_t           m_nTotal_descriptors;    /*< Total number of descriptors. */
     Load               m_load;                  /*< The worker load. */
     PrivateTimer*      m_pTimer;                /*< The worker's own timer. */
-    DelayedCallsByTime m_sorted_calls;          /*< Current delayed calls sorted by time. */
+    TimingWheel        m_calls_by_time;         /*< Current delayed calls by time. */
     DelayedCallsById   m_calls;                 /*< Current delayed calls indexed by id. */
 
     int32_t m_next_delayed_call_id;     /*< The next delayed call id. */
@@ -44,6 +44,9 @@ int DEFAULT_LOG_AUGMENTATION = 0;
 // A message that is logged 10 times in 1 second will be suppressed for 10 seconds.
 static MXB_LOG_THROTTLING DEFAULT_LOG_THROTTLING = {10, 1000, 10000};
 
+// Synchronous logging by default.
+static MXB_LOG_ASYNC DEFAULT_LOG_ASYNC = {false, 1024 * 1024, MXB_LOG_OVERFLOW_DROP};
+
 // BUFSIZ comes from the system. It equals with block size or its multiplication.
 const int MAX_LOGSTRLEN = BUFSIZ;
 
@@ -56,39 +59,30 @@ uint64_t time_monotonic_ms()
     return now.tv_sec * 1000 + now.tv_nsec / 1000000;
 }
 
-// Regular timestamp
-std::string get_timestamp(void)
+// Large enough for either kind of timestamp.
+const int TIMESTAMP_MAXLEN = 64;
+
+// Regular timestamp, written to a buffer of TIMESTAMP_MAXLEN bytes.
+int get_timestamp(char* buf)
 {
     time_t t = time(NULL);
     struct tm tm;
     localtime_r(&t, &tm);
     static const char timestamp_formatstr[] = "%04d-%02d-%02d %02d:%02d:%02d   ";
-    static int required = snprintf(NULL,
-                                   0,
-                                   timestamp_formatstr,
-                                   tm.tm_year + 1900,
-                                   tm.tm_mon + 1,
-                                   tm.tm_mday,
-                                   tm.tm_hour,
-                                   tm.tm_min,
-                                   tm.tm_sec);
-    char buf[required + 1];
-
-    snprintf(buf,
-             sizeof(buf),
-             timestamp_formatstr,
-             tm.tm_year + 1900,
-             tm.tm_mon + 1,
-             tm.tm_mday,
-             tm.tm_hour,
-             tm.tm_min,
-             tm.tm_sec);
-
-    return buf;
+
+    return snprintf(buf,
+                    TIMESTAMP_MAXLEN,
+                    timestamp_formatstr,
+                    tm.tm_year + 1900,
+                    tm.tm_mon + 1,
+                    tm.tm_mday,
+                    tm.tm_hour,
+                    tm.tm_min,
+                    tm.tm_sec);
 }
 
-// High-precision timestamp
-std::string get_timestamp_hp(void)
+// High-precision timestamp, written to a buffer of TIMESTAMP_MAXLEN bytes.
+int get_timestamp_hp(char* buf)
 {
     struct timeval tv;
     gettimeofday(&tv, NULL);
@@ -97,31 +91,17 @@ std::string get_timestamp_hp(void)
     int usec = tv.tv_usec / 1000;
 
     static const char timestamp_formatstr_hp[] = "%04d-%02d-%02d %02d:%02d:%02d.%03d   ";
-    static int required = snprintf(NULL,
-                                   0,
-                                   timestamp_formatstr_hp,
-                                   tm.tm_year + 1900,
-                                   tm.tm_mon + 1,
-                                   tm.tm_mday,
-                                   tm.tm_hour,
-                                   tm.tm_min,
-                                   tm.tm_sec,
-                                   usec);
-
-    char buf[required + 1];
-
-    snprintf(buf,
-             sizeof(buf),
-             timestamp_formatstr_hp,
-             tm.tm_year + 1900,
-             tm.tm_mon + 1,
-             tm.tm_mday,
-             tm.tm_hour,
-             tm.tm_min,
-             tm.tm_sec,
-             usec);
-
-    return buf;
+
+    return snprintf(buf,
+                    TIMESTAMP_MAXLEN,
+                    timestamp_formatstr_hp,
+                    tm.tm_year + 1900,
+                    tm.tm_mon + 1,
+                    tm.tm_mday,
+                    tm.tm_hour,
+                    tm.tm_min,
+                    tm.tm_sec,
+                    usec);
 }
 
 struct LOG_PREFIX
@@ -387,6 +367,8 @@ struct this_unit
     bool                             do_maxlog;         // Can change during the lifetime of log_manager.
     bool                             redirect_stdout;
     MXB_LOG_THROTTLING               throttling;        // Can change during the lifetime of log_manager.
+    MXB_LOG_ASYNC                    async;             // Takes effect when the log is initialized.
+    mxb::AsyncLogger*                pAsync_logger;     // Points to sLogger, if logging asynchronously.
     std::unique_ptr<mxb::Logger>     sLogger;
     std::unique_ptr<MessageRegistry> sMessage_registry;
     size_t                           (* context_provider)(char* buffer, size_t len);
@@ -398,6 +380,8 @@ struct this_unit
     true,                       // do_maxlog
     false,                      // redirect_stdout
     DEFAULT_LOG_THROTTLING,     // throttling
+    DEFAULT_LOG_ASYNC,          // async
+    nullptr,                    // pAsync_logger
 };
 
 class MessageRegistry
@@ -453,10 +437,6 @@ bool mxb_log_init(const char* ident,
 {
     assert(!this_unit.sLogger && !this_unit.sMessage_registry);
 
-    // Trigger calculation of buffer lengths.
-    get_timestamp();
-    get_timestamp_hp();
-
     // Tests mainly pass a NULL logdir with MXB_LOG_TARGET_STDOUT but using
     // /dev/null as the default allows total suppression of logging
     std::string filepath = "/dev/null";
@@ -508,6 +488,17 @@ bool mxb_log_init(const char* ident,
         break;
     }
 
+    if (this_unit.sLogger && this_unit.async.enabled)
+    {
+        auto overflow = this_unit.async.overflow == MXB_LOG_OVERFLOW_BLOCK ?
+            mxb::AsyncLogger::BLOCK : mxb::AsyncLogger::DROP;
+
+        this_unit.sLogger = mxb::AsyncLogger::create(std::move(this_unit.sLogger),
+                                                     this_unit.async.buffer_size,
+                                                     overflow);
+        this_unit.pAsync_logger = static_cast<mxb::AsyncLogger*>(this_unit.sLogger.get());
+    }
+
     if (this_unit.sLogger && this_unit.sMessage_registry)
     {
         this_unit.context_provider = context_provider;
@@ -518,6 +509,7 @@ bool mxb_log_init(const char* ident,
     {
         this_unit.sLogger.reset();
         this_unit.sMessage_registry.reset();
+        this_unit.pAsync_logger = nullptr;
     }
 
     return this_unit.sLogger && this_unit.sMessage_registry;
@@ -528,6 +520,7 @@ void mxb_log_finish(void)
     assert(this_unit.sLogger && this_unit.sMessage_registry);
 
     closelog();
+    this_unit.pAsync_logger = nullptr;
     this_unit.sLogger.reset();
     this_unit.sMessage_registry.reset();
     this_unit.context_provider = nullptr;
@@ -609,6 +602,32 @@ void mxb_log_get_throttling(MXB_LOG_THROTTLING* throttling)
     *throttling = this_unit.throttling;
 }
 
+void mxb_log_set_async(const MXB_LOG_ASYNC* async)
+{
+    this_unit.async = *async;
+}
+
+void mxb_log_get_async(MXB_LOG_ASYNC* async)
+{
+    *async = this_unit.async;
+}
+
+void mxb_log_get_async_stats(MXB_LOG_ASYNC_STATS* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+
+    if (this_unit.pAsync_logger)
+    {
+        mxb::AsyncLogger::Stats s = this_unit.pAsync_logger->stats();
+
+        stats->written = s.written;
+        stats->dropped = s.dropped;
+        stats->blocked = s.blocked;
+        stats->batches = s.batches;
+        stats->buffers = s.buffers;
+    }
+}
+
 void mxs_log_redirect_stdout(bool redirect)
 {
     this_unit.redirect_stdout = redirect;
@@ -803,9 +822,15 @@ int mxb_log_message(int priority,
                            + augmentation_len + message_len + suppression_len == buffer_len);
                 }
 
-                char buffer[buffer_len + 1];
+                char timestamp[TIMESTAMP_MAXLEN];
+                int timestamp_len = this_unit.do_highprecision ?
+                    get_timestamp_hp(timestamp) : get_timestamp(timestamp);
+
+                // The message is formatted after the timestamp, so that the whole
+                // line can be written as is, without any further copying.
+                char buffer[timestamp_len + buffer_len + 2];    // For the final newline and the NULL.
 
-                char* prefix_text = buffer;
+                char* prefix_text = buffer + timestamp_len;
                 char* context_text = prefix_text + prefix.len;
                 char* modname_text = context_text + context_len;
                 char* augmentation_text = modname_text + modname_len;
@@ -861,20 +886,27 @@ int mxb_log_message(int priority,
                     syslog(priority, "%s", context_text);
                 }
 
-                std::string msg = this_unit.do_highprecision ? get_timestamp_hp() : get_timestamp();
-                msg += buffer;
+                memcpy(buffer, timestamp, timestamp_len);
+                int len = timestamp_len + strlen(prefix_text);
 
                 // Remove any user-generated newlines.
-                // This is safe to do as we know the message is not full of newlines
-                while (msg.back() == '\n')
+                // This is safe to do as the timestamp does not end with a newline.
+                while (buffer[len - 1] == '\n')
                 {
-                    msg.pop_back();
+                    --len;
                 }
 
                 // Add a final newline into the message
-                msg.push_back('\n');
+                buffer[len++] = '\n';
 
-                err = this_unit.sLogger->write(msg.c_str(), msg.length()) ? 0 : -1;
+                err = this_unit.sLogger->write(buffer, len) ? 0 : -1;
+
+                if (level <= LOG_CRIT)
+                {
+                    // The process may be about to go down, so we do not leave
+                    // anything pending.
+                    this_unit.sLogger->flush();
+                }
             }
         }
     }
@@ -17,8 +17,10 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <climits>
 #include <cstring>
 #include <cstdio>
 #include <ctime>
@@ -70,7 +72,8 @@ bool should_log_error()
 
 struct this_unit
 {
-    std::string ident;
+    std::string           ident;
+    std::atomic<uint64_t> next_async_logger_id;
 } this_unit;
 
 std::string get_ident()
@@ -101,6 +104,21 @@ void Logger::set_ident(const std::string& ident)
     this_unit.ident = ident;
 }
 
+bool Logger::writev(struct iovec* iov, int n)
+{
+    bool rval = true;
+
+    for (int i = 0; i < n; ++i)
+    {
+        if (!write(static_cast<const char*>(iov[i].iov_base), iov[i].iov_len))
+        {
+            rval = false;
+        }
+    }
+
+    return rval;
+}
+
 std::unique_ptr<Logger> FileLogger::create(const std::string& filename)
 {
     std::unique_ptr<FileLogger> logger;
@@ -168,6 +186,50 @@ bool FileLogger::write(const char* msg, int len)
     return rval;
 }
 
+bool FileLogger::writev(struct iovec* iov, int n)
+{
+    bool rval = true;
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    while (n > 0)
+    {
+        ssize_t rc;
+        do
+        {
+            rc = ::writev(m_fd, iov, n);
+        }
+        while (rc == -1 && errno == EINTR);
+
+        if (rc == -1)
+        {
+            if (should_log_error())     // Coarse error suppression
+            {
+                LOG_ERROR("Failed to write to log: %d, %s\n", errno, mxb_strerror(errno));
+            }
+
+            rval = false;
+            break;
+        }
+
+        // Skip what was written and, if only a part of an element was written,
+        // retry with the remainder of it.
+        while (n > 0 && (size_t)rc >= iov->iov_len)
+        {
+            rc -= iov->iov_len;
+            ++iov;
+            --n;
+        }
+
+        if (n > 0)
+        {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + rc;
+            iov->iov_len -= rc;
+        }
+    }
+
+    return rval;
+}
+
 bool FileLogger::rotate()
 {
     std::lock_guard<std::mutex> guard(m_lock);
@@ -273,4 +335,473 @@ bool FileLogger::write_footer(const char* suffix)
 
     return ok;
 }
+
+/**
+ * A single-producer single-consumer ring buffer of messages.
+ *
+ * The owning thread appends messages and the writer thread of the logger
+ * consumes them. A message is stored as its length followed by its bytes,
+ * and is never split at the end of the ring; if it does not fit into the
+ * remaining space a SKIP marker is stored and the message is placed at the
+ * beginning.
+ */
+class AsyncLogger::Buffer
+{
+public:
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+    Buffer(size_t size)
+        : m_orphaned(false)
+        , m_data(new char[size])
+        , m_size(size)
+        , m_head(0)
+        , m_tail(0)
+    {
+        assert((size & (size - 1)) == 0);
+    }
+
+    /**
+     * Append a message. Called only by the owning thread.
+     *
+     * @return True, if there was room for the message.
+     */
+    bool push(const char* msg, uint32_t len)
+    {
+        size_t need = record_size(len);
+        size_t head = m_head.load(std::memory_order_relaxed);
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        size_t offset = head & (m_size - 1);
+        size_t skip = (m_size - offset < need) ? m_size - offset : 0;
+        bool rv = (m_size - (head - tail) >= skip + need);
+
+        if (rv)
+        {
+            if (skip)
+            {
+                set_length(offset, SKIP);
+                head += skip;
+                offset = 0;
+            }
+
+            set_length(offset, len);
+            memcpy(m_data.get() + offset + sizeof(uint32_t), msg, len);
+
+            m_head.store(head + need, std::memory_order_release);
+        }
+
+        return rv;
+    }
+
+    /**
+     * Collect pending messages without consuming them. Called only by the writer.
+     *
+     * @param iov    Where the messages should be stored.
+     * @param n      Maximum number of messages to collect.
+     * @param pEnd   On return, the position to pass to @c consume().
+     *
+     * @return The number of collected messages.
+     */
+    int collect(struct iovec* iov, int n, size_t* pEnd) const
+    {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        size_t head = m_head.load(std::memory_order_acquire);
+        int i = 0;
+
+        while (pos != head && i < n)
+        {
+            size_t offset = pos & (m_size - 1);
+            uint32_t len = get_length(offset);
+
+            if (len == SKIP)
+            {
+                pos += m_size - offset;
+            }
+            else
+            {
+                iov[i].iov_base = m_data.get() + offset + sizeof(uint32_t);
+                iov[i].iov_len = len;
+                ++i;
+                pos += record_size(len);
+            }
+        }
+
+        *pEnd = pos;
+        return i;
+    }
+
+    /**
+     * Release the room of collected messages. Called only by the writer.
+     */
+    void consume(size_t end)
+    {
+        m_tail.store(end, std::memory_order_release);
+    }
+
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_relaxed);
+    }
+
+    // Set when the owning thread exits, after which no more messages are appended.
+    std::atomic<bool> m_orphaned;
+
+    // The largest message that can ever be stored.
+    static uint32_t max_length(size_t size)
+    {
+        return size / 2 - sizeof(uint32_t);
+    }
+
+private:
+    static const uint32_t SKIP = UINT32_MAX;
+
+    static size_t record_size(uint32_t len)
+    {
+        // Keep the lengths aligned.
+        return (sizeof(uint32_t) + len + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+    }
+
+    void set_length(size_t offset, uint32_t len)
+    {
+        memcpy(m_data.get() + offset, &len, sizeof(len));
+    }
+
+    uint32_t get_length(size_t offset) const
+    {
+        uint32_t len;
+        memcpy(&len, m_data.get() + offset, sizeof(len));
+        return len;
+    }
+
+    std::unique_ptr<char[]> m_data;
+    const size_t            m_size;
+    // The positions grow monotonically and are only masked when used. The head is
+    // modified only by the owning thread and the tail only by the writer.
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+};
+
+namespace
+{
+
+// How long an idle writer sleeps, in nanoseconds, unless woken up earlier.
+const long WRITER_SLEEP_NS = 1000000;
+
+/**
+ * The buffer of the current thread. When the thread exits, the buffer is
+ * marked as orphaned and the writer frees it once it has been drained.
+ */
+struct ThreadBuffer
+{
+    ~ThreadBuffer()
+    {
+        if (sBuffer)
+        {
+            sBuffer->m_orphaned.store(true, std::memory_order_release);
+        }
+    }
+
+    uint64_t                             logger_id = 0;
+    std::shared_ptr<AsyncLogger::Buffer> sBuffer;
+};
+
+thread_local ThreadBuffer this_thread_buffer;
+
+size_t round_up_to_power_of_2(size_t size)
+{
+    size_t rv = 64 * 1024;
+
+    while (rv < size)
+    {
+        rv <<= 1;
+    }
+
+    return rv;
+}
+}
+
+// static
+std::unique_ptr<Logger> AsyncLogger::create(std::unique_ptr<Logger> sLogger,
+                                            size_t buffer_size,
+                                            overflow_t overflow)
+{
+    std::unique_ptr<AsyncLogger> logger;
+
+    if (sLogger)
+    {
+        logger.reset(new(std::nothrow) AsyncLogger(std::move(sLogger), buffer_size, overflow));
+
+        if (logger)
+        {
+            try
+            {
+                logger->m_thread = std::thread(&AsyncLogger::run, logger.get());
+            }
+            catch (const std::exception& x)
+            {
+                LOG_ERROR("Could not start log writer thread: %s\n", x.what());
+                logger.reset();
+            }
+        }
+    }
+
+    return std::move(logger);
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    if (m_thread.joinable())
+    {
+        m_stop.store(true, std::memory_order_release);
+        m_sem.post();
+        m_thread.join();
+
+        // The writer may have exited without consuming all posts, and a
+        // semaphore must not be destroyed with a non-zero count.
+        while (m_sem.trywait())
+        {
+        }
+    }
+
+    // Anything logged after the writer exited.
+    flush();
+}
+
+bool AsyncLogger::write(const char* msg, int len)
+{
+    bool rval = false;
+    Buffer* pBuffer = get_buffer();
+
+    if (!pBuffer || (uint32_t)len > Buffer::max_length(m_buffer_size))
+    {
+        // Can't be buffered, so it's written directly, behind what already is pending.
+        flush();
+        rval = m_sLogger->write(msg, len);
+        m_written.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        rval = pBuffer->push(msg, len);
+
+        if (!rval && m_overflow == BLOCK)
+        {
+            m_blocked.fetch_add(1, std::memory_order_relaxed);
+
+            do
+            {
+                wake_writer();
+                wait_for_room();
+                rval = pBuffer->push(msg, len);
+            }
+            while (!rval);
+        }
+
+        if (rval)
+        {
+            wake_writer();
+        }
+        else
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    return rval;
+}
+
+bool AsyncLogger::rotate()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    drain();
+
+    return m_sLogger->rotate();
+}
+
+void AsyncLogger::flush()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    // A batch smaller than the maximum means that all that was pending got written.
+    while (drain() == IOV_MAX)
+    {
+    }
+}
+
+AsyncLogger::Stats AsyncLogger::stats() const
+{
+    Stats stats;
+
+    stats.written = m_written.load(std::memory_order_relaxed);
+    stats.dropped = m_dropped.load(std::memory_order_relaxed);
+    stats.blocked = m_blocked.load(std::memory_order_relaxed);
+    stats.batches = m_batches.load(std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    stats.buffers = m_buffers.size();
+
+    return stats;
+}
+
+AsyncLogger::AsyncLogger(std::unique_ptr<Logger> sLogger, size_t buffer_size, overflow_t overflow)
+    : Logger(sLogger->filename())
+    , m_sLogger(std::move(sLogger))
+    , m_buffer_size(round_up_to_power_of_2(buffer_size))
+    , m_overflow(overflow)
+    , m_id(++this_unit.next_async_logger_id)
+    , m_stop(false)
+    , m_sleeping(false)
+    , m_waiters(0)
+    , m_written(0)
+    , m_dropped(0)
+    , m_blocked(0)
+    , m_batches(0)
+{
+}
+
+AsyncLogger::Buffer* AsyncLogger::get_buffer()
+{
+    ThreadBuffer& tb = this_thread_buffer;
+
+    if (tb.logger_id != m_id)
+    {
+        if (tb.sBuffer)
+        {
+            tb.sBuffer->m_orphaned.store(true, std::memory_order_release);
+            tb.sBuffer.reset();
+        }
+
+        std::shared_ptr<Buffer> sBuffer;
+
+        try
+        {
+            sBuffer = std::make_shared<Buffer>(m_buffer_size);
+
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_buffers.push_back(sBuffer);
+        }
+        catch (const std::bad_alloc&)
+        {
+            sBuffer.reset();
+        }
+
+        if (sBuffer)
+        {
+            tb.logger_id = m_id;
+            tb.sBuffer = sBuffer;
+        }
+    }
+
+    return tb.sBuffer.get();
+}
+
+void AsyncLogger::wake_writer()
+{
+    // Pairs with the fence in run(); either the writer sees the message
+    // or we see that it is about to sleep.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (m_sleeping.load(std::memory_order_relaxed) && m_sleeping.exchange(false))
+    {
+        m_sem.post();
+    }
+}
+
+void AsyncLogger::wait_for_room()
+{
+    std::unique_lock<std::mutex> guard(m_room_lock);
+    ++m_waiters;
+    // A missed notification only costs a millisecond.
+    m_room_cond.wait_for(guard, std::chrono::milliseconds(1));
+    --m_waiters;
+}
+
+int AsyncLogger::drain()
+{
+    // Called with m_lock held.
+    int n = 0;
+
+    if (!m_buffers.empty())
+    {
+        struct iovec iov[IOV_MAX];
+        size_t ends[m_buffers.size()];
+
+        for (size_t i = 0; i < m_buffers.size(); ++i)
+        {
+            n += m_buffers[i]->collect(iov + n, IOV_MAX - n, &ends[i]);
+        }
+
+        if (n != 0)
+        {
+            m_sLogger->writev(iov, n);
+
+            m_written.fetch_add(n, std::memory_order_relaxed);
+            m_batches.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        auto it = m_buffers.begin();
+
+        for (size_t i = 0; it != m_buffers.end(); ++i)
+        {
+            Buffer& buffer = **it;
+            buffer.consume(ends[i]);
+
+            if (buffer.m_orphaned.load(std::memory_order_acquire) && buffer.empty())
+            {
+                it = m_buffers.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        if (n != 0 && m_waiters.load(std::memory_order_relaxed) != 0)
+        {
+            std::lock_guard<std::mutex> guard(m_room_lock);
+            m_room_cond.notify_all();
+        }
+    }
+
+    return n;
+}
+
+void AsyncLogger::run()
+{
+    while (true)
+    {
+        bool stop = m_stop.load(std::memory_order_acquire);
+        int n;
+
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            n = drain();
+        }
+
+        if (n == 0)
+        {
+            if (stop)
+            {
+                break;
+            }
+
+            m_sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            bool idle;
+            {
+                std::lock_guard<std::mutex> guard(m_lock);
+                idle = std::none_of(m_buffers.begin(), m_buffers.end(), [](const std::shared_ptr<Buffer>& s) {
+                                        return !s->empty();
+                                    });
+            }
+
+            if (idle && !m_stop.load(std::memory_order_acquire))
+            {
+                m_sem.timedwait(0, WRITER_SLEEP_NS);
+            }
+
+            m_sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+}
 }
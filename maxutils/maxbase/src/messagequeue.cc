@@ -13,10 +13,10 @@
 
 #include <maxbase/messagequeue.hh>
 #include <errno.h>
-#include <fcntl.h>
+#include <sched.h>
 #include <string.h>
 #include <unistd.h>
-#include <fstream>
+#include <sys/eventfd.h>
 #include <maxbase/assert.h>
 #include <maxbase/log.h>
 #include <maxbase/string.h>
@@ -28,50 +28,44 @@ namespace
 static struct
 {
     bool initialized;
-    int  pipe_max_size;
 } this_unit =
 {
     false
 };
-
-int get_pipe_max_size()
-{
-    int size = 65536;   // Default value from pipe(7)
-    std::ifstream file("/proc/sys/fs/pipe-max-size");
-
-    if (file.good())
-    {
-        file >> size;
-    }
-
-    return size;
-}
 }
 
 namespace maxbase
 {
 
-MessageQueue::MessageQueue(Handler* pHandler, int read_fd, int write_fd)
+MessageQueue::MessageQueue(Handler* pHandler, int event_fd, Cell* pCells)
     : mxb::PollData(&MessageQueue::poll_handler)
     , m_handler(*pHandler)
-    , m_read_fd(read_fd)
-    , m_write_fd(write_fd)
+    , m_event_fd(event_fd)
     , m_pWorker(NULL)
+    , m_pCells(pCells)
+    , m_head(0)
+    , m_tail(0)
+    , m_pending(false)
 {
     mxb_assert(pHandler);
-    mxb_assert(read_fd);
-    mxb_assert(write_fd);
+    mxb_assert(event_fd);
+    mxb_assert(pCells);
+
+    for (uint64_t i = 0; i < N_CELLS; ++i)
+    {
+        m_pCells[i].seq.store(i, std::memory_order_relaxed);
+    }
 }
 
 MessageQueue::~MessageQueue()
 {
     if (m_pWorker)
     {
-        m_pWorker->remove_fd(m_read_fd);
+        m_pWorker->remove_fd(m_event_fd);
     }
 
-    close(m_read_fd);
-    close(m_write_fd);
+    close(m_event_fd);
+    delete [] m_pCells;
 }
 
 // static
@@ -80,7 +74,6 @@ bool MessageQueue::init()
     mxb_assert(!this_unit.initialized);
 
     this_unit.initialized = true;
-    this_unit.pipe_max_size = get_pipe_max_size();
 
     return this_unit.initialized;
 }
@@ -97,73 +90,29 @@ MessageQueue* MessageQueue::create(Handler* pHandler)
 {
     mxb_assert(this_unit.initialized);
 
-    /* From "man 7 pipe"
-     * ----
-     *
-     * O_NONBLOCK enabled, n <= PIPE_BUF
-     *   If  there  is room to write n bytes to the pipe, then write(2)
-     *   succeeds immediately, writing all n bytes; otherwise write(2)
-     *   fails, with errno set to EAGAIN.
-     *
-     * ... (On Linux, PIPE_BUF is 4096 bytes.)
-     *
-     * ----
-     *
-     * As O_NONBLOCK is set and the messages are less than 4096 bytes,
-     * O_DIRECT should not be needed and we should be safe without it.
-     *
-     * However, to be in the safe side, we first try whether it is supported,
-     * and if not, we create the pipe without O_DIRECT.
-     */
-
     MessageQueue* pThis = NULL;
 
-    int fds[2];
+    int fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
 
-    int rv = pipe2(fds, O_NONBLOCK | O_CLOEXEC | O_DIRECT);
-
-    if ((rv != 0) && (errno == EINVAL))
+    if (fd != -1)
     {
-        // Ok, apparently the kernel does not support O_DIRECT. Let's try without.
-        rv = pipe2(fds, O_NONBLOCK | O_CLOEXEC);
+        Cell* pCells = new(std::nothrow) Cell[N_CELLS];
 
-        if (rv == 0)
+        if (pCells)
         {
-            // Succeeded, so apparently it was the missing support for O_DIRECT.
-            MXB_WARNING("Platform does not support O_DIRECT in conjunction with pipes, "
-                        "using without.");
+            pThis = new(std::nothrow) MessageQueue(pHandler, fd, pCells);
         }
-    }
-
-    if (rv == 0)
-    {
-        int read_fd = fds[0];
-        int write_fd = fds[1];
-#ifdef F_SETPIPE_SZ
-        /**
-         * Increase the pipe buffer size on systems that support it. Modifying
-         * the buffer size of one fd will also increase it for the other.
-         */
-        if (fcntl(fds[0], F_SETPIPE_SZ, this_unit.pipe_max_size) == -1)
-        {
-            MXB_WARNING("Failed to increase pipe buffer size to '%d': %d, %s",
-                        this_unit.pipe_max_size,
-                        errno,
-                        mxb_strerror(errno));
-        }
-#endif
-        pThis = new(std::nothrow) MessageQueue(pHandler, read_fd, write_fd);
 
         if (!pThis)
         {
             MXB_OOM();
-            close(read_fd);
-            close(write_fd);
+            delete [] pCells;
+            close(fd);
         }
     }
     else
     {
-        MXB_ERROR("Could not create pipe for worker: %s", mxb_strerror(errno));
+        MXB_ERROR("Could not create eventfd for worker: %s", mxb_strerror(errno));
     }
 
     return pThis;
@@ -178,57 +127,47 @@ bool MessageQueue::post(const Message& message) const
     if (m_pWorker)
     {
         /**
-         * This is a stopgap measure to solve MXS-1983 that causes Resource temporarily
-         * unavailable errors. The errors are caused by the pipe buffer being too small to
-         * hold all worker messages. By retrying a limited number of times before giving
-         * up, the success rate for posted messages under heavy load increases
-         * significantly.
+         * If the queue is full, retry a limited number of times before giving up,
+         * as the consumer is likely to be draining the queue. This is what the
+         * pipe implementation did as a stopgap for MXS-1983, where the pipe buffer
+         * was too small to hold all worker messages under heavy load.
          */
         int fast = 0;
         int slow = 0;
         const int fast_size = 100;
         const int slow_limit = 3;
-        ssize_t n;
 
-        while (true)
+        while (!(rv = push(message)))
         {
-            n = write(m_write_fd, &message, sizeof(message));
-            rv = (n == sizeof(message));
-
-            if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            if (++fast > fast_size)
             {
-                if (++fast > fast_size)
+                fast = 0;
+
+                if (++slow >= slow_limit)
                 {
-                    fast = 0;
-
-                    if (++slow >= slow_limit)
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        sched_yield();
-                    }
+                    break;
+                }
+                else
+                {
+                    sched_yield();
                 }
-            }
-            else
-            {
-                break;
             }
         }
 
-        if (n == -1)
+        if (rv)
         {
-            MXB_ERROR("Failed to write message: %d, %s", errno, mxb_strerror(errno));
-
-            static bool warn_pipe_buffer_size = true;
-
-            if ((errno == EAGAIN || errno == EWOULDBLOCK) && warn_pipe_buffer_size)
+            // The doorbell is rung only if the consumer has found the queue empty
+            // since it was last rung. Otherwise the consumer will see the message
+            // before it goes to sleep.
+            if (!m_pending.exchange(true, std::memory_order_acq_rel))
             {
-                MXB_ERROR("Consider increasing pipe buffer size (sysctl fs.pipe-max-size)");
-                warn_pipe_buffer_size = false;
+                ring();
             }
         }
+        else
+        {
+            MXB_ERROR("Failed to post message, the message queue is full.");
+        }
     }
     else
     {
@@ -242,11 +181,11 @@ bool MessageQueue::add_to_worker(Worker* pWorker)
 {
     if (m_pWorker)
     {
-        m_pWorker->remove_fd(m_read_fd);
+        m_pWorker->remove_fd(m_event_fd);
         m_pWorker = NULL;
     }
 
-    if (pWorker->add_fd(m_read_fd, EPOLLIN, this))
+    if (pWorker->add_fd(m_event_fd, EPOLLIN, this))
     {
         m_pWorker = pWorker;
     }
@@ -260,13 +199,89 @@ Worker* MessageQueue::remove_from_worker()
 
     if (m_pWorker)
     {
-        m_pWorker->remove_fd(m_read_fd);
+        m_pWorker->remove_fd(m_event_fd);
         m_pWorker = NULL;
     }
 
     return pWorker;
 }
 
+bool MessageQueue::push(const Message& message) const
+{
+    bool rv = false;
+    uint64_t pos = m_tail.load(std::memory_order_relaxed);
+    Cell* pCell;
+
+    while (true)
+    {
+        pCell = &m_pCells[pos & (N_CELLS - 1)];
+        int64_t diff = pCell->seq.load(std::memory_order_acquire) - pos;
+
+        if (diff == 0)
+        {
+            // The cell is free, claim it.
+            if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                rv = true;
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The cell still holds the message from the previous round, the queue is full.
+            break;
+        }
+        else
+        {
+            // Another producer claimed the cell.
+            pos = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    if (rv)
+    {
+        pCell->message = message;
+        pCell->seq.store(pos + 1, std::memory_order_release);
+    }
+
+    return rv;
+}
+
+bool MessageQueue::pop(Message* pMessage)
+{
+    bool rv = false;
+    Cell* pCell = &m_pCells[m_head & (N_CELLS - 1)];
+
+    if (pCell->seq.load(std::memory_order_acquire) == m_head + 1)
+    {
+        *pMessage = pCell->message;
+        pCell->seq.store(m_head + N_CELLS, std::memory_order_release);
+        ++m_head;
+        rv = true;
+    }
+
+    return rv;
+}
+
+bool MessageQueue::is_empty() const
+{
+    const Cell* pCell = &m_pCells[m_head & (N_CELLS - 1)];
+
+    return pCell->seq.load(std::memory_order_acquire) != m_head + 1;
+}
+
+void MessageQueue::ring() const
+{
+    uint64_t one = 1;
+
+    if (write(m_event_fd, &one, sizeof(one)) != sizeof(one))
+    {
+        // Can only fail if the counter would overflow, in which case the
+        // consumer will be woken up anyway.
+        mxb_assert(!true);
+    }
+}
+
 uint32_t MessageQueue::handle_poll_events(Worker* pWorker, uint32_t events)
 {
     uint32_t rc = MXB_POLL_NOP;
@@ -278,39 +293,44 @@ uint32_t MessageQueue::handle_poll_events(Worker* pWorker, uint32_t events)
 
     if (events & EPOLLIN)
     {
-        Message message;
-
-        ssize_t n;
+        uint64_t count;
 
-        do
+        if (read(m_event_fd, &count, sizeof(count)) == -1 && errno != EAGAIN)
         {
-            n = read(m_read_fd, &message, sizeof(message));
+            MXB_ERROR("Worker could not read from eventfd: %s", mxb_strerror(errno));
+        }
 
-            if (n == sizeof(message))
+        Message message;
+        int n = 0;
+
+        while (true)
+        {
+            while (n < MAX_BATCH && pop(&message))
             {
                 m_handler.handle_message(*this, message);
+                ++n;
             }
-            else if (n == -1)
+
+            if (n == MAX_BATCH)
             {
-                if (errno != EWOULDBLOCK)
-                {
-                    MXB_ERROR("Worker could not read from pipe: %s", mxb_strerror(errno));
-                }
+                // The doorbell is still considered rung, so no producer will ring it.
+                // Ring it ourselves so that the rest are handled after the worker has
+                // dealt with the other events.
+                ring();
+                break;
             }
-            else if (n != 0)
+
+            // About to sleep. A producer that posts after this will ring the doorbell
+            // and one that posted before is seen by the check below.
+            m_pending.exchange(false, std::memory_order_acq_rel);
+
+            if (is_empty() || m_pending.exchange(true, std::memory_order_acq_rel))
             {
-                // This really should not happen as the pipe is in message mode. We
-                // should either get a message, nothing at all or an error. In non-debug
-                // mode we continue reading in order to empty the pipe as otherwise the
-                // thread may hang.
-                MXB_ERROR("MessageQueue could only read %ld bytes from pipe, although "
-                          "expected %lu bytes.",
-                          n,
-                          sizeof(message));
-                mxb_assert(!true);
+                // Either there is nothing to handle or a producer already rang the
+                // doorbell, in which case the rest are handled on the next wakeup.
+                break;
             }
         }
-        while ((n != 0) && (n != -1));
 
         rc = MXB_POLL_READ;
     }
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include <maxbase/log.hh>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+
+const char LOGFILE[] = "test_asynclog.log";
+
+void log_messages(int thread, int n_messages)
+{
+    for (int i = 0; i < n_messages; ++i)
+    {
+        MXB_NOTICE("thread %d message %d", thread, i);
+    }
+}
+
+/**
+ * Check that the messages of each thread are in the log in the order they
+ * were logged, and count them.
+ *
+ * @return The number of messages, or -1 if the order was wrong.
+ */
+int check_log(int n_threads)
+{
+    ifstream in(LOGFILE);
+    vector<int> next(n_threads, 0);
+    int n = 0;
+    string line;
+
+    while (getline(in, line))
+    {
+        auto pos = line.find("thread ");
+        int thread;
+        int message;
+
+        if (pos != string::npos && sscanf(line.c_str() + pos, "thread %d message %d", &thread, &message) == 2)
+        {
+            if (thread < 0 || thread >= n_threads || message < next[thread])
+            {
+                cerr << "error: Unexpected message: " << line << endl;
+                n = -1;
+                break;
+            }
+
+            next[thread] = message + 1;
+            ++n;
+        }
+    }
+
+    return n;
+}
+
+int test(const MXB_LOG_ASYNC& async, int n_threads, int n_messages)
+{
+    int rv = 0;
+
+    unlink(LOGFILE);
+    mxb_log_set_async(&async);
+
+    MXB_LOG_ASYNC_STATS stats;
+    chrono::duration<double> secs;
+
+    {
+        mxb::Log log(nullptr, ".", LOGFILE, MXB_LOG_TARGET_FS, nullptr);
+        mxb_log_set_syslog_enabled(false);
+
+        auto start = chrono::steady_clock::now();
+        vector<thread> threads;
+
+        for (int i = 0; i < n_threads; ++i)
+        {
+            threads.emplace_back(log_messages, i, n_messages);
+        }
+
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+
+        secs = chrono::steady_clock::now() - start;
+        mxb_log_get_async_stats(&stats);
+    }
+
+    int total = n_threads * n_messages;
+    int n = check_log(n_threads);
+
+    cout << (async.enabled ? "Asynchronous" : "Synchronous") << " logging"
+         << (async.enabled ? (async.overflow == MXB_LOG_OVERFLOW_DROP ? " (drop)" : " (block)") : "")
+         << ", " << n_threads << " threads: "
+         << (int)(total / secs.count()) << " messages/s, "
+         << n << " logged, " << stats.dropped << " dropped, " << stats.blocked << " blocked, "
+         << stats.batches << " batches." << endl;
+
+    if (n == -1)
+    {
+        ++rv;
+    }
+    else if (async.enabled && async.overflow == MXB_LOG_OVERFLOW_DROP)
+    {
+        if (n + (int)stats.dropped != total)
+        {
+            cerr << "error: " << n << " messages logged and " << stats.dropped << " dropped, "
+                 << "expected them to add up to " << total << "." << endl;
+            ++rv;
+        }
+    }
+    else if (n != total || stats.dropped != 0)
+    {
+        cerr << "error: " << n << " messages logged, expected " << total << "." << endl;
+        ++rv;
+    }
+
+    unlink(LOGFILE);
+
+    return rv;
+}
+}
+
+int main()
+{
+    int rv = 0;
+
+    const int N_THREADS = 8;
+    const int N_MESSAGES = 20000;
+
+    MXB_LOG_ASYNC sync = {false, 0, MXB_LOG_OVERFLOW_DROP};
+    MXB_LOG_ASYNC block = {true, 64 * 1024, MXB_LOG_OVERFLOW_BLOCK};
+    MXB_LOG_ASYNC drop = {true, 64 * 1024, MXB_LOG_OVERFLOW_DROP};
+    MXB_LOG_ASYNC large = {true, 16 * 1024 * 1024, MXB_LOG_OVERFLOW_DROP};
+
+    rv += test(sync, N_THREADS, N_MESSAGES);
+    rv += test(block, N_THREADS, N_MESSAGES);
+    rv += test(drop, N_THREADS, N_MESSAGES);
+    rv += test(large, N_THREADS, N_MESSAGES);
+
+    return rv == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <maxbase/maxbase.hh>
+#include <maxbase/semaphore.hh>
+#include <maxbase/worker.hh>
+
+using namespace maxbase;
+using namespace std;
+
+namespace
+{
+
+const int MESSAGE_SIZE = 64;
+
+/**
+ * The worker side of a loopback connection, echoing back what it reads.
+ */
+class Echo : public MXB_POLL_DATA
+{
+public:
+    Echo(int fd)
+        : m_fd(fd)
+    {
+        MXB_POLL_DATA::handler = &Echo::handler;
+        MXB_POLL_DATA::owner = nullptr;
+    }
+
+    int fd() const
+    {
+        return m_fd;
+    }
+
+private:
+    static uint32_t handler(MXB_POLL_DATA* pData, MXB_WORKER* pWorker, uint32_t events)
+    {
+        return static_cast<Echo*>(pData)->handle(events);
+    }
+
+    uint32_t handle(uint32_t events)
+    {
+        uint32_t actions = MXB_POLL_NOP;
+
+        if (events & EPOLLIN)
+        {
+            char buffer[4096];
+            ssize_t n;
+
+            while ((n = read(m_fd, buffer, sizeof(buffer))) > 0)
+            {
+                // The client waits for the reply before sending more, so the
+                // socket buffer always has room for it.
+                if (write(m_fd, buffer, n) != n)
+                {
+                    cerr << "error: Could not echo " << n << " bytes: " << strerror(errno) << endl;
+                }
+            }
+
+            actions |= MXB_POLL_READ;
+        }
+
+        return actions;
+    }
+
+    int m_fd;
+};
+
+bool create_connection(int listener, int* pClient, int* pServer)
+{
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    getsockname(listener, (sockaddr*)&addr, &len);
+
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    bool rv = false;
+
+    if (connect(client, (sockaddr*)&addr, sizeof(addr)) == 0)
+    {
+        int server = accept(listener, nullptr, nullptr);
+
+        if (server != -1)
+        {
+            setsockopt(server, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            fcntl(server, F_SETFL, fcntl(server, F_GETFL) | O_NONBLOCK);
+            *pClient = client;
+            *pServer = server;
+            rv = true;
+        }
+    }
+
+    if (!rv)
+    {
+        cerr << "error: Could not create loopback connection: " << strerror(errno) << endl;
+        close(client);
+    }
+
+    return rv;
+}
+
+bool read_fully(int fd, char* pBuffer, int size)
+{
+    int n = 0;
+
+    while (n < size)
+    {
+        ssize_t rv = read(fd, pBuffer + n, size - n);
+
+        if (rv <= 0)
+        {
+            return false;
+        }
+
+        n += rv;
+    }
+
+    return true;
+}
+
+/**
+ * Send messages over loopback connections served by a worker and measure how
+ * many round-trips per second the worker manages.
+ *
+ * @param backend       The I/O backend of the worker.
+ * @param n_conns       The number of connections.
+ * @param n_roundtrips  The number of round-trips per connection.
+ *
+ * @return 0 on success, 1 on failure.
+ */
+int test(Worker::io_backend_t backend, int n_conns, int n_roundtrips)
+{
+    Worker::set_io_backend(backend);
+
+    Worker worker;
+
+    if (worker.io_backend() != backend)
+    {
+        cout << Worker::io_backend_to_string(backend) << " is not available, skipping." << endl;
+        return 0;
+    }
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, n_conns) != 0)
+    {
+        cerr << "error: Could not listen on loopback: " << strerror(errno) << endl;
+        close(listener);
+        return 1;
+    }
+
+    int rv = 0;
+    vector<int> clients;
+    vector<Echo*> echoes;
+
+    for (int i = 0; i < n_conns && rv == 0; ++i)
+    {
+        int client;
+        int server;
+
+        if (create_connection(listener, &client, &server))
+        {
+            clients.push_back(client);
+            echoes.push_back(new Echo(server));
+
+            if (!worker.add_fd(server, EPOLLIN | EPOLLOUT | EPOLLRDHUP, echoes.back()))
+            {
+                cerr << "error: Could not add descriptor to worker." << endl;
+                rv = 1;
+            }
+        }
+        else
+        {
+            rv = 1;
+        }
+    }
+
+    close(listener);
+
+    if (rv == 0 && worker.start())
+    {
+        char message[MESSAGE_SIZE];
+        char reply[MESSAGE_SIZE];
+        auto start = chrono::steady_clock::now();
+
+        for (int i = 0; i < n_roundtrips && rv == 0; ++i)
+        {
+            for (int client : clients)
+            {
+                memset(message, 'a' + (client + i) % 26, sizeof(message));
+
+                if (write(client, message, sizeof(message)) != sizeof(message))
+                {
+                    rv = 1;
+                }
+            }
+
+            if (i % 100 == 99)
+            {
+                // Every now and then, re-register the descriptors while replies may be
+                // in flight, as throttling does, to check that no events are lost.
+                mxb::Semaphore sem;
+                worker.execute([&]() {
+                                   for (Echo* pEcho : echoes)
+                                   {
+                                       worker.remove_fd(pEcho->fd());
+                                       worker.add_fd(pEcho->fd(), EPOLLIN | EPOLLOUT | EPOLLRDHUP, pEcho);
+                                   }
+                               }, &sem, Worker::EXECUTE_AUTO);
+                sem.wait();
+            }
+
+            for (int client : clients)
+            {
+                memset(message, 'a' + (client + i) % 26, sizeof(message));
+
+                if (!read_fully(client, reply, sizeof(reply)) || memcmp(message, reply, sizeof(reply)) != 0)
+                {
+                    cerr << "error: Wrong reply in round-trip " << i << "." << endl;
+                    rv = 1;
+                }
+            }
+        }
+
+        chrono::duration<double> secs = chrono::steady_clock::now() - start;
+
+        worker.shutdown();
+        worker.join();
+
+        cout << Worker::io_backend_to_string(backend) << ", " << n_conns << " connections: "
+             << (int)(n_conns * n_roundtrips / secs.count()) << " round-trips/s." << endl;
+    }
+
+    for (Echo* pEcho : echoes)
+    {
+        worker.remove_fd(pEcho->fd());
+        close(pEcho->fd());
+        delete pEcho;
+    }
+
+    for (int client : clients)
+    {
+        close(client);
+    }
+
+    return rv;
+}
+}
+
+int main()
+{
+    int rv = 0;
+
+    mxb::MaxBase mxb(MXB_LOG_TARGET_STDOUT);
+
+    rv += test(Worker::IO_BACKEND_EPOLL, 1, 20000);
+    rv += test(Worker::IO_BACKEND_IO_URING, 1, 20000);
+    rv += test(Worker::IO_BACKEND_EPOLL, 32, 2000);
+    rv += test(Worker::IO_BACKEND_IO_URING, 32, 2000);
+
+    return rv == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <maxbase/maxbase.hh>
+#include <maxbase/messagequeue.hh>
+#include <maxbase/semaphore.hh>
+#include <maxbase/worker.hh>
+
+using namespace maxbase;
+using namespace std;
+
+namespace
+{
+
+const int MAX_PRODUCERS = 8;
+const int WINDOW = 2048;    // The maximum number of messages in flight per producer.
+
+/**
+ * Receives the messages of all producers and checks that the messages of each
+ * producer arrive once and in order.
+ */
+class Consumer : public MessageQueueHandler
+{
+public:
+    Consumer(int n_producers, int n_messages)
+        : m_n_producers(n_producers)
+        , m_n_messages(n_messages)
+        , m_n_done(0)
+        , m_rv(0)
+    {
+        for (auto& n : m_received)
+        {
+            n.store(0);
+        }
+    }
+
+    void handle_message(MessageQueue& queue, const MessageQueueMessage& message) override
+    {
+        handle(message);
+    }
+
+    void handle(const MessageQueueMessage& message)
+    {
+        int producer = message.arg1();
+        int64_t n = m_received[producer].load(std::memory_order_relaxed);
+
+        if (message.arg2() != n)
+        {
+            cerr << "error: Expected message " << n << " from producer " << producer
+                 << ", got " << message.arg2() << "." << endl;
+            m_rv = 1;
+        }
+
+        m_received[producer].store(n + 1, std::memory_order_release);
+
+        if (n + 1 == m_n_messages && ++m_n_done == m_n_producers)
+        {
+            m_done.post();
+        }
+    }
+
+    int64_t received(int producer) const
+    {
+        return m_received[producer].load(std::memory_order_acquire);
+    }
+
+    bool wait()
+    {
+        return m_done.timedwait(30);
+    }
+
+    int rv() const
+    {
+        return m_rv;
+    }
+
+private:
+    int                  m_n_producers;
+    int64_t              m_n_messages;
+    int                  m_n_done;
+    int                  m_rv;
+    std::atomic<int64_t> m_received[MAX_PRODUCERS];
+    Semaphore            m_done;
+};
+
+/**
+ * The queues being compared.
+ */
+class Queue
+{
+public:
+    virtual ~Queue()
+    {
+    }
+
+    virtual const char* name() const = 0;
+    virtual bool        post(const MessageQueueMessage& message) = 0;
+};
+
+/**
+ * The message queue of maxbase.
+ */
+class MpscQueue : public Queue
+{
+public:
+    MpscQueue(Consumer* pConsumer, Worker* pWorker)
+        : m_pQueue(MessageQueue::create(pConsumer))
+    {
+        m_pQueue->add_to_worker(pWorker);
+    }
+
+    ~MpscQueue()
+    {
+        delete m_pQueue;
+    }
+
+    const char* name() const override
+    {
+        return "mpsc queue";
+    }
+
+    bool post(const MessageQueueMessage& message) override
+    {
+        return m_pQueue->post(message);
+    }
+
+private:
+    MessageQueue* m_pQueue;
+};
+
+/**
+ * A message queue over a pipe in packet mode, which is what the message
+ * queue used to be.
+ */
+class PipeQueue : public Queue
+                , public MXB_POLL_DATA
+{
+public:
+    PipeQueue(Consumer* pConsumer, Worker* pWorker)
+        : m_consumer(*pConsumer)
+        , m_pWorker(pWorker)
+    {
+        MXB_POLL_DATA::handler = &PipeQueue::handler;
+        MXB_POLL_DATA::owner = nullptr;
+
+        int fds[2];
+        pipe2(fds, O_NONBLOCK | O_CLOEXEC | O_DIRECT);
+        m_read_fd = fds[0];
+        m_write_fd = fds[1];
+
+        int size = 65536;
+        ifstream file("/proc/sys/fs/pipe-max-size");
+
+        if (file.good())
+        {
+            file >> size;
+        }
+
+        fcntl(m_read_fd, F_SETPIPE_SZ, size);
+        m_pWorker->add_fd(m_read_fd, EPOLLIN, this);
+    }
+
+    ~PipeQueue()
+    {
+        m_pWorker->remove_fd(m_read_fd);
+        close(m_read_fd);
+        close(m_write_fd);
+    }
+
+    const char* name() const override
+    {
+        return "pipe";
+    }
+
+    bool post(const MessageQueueMessage& message) override
+    {
+        return write(m_write_fd, &message, sizeof(message)) == sizeof(message);
+    }
+
+private:
+    static uint32_t handler(MXB_POLL_DATA* pData, MXB_WORKER* pWorker, uint32_t events)
+    {
+        PipeQueue* pThis = static_cast<PipeQueue*>(pData);
+        MessageQueueMessage message;
+
+        while (read(pThis->m_read_fd, &message, sizeof(message)) == sizeof(message))
+        {
+            pThis->m_consumer.handle(message);
+        }
+
+        return MXB_POLL_READ;
+    }
+
+    Consumer& m_consumer;
+    Worker*   m_pWorker;
+    int       m_read_fd;
+    int       m_write_fd;
+};
+
+/**
+ * Post messages from producer workers to a consumer worker.
+ *
+ * @param mpsc         Whether the message queue or a pipe is used.
+ * @param n_producers  The number of producer workers.
+ * @param n_messages   The number of messages per producer.
+ * @param burst        If non-zero, the producers pause after every @c burst
+ *                     messages so that the consumer goes to sleep.
+ *
+ * @return 0 on success, 1 on failure.
+ */
+int test(bool mpsc, int n_producers, int n_messages, int burst)
+{
+    mxb_assert(n_producers <= MAX_PRODUCERS);
+
+    Worker consumer_worker;
+    Consumer consumer(n_producers, n_messages);
+    unique_ptr<Queue> sQueue;
+
+    if (mpsc)
+    {
+        sQueue.reset(new MpscQueue(&consumer, &consumer_worker));
+    }
+    else
+    {
+        sQueue.reset(new PipeQueue(&consumer, &consumer_worker));
+    }
+
+    vector<unique_ptr<Worker>> producers;
+
+    for (int i = 0; i < n_producers; ++i)
+    {
+        producers.emplace_back(new Worker);
+    }
+
+    consumer_worker.start();
+
+    for (auto& sProducer : producers)
+    {
+        sProducer->start();
+    }
+
+    auto start = chrono::steady_clock::now();
+
+    for (int i = 0; i < n_producers; ++i)
+    {
+        Queue* pQueue = sQueue.get();
+
+        producers[i]->execute([pQueue, &consumer, i, n_messages, burst]() {
+                                  for (int j = 0; j < n_messages; ++j)
+                                  {
+                                      if (burst && j % burst == 0)
+                                      {
+                                          usleep(100);
+                                      }
+
+                                      while (j - consumer.received(i) >= WINDOW)
+                                      {
+                                          sched_yield();
+                                      }
+
+                                      while (!pQueue->post(MessageQueueMessage(0, i, j)))
+                                      {
+                                          sched_yield();
+                                      }
+                                  }
+                              }, Worker::EXECUTE_QUEUED);
+    }
+
+    int rv = 0;
+
+    if (!consumer.wait())
+    {
+        cerr << "error: Not all messages were received." << endl;
+        rv = 1;
+    }
+
+    chrono::duration<double> secs = chrono::steady_clock::now() - start;
+
+    for (auto& sProducer : producers)
+    {
+        sProducer->shutdown();
+        sProducer->join();
+    }
+
+    consumer_worker.shutdown();
+    consumer_worker.join();
+
+    rv |= consumer.rv();
+
+    if (!burst)
+    {
+        cout << sQueue->name() << ", " << n_producers << " producers: "
+             << (int)(n_producers * n_messages / secs.count()) << " messages/s." << endl;
+    }
+
+    return rv;
+}
+}
+
+int main()
+{
+    int rv = 0;
+
+    mxb::MaxBase mxb(MXB_LOG_TARGET_STDOUT);
+
+    // The consumer repeatedly goes to sleep, so that a missed wakeup would hang.
+    rv += test(true, 1, 20000, 7);
+    rv += test(true, 4, 5000, 13);
+
+    for (int n_producers : {1, 2, 4, 8})
+    {
+        rv += test(false, n_producers, 200000, 0);
+        rv += test(true, n_producers, 200000, 0);
+    }
+
+    return rv == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
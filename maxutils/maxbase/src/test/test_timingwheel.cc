@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include <maxbase/timingwheel.hh>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace maxbase;
+using namespace std;
+
+namespace
+{
+
+struct Timer : MXB_TIMER
+{
+    Timer()
+        : MXB_TIMER()
+        , at(0)
+        , expired(false)
+    {
+    }
+
+    int64_t at;         // When the timer should expire.
+    bool    expired;    // Whether the timer has expired.
+};
+
+/**
+ * Check that each timer is returned by the first expire() whose time is at or
+ * past the expiry of the timer, while timers are randomly added and removed
+ * and the time advances in steps of varying sizes.
+ */
+int test_expiry(int n_rounds)
+{
+    int rv = 0;
+    mt19937_64 random(4711);
+    vector<Timer> timers(1000);
+    int64_t now = 1000000;
+    TimingWheel wheel(now);
+
+    // The delays and steps are picked from ranges that hit all levels, the
+    // timers beyond the range of the wheel and the timers already due.
+    const int64_t ranges[] = {1, 256, 16384, 1 << 20, 1 << 26, (int64_t)1 << 34};
+
+    for (int round = 0; round < n_rounds && rv == 0; ++round)
+    {
+        for (Timer& timer : timers)
+        {
+            if (random() % 4 == 0)
+            {
+                if (TimingWheel::is_scheduled(&timer))
+                {
+                    wheel.remove(&timer);
+                }
+                else
+                {
+                    int64_t range = ranges[random() % (sizeof(ranges) / sizeof(ranges[0]))];
+                    timer.at = now + (int64_t)(random() % (2 * range)) - range / 4;
+                    timer.expired = false;
+                    wheel.add(&timer, timer.at);
+                }
+            }
+        }
+
+        int64_t earliest = INT64_MAX;
+
+        for (Timer& timer : timers)
+        {
+            if (TimingWheel::is_scheduled(&timer) && timer.at < earliest)
+            {
+                earliest = timer.at;
+            }
+        }
+
+        // A timer that is already due expires with the next tick.
+        if (wheel.next_expiry() > max(earliest, now + 1))
+        {
+            cerr << "error: The next expiry " << wheel.next_expiry() << " is later than the earliest "
+                 << "timer " << earliest << "." << endl;
+            rv = 1;
+        }
+
+        int64_t step = ranges[random() % 5];
+        now += 1 + random() % step;
+
+        while (MXB_TIMER* pExpired = wheel.expire(now))
+        {
+            Timer* pTimer = static_cast<Timer*>(pExpired);
+
+            if (pTimer->at > now || pTimer->expired)
+            {
+                cerr << "error: Timer due at " << pTimer->at << " expired at " << now << "." << endl;
+                rv = 1;
+            }
+
+            pTimer->expired = true;
+        }
+
+        size_t n = 0;
+
+        for (Timer& timer : timers)
+        {
+            if (TimingWheel::is_scheduled(&timer))
+            {
+                ++n;
+
+                if (timer.at <= now)
+                {
+                    cerr << "error: Timer due at " << timer.at << " has not expired at " << now << "." << endl;
+                    rv = 1;
+                }
+            }
+        }
+
+        if (n != wheel.size())
+        {
+            cerr << "error: The wheel has " << wheel.size() << " timers, expected " << n << "." << endl;
+            rv = 1;
+        }
+    }
+
+    return rv;
+}
+
+/**
+ * Measure how fast timers are added, half of them are cancelled and the rest
+ * expire, with the timing wheel and with a multimap ordered by time, which is
+ * what the delayed calls of a worker used to be kept in.
+ */
+void benchmark(int n_timers, int max_delay)
+{
+    mt19937_64 random(4711);
+    vector<Timer> timers(n_timers);
+    vector<int64_t> delays(n_timers);
+
+    for (auto& delay : delays)
+    {
+        delay = 1 + random() % max_delay;
+    }
+
+    auto start = chrono::steady_clock::now();
+
+    {
+        TimingWheel wheel(0);
+
+        for (int i = 0; i < n_timers; ++i)
+        {
+            wheel.add(&timers[i], delays[i]);
+        }
+
+        for (int i = 0; i < n_timers; i += 2)
+        {
+            wheel.remove(&timers[i]);
+        }
+
+        for (int64_t now = 0; wheel.size() > 0; now += 10)
+        {
+            while (wheel.expire(now))
+            {
+            }
+        }
+    }
+
+    chrono::duration<double> wheel_secs = chrono::steady_clock::now() - start;
+
+    start = chrono::steady_clock::now();
+
+    {
+        multimap<int64_t, Timer*> sorted;
+        vector<multimap<int64_t, Timer*>::iterator> positions(n_timers);
+
+        for (int i = 0; i < n_timers; ++i)
+        {
+            positions[i] = sorted.insert(make_pair(delays[i], &timers[i]));
+        }
+
+        for (int i = 0; i < n_timers; i += 2)
+        {
+            sorted.erase(positions[i]);
+        }
+
+        for (int64_t now = 0; !sorted.empty(); now += 10)
+        {
+            while (!sorted.empty() && sorted.begin()->first <= now)
+            {
+                sorted.erase(sorted.begin());
+            }
+        }
+    }
+
+    chrono::duration<double> map_secs = chrono::steady_clock::now() - start;
+
+    cout << n_timers << " timers, delays up to " << max_delay << " ticks: "
+         << (int)(n_timers / wheel_secs.count()) << " timers/s with the timing wheel, "
+         << (int)(n_timers / map_secs.count()) << " timers/s with a multimap." << endl;
+}
+}
+
+int main()
+{
+    int rv = 0;
+
+    rv += test_expiry(20000);
+
+    benchmark(50000, 1000);
+    benchmark(50000, 3600000);
+    benchmark(500000, 3600000);
+
+    return rv == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include <maxbase/timingwheel.hh>
+#include <maxbase/assert.h>
+
+namespace maxbase
+{
+
+TimingWheel::TimingWheel(int64_t now)
+    : m_tick(now)
+    , m_size(0)
+{
+    for (int i = 0; i <= N_SLOTS; ++i)
+    {
+        m_slots[i].prev = &m_slots[i];
+        m_slots[i].next = &m_slots[i];
+        m_slots[i].at = 0;
+        m_slots[i].slot = i;
+    }
+
+    for (auto& occupied : m_occupied)
+    {
+        occupied = 0;
+    }
+}
+
+void TimingWheel::add(MXB_TIMER* pTimer, int64_t at)
+{
+    mxb_assert(!is_scheduled(pTimer));
+
+    pTimer->at = at;
+    insert(pTimer);
+    ++m_size;
+}
+
+void TimingWheel::remove(MXB_TIMER* pTimer)
+{
+    if (is_scheduled(pTimer))
+    {
+        mxb_assert(pTimer->slot >= 0 && pTimer->slot <= N_SLOTS);
+
+        unlink(pTimer);
+        --m_size;
+    }
+}
+
+MXB_TIMER* TimingWheel::expire(int64_t now)
+{
+    while (is_empty(READY) && m_tick <= now)
+    {
+        int64_t tick = next_tick();
+
+        if (tick > now)
+        {
+            // Nothing expires or needs to be cascaded before now, so the ticks
+            // in between can be skipped.
+            set_tick(now + 1);
+        }
+        else if (tick == m_tick)
+        {
+            MXB_TIMER* pHead = &m_slots[m_tick & (LEVEL0_SIZE - 1)];
+
+            while (pHead->next != pHead)
+            {
+                MXB_TIMER* pTimer = pHead->next;
+                unlink(pTimer);
+                link(pTimer, READY);
+            }
+
+            set_tick(m_tick + 1);
+        }
+        else
+        {
+            set_tick(tick);
+        }
+    }
+
+    MXB_TIMER* pTimer = nullptr;
+
+    if (!is_empty(READY))
+    {
+        pTimer = m_slots[READY].next;
+        unlink(pTimer);
+        --m_size;
+    }
+
+    return pTimer;
+}
+
+int64_t TimingWheel::next_expiry() const
+{
+    return is_empty(READY) ? next_tick() : m_slots[READY].next->at;
+}
+
+void TimingWheel::insert(MXB_TIMER* pTimer)
+{
+    int64_t at = pTimer->at;
+    int64_t delta = at - m_tick;
+    int slot;
+
+    if (delta < LEVEL0_SIZE)
+    {
+        // A timer that is already due goes to the slot of the next tick.
+        slot = (delta < 0 ? m_tick : at) & (LEVEL0_SIZE - 1);
+    }
+    else
+    {
+        if (delta > MAX_DELTA)
+        {
+            // Placed at the end of the range, from where it is cascaded back
+            // to the highest level until it is within range.
+            delta = MAX_DELTA;
+            at = m_tick + delta;
+        }
+
+        int level = 1;
+
+        while (delta >> shift(level + 1) != 0)
+        {
+            ++level;
+        }
+
+        slot = first_slot(level) + ((at >> shift(level)) & (LEVEL_SIZE - 1));
+    }
+
+    link(pTimer, slot);
+}
+
+void TimingWheel::link(MXB_TIMER* pTimer, int slot)
+{
+    MXB_TIMER* pHead = &m_slots[slot];
+
+    pTimer->prev = pHead->prev;
+    pTimer->next = pHead;
+    pTimer->slot = slot;
+    pHead->prev->next = pTimer;
+    pHead->prev = pTimer;
+
+    m_occupied[slot / 64] |= (uint64_t)1 << (slot % 64);
+}
+
+void TimingWheel::unlink(MXB_TIMER* pTimer)
+{
+    int slot = pTimer->slot;
+
+    pTimer->prev->next = pTimer->next;
+    pTimer->next->prev = pTimer->prev;
+    pTimer->prev = nullptr;
+    pTimer->next = nullptr;
+
+    if (is_empty(slot))
+    {
+        m_occupied[slot / 64] &= ~((uint64_t)1 << (slot % 64));
+    }
+}
+
+void TimingWheel::cascade(int slot)
+{
+    MXB_TIMER* pHead = &m_slots[slot];
+
+    while (pHead->next != pHead)
+    {
+        MXB_TIMER* pTimer = pHead->next;
+        unlink(pTimer);
+        insert(pTimer);
+    }
+}
+
+void TimingWheel::set_tick(int64_t tick)
+{
+    mxb_assert(tick > m_tick);
+
+    m_tick = tick;
+
+    if ((tick & (LEVEL0_SIZE - 1)) == 0)
+    {
+        // The timers of the slot of the next level that covers the 256 ticks now
+        // starting are moved down. If that slot is the first one of its level,
+        // a new range of that level starts as well and so on.
+        for (int level = 1; level < N_LEVELS; ++level)
+        {
+            int index = (tick >> shift(level)) & (LEVEL_SIZE - 1);
+
+            cascade(first_slot(level) + index);
+
+            if (index != 0)
+            {
+                break;
+            }
+        }
+    }
+}
+
+int TimingWheel::first_occupied(int from, int to) const
+{
+    int slot = -1;
+
+    while (from < to)
+    {
+        uint64_t bits = m_occupied[from / 64] >> (from % 64);
+
+        if (bits)
+        {
+            int i = from + __builtin_ctzll(bits);
+            slot = i < to ? i : -1;
+            break;
+        }
+
+        from = (from / 64 + 1) * 64;
+    }
+
+    return slot;
+}
+
+int64_t TimingWheel::next_tick() const
+{
+    int64_t next = INT64_MAX;
+    int index = m_tick & (LEVEL0_SIZE - 1);
+    int slot = first_occupied(index, LEVEL0_SIZE);
+
+    if (slot != -1)
+    {
+        next = m_tick - index + slot;
+    }
+    else
+    {
+        if (first_occupied(0, index) != -1)
+        {
+            // Timers due after the first level has wrapped around.
+            next = m_tick - index + LEVEL0_SIZE;
+        }
+
+        for (int level = 1; level < N_LEVELS; ++level)
+        {
+            uint64_t bits = m_occupied[first_slot(level) / 64];
+
+            if (bits)
+            {
+                // The slots are cascaded in order, starting from the one after
+                // the current one, and the current one is cascaded last.
+                int64_t block = m_tick >> shift(level);
+                int start = (block + 1) & (LEVEL_SIZE - 1);
+
+                if (start != 0)
+                {
+                    bits = (bits >> start) | (bits << (LEVEL_SIZE - start));
+                }
+
+                int64_t tick = (block + 1 + __builtin_ctzll(bits)) << shift(level);
+
+                if (tick < next)
+                {
+                    next = tick;
+                }
+            }
+        }
+    }
+
+    return next;
+}
+}
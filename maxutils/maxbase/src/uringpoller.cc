@@ -0,0 +1,568 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include <maxbase/uringpoller.hh>
+
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <new>
+
+#include <maxbase/assert.h>
+#include <maxbase/log.h>
+#include <maxbase/string.h>
+
+#if defined (HAVE_IO_URING)
+#include <endian.h>
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace
+{
+
+// The user data of the completions that are of no interest, i.e. those of the
+// requests that remove a poll request.
+const uint64_t IGNORED = 0;
+
+// The user data of the poll request watching the epoll instance of the worker.
+const uint64_t EPOLL_INSTANCE = UINT64_MAX;
+
+// The user data of a descriptor's poll request contains both the descriptor and
+// the generation of its registration, so that completions of a request that was
+// removed can be told apart from those of a later registration of the same fd.
+inline uint64_t to_user_data(int fd, uint32_t generation)
+{
+    return ((uint64_t)generation << 32) | (uint32_t)fd;
+}
+}
+
+namespace maxbase
+{
+
+#if defined (HAVE_IO_URING)
+
+struct UringPoller::Ring
+{
+    int            fd;
+    void*          pSq_map;
+    size_t         sq_map_size;
+    void*          pCq_map;
+    size_t         cq_map_size;
+    io_uring_sqe*  pSqes;
+    size_t         sqes_size;
+    uint32_t       sq_entries;
+    uint32_t       sq_mask;
+    uint32_t*      pSq_head;
+    uint32_t*      pSq_tail;
+    uint32_t*      pSq_array;
+    uint32_t       sq_tail;     // The local tail, published when a request is committed.
+    uint32_t       cq_mask;
+    uint32_t*      pCq_head;
+    uint32_t*      pCq_tail;
+    io_uring_cqe*  pCqes;
+
+    int enter(uint32_t to_submit, uint32_t min_complete, uint32_t flags, const void* pArg, size_t arg_size)
+    {
+        return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, pArg, arg_size);
+    }
+
+    uint32_t pending() const
+    {
+        return sq_tail - __atomic_load_n(pSq_head, __ATOMIC_ACQUIRE);
+    }
+
+    bool has_completions() const
+    {
+        return *pCq_head != __atomic_load_n(pCq_tail, __ATOMIC_ACQUIRE);
+    }
+
+    /**
+     * Get a submission queue entry. If the queue is full, the queued requests
+     * are submitted first.
+     */
+    io_uring_sqe* get_sqe()
+    {
+        if (pending() == sq_entries)
+        {
+            enter(sq_entries, 0, 0, NULL, 0);
+        }
+
+        io_uring_sqe* pSqe = NULL;
+
+        if (pending() < sq_entries)
+        {
+            pSqe = &pSqes[sq_tail & sq_mask];
+            memset(pSqe, 0, sizeof(*pSqe));
+        }
+
+        return pSqe;
+    }
+
+    void commit()
+    {
+        pSq_array[sq_tail & sq_mask] = sq_tail & sq_mask;
+        ++sq_tail;
+        __atomic_store_n(pSq_tail, sq_tail, __ATOMIC_RELEASE);
+    }
+
+    bool prep_poll_add(int poll_fd, uint32_t events, uint64_t user_data, bool multishot)
+    {
+        io_uring_sqe* pSqe = get_sqe();
+
+        if (pSqe)
+        {
+            pSqe->opcode = IORING_OP_POLL_ADD;
+            pSqe->fd = poll_fd;
+#if __BYTE_ORDER == __BIG_ENDIAN
+            events = (events << 16) | (events >> 16);
+#endif
+            pSqe->poll32_events = events;
+            pSqe->len = multishot ? IORING_POLL_ADD_MULTI : 0;
+            pSqe->user_data = user_data;
+            commit();
+        }
+
+        return pSqe != NULL;
+    }
+
+    bool prep_poll_remove(uint64_t target)
+    {
+        io_uring_sqe* pSqe = get_sqe();
+
+        if (pSqe)
+        {
+            pSqe->opcode = IORING_OP_POLL_REMOVE;
+            pSqe->fd = -1;
+            pSqe->addr = target;
+            pSqe->user_data = IGNORED;
+            commit();
+        }
+
+        return pSqe != NULL;
+    }
+
+    static void unmap(Ring* pRing)
+    {
+        if (pRing->pSqes)
+        {
+            munmap(pRing->pSqes, pRing->sqes_size);
+        }
+
+        if (pRing->pCq_map && pRing->pCq_map != pRing->pSq_map)
+        {
+            munmap(pRing->pCq_map, pRing->cq_map_size);
+        }
+
+        if (pRing->pSq_map)
+        {
+            munmap(pRing->pSq_map, pRing->sq_map_size);
+        }
+
+        close(pRing->fd);
+        delete pRing;
+    }
+
+    static Ring* map(uint32_t entries)
+    {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        params.flags = IORING_SETUP_CLAMP | IORING_SETUP_CQSIZE;
+        params.cq_entries = 4 * entries;
+
+        int fd = syscall(__NR_io_uring_setup, entries, &params);
+
+        if (fd == -1)
+        {
+            MXB_WARNING("Could not create io_uring: %s", mxb_strerror(errno));
+            return NULL;
+        }
+
+        // EXT_ARG is needed for waiting with a timeout in the same call that submits
+        // the requests and NODROP for not losing completions if the queue overflows.
+        const uint32_t needed = IORING_FEAT_EXT_ARG | IORING_FEAT_NODROP;
+
+        if ((params.features & needed) != needed)
+        {
+            MXB_WARNING("The kernel does not support the io_uring features needed by the workers.");
+            close(fd);
+            return NULL;
+        }
+
+        Ring* pRing = new(std::nothrow) Ring();
+
+        if (!pRing)
+        {
+            close(fd);
+            return NULL;
+        }
+
+        pRing->fd = fd;
+        pRing->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        pRing->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        pRing->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+        bool single_map = params.features & IORING_FEAT_SINGLE_MMAP;
+
+        if (single_map)
+        {
+            pRing->sq_map_size = std::max(pRing->sq_map_size, pRing->cq_map_size);
+        }
+
+        const int prot = PROT_READ | PROT_WRITE;
+        const int flags = MAP_SHARED | MAP_POPULATE;
+        void* pSq_map = mmap(NULL, pRing->sq_map_size, prot, flags, fd, IORING_OFF_SQ_RING);
+        void* pCq_map = single_map ? pSq_map : mmap(NULL, pRing->cq_map_size, prot, flags, fd,
+                                                     IORING_OFF_CQ_RING);
+        void* pSqes = mmap(NULL, pRing->sqes_size, prot, flags, fd, IORING_OFF_SQES);
+
+        pRing->pSq_map = pSq_map != MAP_FAILED ? pSq_map : NULL;
+        pRing->pCq_map = pCq_map != MAP_FAILED ? pCq_map : NULL;
+        pRing->pSqes = pSqes != MAP_FAILED ? static_cast<io_uring_sqe*>(pSqes) : NULL;
+
+        if (!pRing->pSq_map || !pRing->pCq_map || !pRing->pSqes)
+        {
+            MXB_WARNING("Could not map io_uring: %s", mxb_strerror(errno));
+            unmap(pRing);
+            return NULL;
+        }
+
+        char* pSq = static_cast<char*>(pRing->pSq_map);
+        pRing->sq_entries = params.sq_entries;
+        pRing->sq_mask = *reinterpret_cast<uint32_t*>(pSq + params.sq_off.ring_mask);
+        pRing->pSq_head = reinterpret_cast<uint32_t*>(pSq + params.sq_off.head);
+        pRing->pSq_tail = reinterpret_cast<uint32_t*>(pSq + params.sq_off.tail);
+        pRing->pSq_array = reinterpret_cast<uint32_t*>(pSq + params.sq_off.array);
+        pRing->sq_tail = *pRing->pSq_tail;
+
+        char* pCq = static_cast<char*>(pRing->pCq_map);
+        pRing->cq_mask = *reinterpret_cast<uint32_t*>(pCq + params.cq_off.ring_mask);
+        pRing->pCq_head = reinterpret_cast<uint32_t*>(pCq + params.cq_off.head);
+        pRing->pCq_tail = reinterpret_cast<uint32_t*>(pCq + params.cq_off.tail);
+        pRing->pCqes = reinterpret_cast<io_uring_cqe*>(pCq + params.cq_off.cqes);
+
+        return pRing;
+    }
+
+    /**
+     * Check that multishot poll requests, which the kernel rejects with EINVAL
+     * before Linux 5.13, are supported.
+     */
+    bool supports_multishot_poll()
+    {
+        bool rv = false;
+        int fd = eventfd(0, EFD_NONBLOCK);
+
+        // An eventfd is always writable, so the request completes immediately.
+        if (fd != -1 && prep_poll_add(fd, EPOLLOUT, IGNORED, true))
+        {
+            if (enter(pending(), 1, IORING_ENTER_GETEVENTS, NULL, 0) >= 0 && has_completions())
+            {
+                rv = pCqes[*pCq_head & cq_mask].res > 0;
+                __atomic_store_n(pCq_head, *pCq_head + 1, __ATOMIC_RELEASE);
+            }
+
+            if (rv)
+            {
+                // The request is still active; cancel it and throw away what it produces.
+                prep_poll_remove(IGNORED);
+                enter(pending(), 2, IORING_ENTER_GETEVENTS, NULL, 0);
+                __atomic_store_n(pCq_head, __atomic_load_n(pCq_tail, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+            }
+        }
+
+        if (fd != -1)
+        {
+            close(fd);
+        }
+
+        return rv;
+    }
+};
+
+// static
+UringPoller* UringPoller::create(int epoll_fd, uint32_t entries)
+{
+    UringPoller* pPoller = NULL;
+    Ring* pRing = Ring::map(entries);
+
+    if (pRing)
+    {
+        if (!pRing->supports_multishot_poll())
+        {
+            MXB_WARNING("The kernel does not support multishot polling with io_uring.");
+            Ring::unmap(pRing);
+        }
+        else
+        {
+            pPoller = new(std::nothrow) UringPoller(pRing, epoll_fd);
+
+            if (!pPoller)
+            {
+                Ring::unmap(pRing);
+            }
+        }
+    }
+
+    return pPoller;
+}
+
+UringPoller::~UringPoller()
+{
+    Ring::unmap(m_pRing);
+}
+
+void UringPoller::arm(int fd, const Registration& registration)
+{
+    uint64_t user_data = to_user_data(fd, registration.generation);
+
+    if (!m_pRing->prep_poll_add(fd, registration.events, user_data, true))
+    {
+        // Only possible if the submission queue could not be flushed.
+        MXB_ERROR("Could not queue poll request for descriptor %d.", fd);
+    }
+}
+
+void UringPoller::flush()
+{
+    uint32_t to_submit = m_pRing->pending();
+
+    if (to_submit != 0)
+    {
+        m_pRing->enter(to_submit, 0, 0, NULL, 0);
+    }
+}
+
+bool UringPoller::add_fd(int fd, uint32_t events, MXB_POLL_DATA* pData)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    bool rv = false;
+
+    if (m_registrations.find(fd) != m_registrations.end())
+    {
+        errno = EEXIST;
+    }
+    else
+    {
+        // The multishot requests are edge-triggered by nature and EPOLLET is not a
+        // valid poll event; the error conditions are always reported.
+        // A zero generation could make the user data look like IGNORED.
+        if (++m_generation == 0)
+        {
+            m_generation = 1;
+        }
+
+        Registration& registration = m_registrations[fd];
+        registration.generation = m_generation;
+        registration.events = (events & ~EPOLLET) | EPOLLERR | EPOLLHUP;
+        registration.pData = pData;
+        registration.armed = true;
+
+        arm(fd, registration);
+        rv = true;
+    }
+
+    return rv;
+}
+
+bool UringPoller::remove_fd(int fd)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    bool rv = false;
+    auto it = m_registrations.find(fd);
+
+    if (it == m_registrations.end())
+    {
+        errno = ENOENT;
+    }
+    else
+    {
+        // Completions of the removed request that are already in the completion
+        // queue, or that arrive before the removal has taken effect, are ignored
+        // since the generation no longer matches.
+        if (it->second.armed)
+        {
+            m_pRing->prep_poll_remove(to_user_data(fd, it->second.generation));
+        }
+
+        m_registrations.erase(it);
+        rv = true;
+    }
+
+    return rv;
+}
+
+int UringPoller::wait(struct epoll_event* pEvents, int max_events, int timeout)
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+
+    if (!m_epoll_armed)
+    {
+        // A oneshot request, rearmed on each wait, makes the instance level-triggered.
+        m_epoll_armed = m_pRing->prep_poll_add(m_epoll_fd, EPOLLIN, EPOLL_INSTANCE, false);
+    }
+
+    uint32_t to_submit = m_pRing->pending();
+    guard.unlock();
+
+    int rv = 0;
+
+    if (m_pRing->has_completions())
+    {
+        // Events left over from the previous wait, no need to block.
+        flush();
+    }
+    else
+    {
+        __kernel_timespec ts;
+        ts.tv_sec = timeout / 1000;
+        ts.tv_nsec = (timeout % 1000) * 1000000;
+
+        io_uring_getevents_arg arg;
+        memset(&arg, 0, sizeof(arg));
+        arg.sigmask_sz = _NSIG / 8;
+        arg.ts = timeout >= 0 ? (uint64_t)(uintptr_t)&ts : 0;
+
+        if (m_pRing->enter(to_submit, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                           &arg, sizeof(arg)) == -1
+            && errno != ETIME && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            rv = -1;
+        }
+    }
+
+    if (rv == 0)
+    {
+        guard.lock();
+
+        bool epoll_ready = false;
+        uint32_t head = *m_pRing->pCq_head;
+        uint32_t tail = __atomic_load_n(m_pRing->pCq_tail, __ATOMIC_ACQUIRE);
+
+        while (head != tail && rv < max_events)
+        {
+            const io_uring_cqe& cqe = m_pRing->pCqes[head & m_pRing->cq_mask];
+            ++head;
+
+            if (cqe.user_data == EPOLL_INSTANCE)
+            {
+                m_epoll_armed = false;
+                epoll_ready = cqe.res > 0;
+            }
+            else if (cqe.user_data != IGNORED)
+            {
+                int fd = (int)(uint32_t)cqe.user_data;
+                uint32_t generation = cqe.user_data >> 32;
+                auto it = m_registrations.find(fd);
+
+                if (it != m_registrations.end() && it->second.generation == generation)
+                {
+                    Registration& registration = it->second;
+
+                    if (cqe.res > 0)
+                    {
+                        pEvents[rv].events = cqe.res;
+                        pEvents[rv].data.ptr = registration.pData;
+                        ++rv;
+                    }
+
+                    if (!(cqe.flags & IORING_CQE_F_MORE))
+                    {
+                        // The kernel ends a multishot request if it cannot post a completion
+                        // or if the poll fails. In the former case the request is rearmed, in
+                        // the latter the error is reported and the descriptor left alone.
+                        if (cqe.res > 0 || cqe.res == -ECANCELED)
+                        {
+                            arm(fd, registration);
+                        }
+                        else
+                        {
+                            registration.armed = false;
+                            pEvents[rv].events = EPOLLERR;
+                            pEvents[rv].data.ptr = registration.pData;
+                            ++rv;
+                        }
+                    }
+                }
+                else if (cqe.flags & IORING_CQE_F_MORE)
+                {
+                    // The request of a removed registration is still active. The removal
+                    // fails with EALREADY if the request was being completed at the time,
+                    // so it has to be repeated.
+                    m_pRing->prep_poll_remove(cqe.user_data);
+                }
+            }
+        }
+
+        __atomic_store_n(m_pRing->pCq_head, head, __ATOMIC_RELEASE);
+        guard.unlock();
+
+        if (epoll_ready && rv < max_events)
+        {
+            int n = epoll_wait(m_epoll_fd, pEvents + rv, max_events - rv, 0);
+
+            if (n > 0)
+            {
+                rv += n;
+            }
+        }
+    }
+
+    return rv;
+}
+
+UringPoller::UringPoller(Ring* pRing, int epoll_fd)
+    : m_pRing(pRing)
+    , m_epoll_fd(epoll_fd)
+    , m_epoll_armed(false)
+    , m_generation(0)
+{
+}
+
+#else
+
+// static
+UringPoller* UringPoller::create(int epoll_fd, uint32_t entries)
+{
+    MXB_WARNING("MaxScale was built without io_uring support.");
+    return NULL;
+}
+
+UringPoller::~UringPoller()
+{
+}
+
+bool UringPoller::add_fd(int fd, uint32_t events, MXB_POLL_DATA* pData)
+{
+    errno = ENOSYS;
+    return false;
+}
+
+bool UringPoller::remove_fd(int fd)
+{
+    errno = ENOSYS;
+    return false;
+}
+
+int UringPoller::wait(struct epoll_event* pEvents, int max_events, int timeout)
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+#endif
+}
@@ -17,6 +17,7 @@
 #include <fcntl.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <vector>
 #include <sstream>
@@ -26,6 +27,7 @@
 #include <maxbase/atomic.hh>
 #include <maxbase/log.h>
 #include <maxbase/string.h>
+#include <maxbase/uringpoller.hh>
 
 #define WORKER_ABSENT_ID -1
 
@@ -46,10 +48,12 @@ const int MXB_WORKER_MSG_DISPOSABLE_TASK = -2;
  */
 struct this_unit
 {
-    bool initialized;   // Whether the initialization has been performed.
+    bool                 initialized;   // Whether the initialization has been performed.
+    Worker::io_backend_t io_backend;    // The I/O backend of new workers.
 } this_unit =
 {
-    false,      // initialized
+    false,                      // initialized
+    Worker::IO_BACKEND_EPOLL,   // io_backend
 };
 
 thread_local struct this_thread
@@ -279,12 +283,30 @@ int create_epoll_instance()
 
     return fd;
 }
+
+mxb::UringPoller* create_uring_poller(int epoll_fd, Worker::io_backend_t backend, int max_events)
+{
+    mxb::UringPoller* pUring = NULL;
+
+    if (epoll_fd != -1 && backend == Worker::IO_BACKEND_IO_URING)
+    {
+        pUring = mxb::UringPoller::create(epoll_fd, max_events);
+
+        if (!pUring)
+        {
+            MXB_WARNING("io_uring could not be used, the worker will use epoll.");
+        }
+    }
+
+    return pUring;
+}
 }
 
 Worker::Worker(int max_events)
     : m_epoll_fd(create_epoll_instance())
     , m_state(STOPPED)
     , m_max_events(max_events)
+    , m_pUring(create_uring_poller(m_epoll_fd, this_unit.io_backend, max_events))
     , m_pQueue(NULL)
     , m_started(false)
     , m_should_shutdown(false)
@@ -292,6 +314,7 @@ Worker::Worker(int max_events)
     , m_nCurrent_descriptors(0)
     , m_nTotal_descriptors(0)
     , m_pTimer(new PrivateTimer(this, this, &Worker::tick))
+    , m_calls_by_time(WorkerLoad::get_time_ms())
     , m_next_delayed_call_id{1}
 {
     mxb_assert(max_events > 0);
@@ -322,6 +345,7 @@ Worker::~Worker()
 
     delete m_pTimer;
     delete m_pQueue;
+    delete m_pUring;
     close(m_epoll_fd);
 
     // When going down, we need to cancel all pending calls.
@@ -349,6 +373,57 @@ void Worker::finish()
     this_unit.initialized = false;
 }
 
+// static
+void Worker::set_io_backend(io_backend_t backend)
+{
+    this_unit.io_backend = backend;
+}
+
+// static
+Worker::io_backend_t Worker::get_io_backend()
+{
+    return this_unit.io_backend;
+}
+
+// static
+const char* Worker::io_backend_to_string(io_backend_t backend)
+{
+    const char* zValue = "epoll";
+
+    switch (backend)
+    {
+    case IO_BACKEND_EPOLL:
+        break;
+
+    case IO_BACKEND_IO_URING:
+        zValue = "io_uring";
+        break;
+    }
+
+    return zValue;
+}
+
+// static
+bool Worker::io_backend_from_string(const char* zValue, io_backend_t* pBackend)
+{
+    bool rv = true;
+
+    if (strcmp(zValue, "epoll") == 0)
+    {
+        *pBackend = IO_BACKEND_EPOLL;
+    }
+    else if (strcmp(zValue, "io_uring") == 0)
+    {
+        *pBackend = IO_BACKEND_IO_URING;
+    }
+    else
+    {
+        rv = false;
+    }
+
+    return rv;
+}
+
 void Worker::get_descriptor_counts(uint32_t* pnCurrent, uint64_t* pnTotal)
 {
     *pnCurrent = atomic_load_uint32(&m_nCurrent_descriptors);
@@ -369,7 +444,7 @@ bool Worker::add_fd(int fd, uint32_t events, MXB_POLL_DATA* pData)
 
     pData->owner = this;
 
-    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0)
+    if (m_pUring ? m_pUring->add_fd(fd, events, pData) : epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0)
     {
         mxb::atomic::add(&m_nCurrent_descriptors, 1, mxb::atomic::RELAXED);
         mxb::atomic::add(&m_nTotal_descriptors, 1, mxb::atomic::RELAXED);
@@ -389,7 +464,7 @@ bool Worker::remove_fd(int fd)
 
     struct epoll_event ev = {};
 
-    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, &ev) == 0)
+    if (m_pUring ? m_pUring->remove_fd(fd) : epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, &ev) == 0)
     {
         mxb::atomic::add(&m_nCurrent_descriptors, -1, mxb::atomic::RELAXED);
     }
@@ -778,7 +853,8 @@ void Worker::poll_waitevents()
         }
 
         m_load.about_to_wait(now);
-        nfds = epoll_wait(m_epoll_fd, events, m_max_events, timeout);
+        nfds = m_pUring ? m_pUring->wait(events, m_max_events, timeout) :
+            epoll_wait(m_epoll_fd, events, m_max_events, timeout);
         m_load.about_to_work();
 
         if (nfds == -1 && errno != EINTR)
@@ -893,17 +969,17 @@ void Worker::tick()
 
     vector<DelayedCall*> repeating_calls;
 
-    auto i = m_sorted_calls.begin();
+    MXB_TIMER* pTimer;
 
-    // i->first is the time when the first call should be invoked.
-    while (!m_sorted_calls.empty() && (i->first <= now))
+    // NOTE: The calls must be fetched one at a time, as a delayed
+    // NOTE: call may cancel another delayed call.
+    while ((pTimer = m_calls_by_time.expire(now)) != nullptr)
     {
-        DelayedCall* pCall = i->second;
+        DelayedCall* pCall = static_cast<DelayedCall*>(pTimer);
 
         auto j = m_calls.find(pCall->id());
         mxb_assert(j != m_calls.end());
 
-        m_sorted_calls.erase(i);
         m_calls.erase(j);
 
         if (pCall->call(Worker::Call::EXECUTE))
@@ -914,17 +990,13 @@ void Worker::tick()
         {
             delete pCall;
         }
-
-        // NOTE: Must be reassigned, ++i will not work in case a delayed
-        // NOTE: call cancels another delayed call.
-        i = m_sorted_calls.begin();
     }
 
     for (auto i = repeating_calls.begin(); i != repeating_calls.end(); ++i)
     {
         DelayedCall* pCall = *i;
 
-        m_sorted_calls.insert(std::make_pair(pCall->at(), pCall));
+        m_calls_by_time.add(pCall, pCall->at());
         m_calls.insert(std::make_pair(pCall->id(), pCall));
     }
 
@@ -933,23 +1005,13 @@ void Worker::tick()
 
 uint32_t Worker::add_delayed_call(DelayedCall* pCall)
 {
-    bool adjust = true;
-
-    if (!m_sorted_calls.empty())
-    {
-        DelayedCall* pFirst = m_sorted_calls.begin()->second;
-
-        if (pCall->at() > pFirst->at())
-        {
-            // If the added delayed call needs to be called later
-            // than the first delayed call, then we do not need to
-            // adjust the timer.
-            adjust = false;
-        }
-    }
+    // If the added delayed call needs to be called later than
+    // the timer will expire, then we do not need to adjust the
+    // timer.
+    bool adjust = pCall->at() <= m_calls_by_time.next_expiry();
 
-    // Insert the delayed call into the map ordered by invocation time.
-    m_sorted_calls.insert(std::make_pair(pCall->at(), pCall));
+    // Insert the delayed call into the timing wheel.
+    m_calls_by_time.add(pCall, pCall->at());
 
     // Insert the delayed call into the map indexed by id.
     mxb_assert(m_calls.find(pCall->id()) == m_calls.end());
@@ -965,12 +1027,10 @@ uint32_t Worker::add_delayed_call(DelayedCall* pCall)
 
 void Worker::adjust_timer()
 {
-    if (!m_sorted_calls.empty())
+    if (m_calls_by_time.size() != 0)
     {
-        DelayedCall* pCall = m_sorted_calls.begin()->second;
-
         uint64_t now = WorkerLoad::get_time_ms();
-        int64_t delay = pCall->at() - now;
+        int64_t delay = m_calls_by_time.next_expiry() - now;
 
         if (delay <= 0)
         {
@@ -996,27 +1056,13 @@ bool Worker::cancel_delayed_call(uint32_t id)
         DelayedCall* pCall = i->second;
         m_calls.erase(i);
 
-        // All delayed calls with exactly the same trigger time.
-        // Not particularly likely there will be many of those.
-        auto range = m_sorted_calls.equal_range(pCall->at());
+        mxb_assert(TimingWheel::is_scheduled(pCall));
+        m_calls_by_time.remove(pCall);
 
-        mxb_assert(range.first != range.second);
-
-        for (auto k = range.first; k != range.second; ++k)
-        {
-            if (k->second == pCall)
-            {
-                m_sorted_calls.erase(k);
-
-                pCall->call(Worker::Call::CANCEL);
-                delete pCall;
-
-                found = true;
-                break;
-            }
-        }
+        pCall->call(Worker::Call::CANCEL);
+        delete pCall;
 
-        mxb_assert(found);
+        found = true;
     }
     else
     {
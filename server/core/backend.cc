@@ -67,6 +67,10 @@ void Backend::close(close_type type)
             {
                 set_state(FATAL_FAILURE);
             }
+            else if (type == CLOSE_IDLE)
+            {
+                m_dcb->flags |= DCBF_IDLE;
+            }
 
             dcb_close(m_dcb);
             m_dcb = NULL;
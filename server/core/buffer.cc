@@ -15,6 +15,7 @@
 
 #include <errno.h>
 #include <stdlib.h>
+#include <atomic>
 #include <sstream>
 
 #include <maxbase/assert.h>
@@ -30,12 +31,272 @@ static void             gwbuf_free_one(GWBUF* buf);
 static buffer_object_t* gwbuf_remove_buffer_object(GWBUF* buf,
                                                    buffer_object_t* bufobj);
 
+namespace
+{
+
+class BufferPool;
+
+thread_local struct this_thread
+{
+    BufferPool* pPool;      // The buffer pool of the current thread, if it is a routing worker.
+} this_thread =
+{
+    nullptr
+};
+
+/**
+ * A per-worker pool of memory blocks for GWBUF headers and shared buffers.
+ *
+ * Each block is preceded by a header that records the pool it belongs to.
+ * A block freed by the worker that allocated it is put on a free list of
+ * its size class, from which it is handed out again. A block freed by any
+ * other thread is pushed on a lock-free list of the owning pool, which the
+ * owner drains when a free list of its runs empty. Allocations made outside
+ * the routing workers, and ones too large for any size class, go directly
+ * to the system allocator.
+ */
+class BufferPool
+{
+public:
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * Get the pool of the calling thread.
+     *
+     * @return The pool, or NULL if the calling thread is not a routing worker.
+     */
+    static BufferPool* get()
+    {
+        if (!this_thread.pPool && RoutingWorker::get_current_id() != -1)
+        {
+            // The pool lives as long as the process, as blocks returned to it
+            // may be freed by other threads at any time.
+            this_thread.pPool = new(std::nothrow) BufferPool;
+        }
+
+        return this_thread.pPool;
+    }
+
+    /**
+     * Allocate memory, from the pool of the calling thread if there is one.
+     *
+     * @param size  The number of bytes to allocate.
+     *
+     * @return The memory, or NULL if it could not be allocated.
+     */
+    static void* allocate(size_t size)
+    {
+        BufferPool* pPool = get();
+
+        return pPool ? pPool->alloc(size) : create_block(nullptr, N_CLASSES, size);
+    }
+
+    /**
+     * Free memory allocated with @c BufferPool::allocate().
+     *
+     * @param p  The memory, may be NULL.
+     */
+    static void deallocate(void* p)
+    {
+        if (p)
+        {
+            Block* pBlock = static_cast<Block*>(p) - 1;
+            BufferPool* pOwner = pBlock->pOwner;
+
+            if (!pOwner)
+            {
+                MXS_FREE(pBlock);
+            }
+            else if (pOwner == this_thread.pPool)
+            {
+                pOwner->release(pBlock);
+            }
+            else
+            {
+                pOwner->release_remote(pBlock);
+            }
+        }
+    }
+
+    void get_stats(GWBUF_POOL_STATS* pStats) const
+    {
+        *pStats = m_stats;
+    }
+
+private:
+    enum
+    {
+        N_CLASSES = 5
+    };
+
+    // The block header, padded so that the memory following it remains suitably aligned.
+    struct alignas(16) Block
+    {
+        BufferPool* pOwner;      // The pool the block is returned to, NULL if not pooled.
+        uint32_t    size_class;  // Index of the size class, N_CLASSES if not pooled.
+    };
+
+    BufferPool()
+        : m_remote(nullptr)
+    {
+        memset(m_free, 0, sizeof(m_free));
+        memset(m_nFree, 0, sizeof(m_nFree));
+        memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+    // When a block is on a free list, the link to the next block is stored in the memory after the header.
+    static Block*& next_of(Block* pBlock)
+    {
+        return *reinterpret_cast<Block**>(pBlock + 1);
+    }
+
+    static void* create_block(BufferPool* pOwner, uint32_t size_class, size_t size)
+    {
+        Block* pBlock = static_cast<Block*>(MXS_MALLOC(sizeof(Block) + size));
+        void* rv = nullptr;
+
+        if (pBlock)
+        {
+            pBlock->pOwner = pOwner;
+            pBlock->size_class = size_class;
+            rv = pBlock + 1;
+        }
+
+        return rv;
+    }
+
+    static uint32_t size_class_of(size_t size)
+    {
+        uint32_t i = 0;
+
+        while (i < N_CLASSES && size > SIZES[i])
+        {
+            ++i;
+        }
+
+        return i;
+    }
+
+    void* alloc(size_t size)
+    {
+        uint32_t i = size_class_of(size);
+        void* rv = nullptr;
+
+        if (i == N_CLASSES)
+        {
+            ++m_stats.fallbacks;
+            rv = create_block(nullptr, N_CLASSES, size);
+        }
+        else
+        {
+            if (!m_free[i] && m_remote.load(std::memory_order_relaxed))
+            {
+                drain_remote();
+            }
+
+            Block* pBlock = m_free[i];
+
+            if (pBlock)
+            {
+                m_free[i] = next_of(pBlock);
+                --m_nFree[i];
+                --m_stats.cached;
+                ++m_stats.hits;
+                rv = pBlock + 1;
+            }
+            else
+            {
+                ++m_stats.misses;
+                rv = create_block(this, i, SIZES[i]);
+            }
+        }
+
+        return rv;
+    }
+
+    void release(Block* pBlock)
+    {
+        uint32_t i = pBlock->size_class;
+        mxb_assert(i < N_CLASSES);
+
+        if (m_nFree[i] < MAX_FREE[i])
+        {
+            next_of(pBlock) = m_free[i];
+            m_free[i] = pBlock;
+            ++m_nFree[i];
+            ++m_stats.cached;
+        }
+        else
+        {
+            MXS_FREE(pBlock);
+        }
+    }
+
+    void release_remote(Block* pBlock)
+    {
+        Block* pHead = m_remote.load(std::memory_order_relaxed);
+
+        do
+        {
+            next_of(pBlock) = pHead;
+        }
+        while (!m_remote.compare_exchange_weak(pHead, pBlock,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+    }
+
+    void drain_remote()
+    {
+        Block* pBlock = m_remote.exchange(nullptr, std::memory_order_acquire);
+
+        while (pBlock)
+        {
+            Block* pNext = next_of(pBlock);
+            ++m_stats.remote_frees;
+            release(pBlock);
+            pBlock = pNext;
+        }
+    }
+
+    static const size_t   SIZES[N_CLASSES];     // The size of the blocks of each class.
+    static const uint32_t MAX_FREE[N_CLASSES];  // The maximum number of free blocks kept of each class.
+
+    Block*              m_free[N_CLASSES];  // The free blocks of each class.
+    uint32_t            m_nFree[N_CLASSES]; // The number of free blocks of each class.
+    std::atomic<Block*> m_remote;           // Blocks freed by other threads.
+    GWBUF_POOL_STATS    m_stats;
+};
+
+// The first class holds GWBUF headers and the rest shared buffers of increasing size.
+const size_t BufferPool::SIZES[N_CLASSES] =
+{
+    sizeof(GWBUF), 128, 512, 2048, 16384
+};
+
+const uint32_t BufferPool::MAX_FREE[N_CLASSES] =
+{
+    1024, 1024, 512, 128, 32
+};
+}
+
+bool gwbuf_get_pool_stats(GWBUF_POOL_STATS* pStats)
+{
+    BufferPool* pPool = BufferPool::get();
+
+    if (pPool)
+    {
+        pPool->get_stats(pStats);
+    }
+
+    return pPool != nullptr;
+}
+
 /**
  * Allocate a new gateway buffer structure of size bytes.
  *
- * For now we allocate memory directly from malloc for buffer the management
- * structure and the actual data buffer itself. We may swap at a future date
- * to a more efficient mechanism.
+ * The buffer structure and the data buffer are allocated from the pool of
+ * the calling routing worker.
  *
  * @param       size The size in bytes of the data area required
  * @return      Pointer to the buffer structure or NULL if memory could not
@@ -44,13 +305,13 @@ static buffer_object_t* gwbuf_remove_buffer_object(GWBUF* buf,
 GWBUF* gwbuf_alloc(unsigned int size)
 {
     size_t sbuf_size = sizeof(SHARED_BUF) + (size ? size - 1 : 0);
-    GWBUF* rval = (GWBUF*)MXS_MALLOC(sizeof(GWBUF));
-    SHARED_BUF* sbuf = (SHARED_BUF*)MXS_MALLOC(sbuf_size);
+    GWBUF* rval = (GWBUF*)BufferPool::allocate(sizeof(GWBUF));
+    SHARED_BUF* sbuf = (SHARED_BUF*)BufferPool::allocate(sbuf_size);
 
     if (rval == NULL || sbuf == NULL)
     {
-        MXS_FREE(rval);
-        MXS_FREE(sbuf);
+        BufferPool::deallocate(rval);
+        BufferPool::deallocate(sbuf);
         return NULL;
     }
 
@@ -128,7 +389,7 @@ static void gwbuf_free_one(GWBUF* buf)
             bo = gwbuf_remove_buffer_object(buf, bo);
         }
 
-        MXS_FREE(buf->sbuf);
+        BufferPool::deallocate(buf->sbuf);
     }
 
     while (buf->properties)
@@ -147,7 +408,7 @@ static void gwbuf_free_one(GWBUF* buf)
         hint_free(h);
     }
 
-    MXS_FREE(buf);
+    BufferPool::deallocate(buf);
 }
 
 /**
@@ -162,13 +423,15 @@ static void gwbuf_free_one(GWBUF* buf)
  */
 static GWBUF* gwbuf_clone_one(GWBUF* buf)
 {
-    GWBUF* rval = (GWBUF*)MXS_CALLOC(1, sizeof(GWBUF));
+    GWBUF* rval = (GWBUF*)BufferPool::allocate(sizeof(GWBUF));
 
     if (rval == NULL)
     {
         return NULL;
     }
 
+    memset(rval, 0, sizeof(GWBUF));
+
     mxb_assert(buf->owner == RoutingWorker::get_current_id());
     ++buf->sbuf->refcount;
 #ifdef SS_DEBUG
@@ -257,7 +520,7 @@ static GWBUF *gwbuf_clone_portion(GWBUF* buf,
     mxb_assert(buf->owner == RoutingWorker::get_current_id());
     mxb_assert(start_offset + length <= GWBUF_LENGTH(buf));
 
-    GWBUF* clonebuf = (GWBUF*)MXS_MALLOC(sizeof(GWBUF));
+    GWBUF* clonebuf = (GWBUF*)BufferPool::allocate(sizeof(GWBUF));
 
     if (clonebuf == NULL)
     {
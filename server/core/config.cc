@@ -54,6 +54,7 @@
 #include <maxscale/paths.h>
 #include <maxscale/pcre2.h>
 #include <maxscale/router.h>
+#include <maxscale/routingworker.hh>
 #include <maxscale/secrets.h>
 #include <maxscale/utils.h>
 #include <maxscale/utils.hh>
@@ -109,7 +110,9 @@ const char CN_GATEWAY[] = "gateway";
 const char CN_HAS_WHERE_CLAUSE[] = "has_where_clause";
 const char CN_ID[] = "id";
 const char CN_INET[] = "inet";
+const char CN_IO_BACKEND[] = "io_backend";
 const char CN_LISTENER[] = "listener";
+const char CN_LISTENER_MODE[] = "listener_mode";
 const char CN_LISTENERS[] = "listeners";
 const char CN_LOCALHOST_MATCH_WILDCARD_HOST[] = "localhost_match_wildcard_host";
 const char CN_LOG_AUTH_WARNINGS[] = "log_auth_warnings";
@@ -183,6 +186,8 @@ const char CN_USERS[] = "users";
 const char CN_USERS_REFRESH_TIME[] = "users_refresh_time";
 const char CN_VERSION_STRING[] = "version_string";
 const char CN_WEIGHTBY[] = "weightby";
+const char CN_WORKER_AFFINITY[] = "worker_affinity";
+const char CN_WORKER_ASSIGNMENT[] = "worker_assignment";
 const char CN_WRITEQ_HIGH_WATER[] = "writeq_high_water";
 const char CN_WRITEQ_LOW_WATER[] = "writeq_low_water";
 
@@ -201,6 +206,9 @@ extern const char CN_SYSLOG[] = "syslog";
 extern const char CN_MAXLOG[] = "maxlog";
 extern const char CN_LOG_AUGMENTATION[] = "log_augmentation";
 extern const char CN_LOG_TO_SHM[] = "log_to_shm";
+extern const char CN_LOG_ASYNC[] = "log_async";
+extern const char CN_LOG_ASYNC_BUFFER_SIZE[] = "log_async_buffer_size";
+extern const char CN_LOG_ASYNC_OVERFLOW[] = "log_async_overflow";
 
 typedef struct duplicate_context
 {
@@ -366,6 +374,7 @@ const MXS_MODULE_PARAM config_monitor_params[] =
     {CN_BACKEND_READ_TIMEOUT,      MXS_MODULE_PARAM_COUNT,  "1"},
     {CN_BACKEND_WRITE_TIMEOUT,     MXS_MODULE_PARAM_COUNT,  "2"},
     {CN_BACKEND_CONNECT_ATTEMPTS,  MXS_MODULE_PARAM_COUNT,  "1"},
+    {CN_CONCURRENT_PROBING,        MXS_MODULE_PARAM_BOOL,   "false"},
 
     {CN_JOURNAL_MAX_AGE,           MXS_MODULE_PARAM_COUNT,  "28800"},
     {CN_DISK_SPACE_THRESHOLD,      MXS_MODULE_PARAM_STRING},
@@ -408,8 +417,10 @@ const MXS_MODULE_PARAM config_server_params[] =
     {CN_MONITORUSER,                 MXS_MODULE_PARAM_STRING},
     {CN_MONITORPW,                   MXS_MODULE_PARAM_STRING},
     {CN_PERSISTPOOLMAX,              MXS_MODULE_PARAM_COUNT,  "0"},
+    {CN_PERSISTPOOLMIN,              MXS_MODULE_PARAM_COUNT,  "0"},
     {CN_PERSISTMAXTIME,              MXS_MODULE_PARAM_COUNT,  "0"},
     {CN_PROXY_PROTOCOL,              MXS_MODULE_PARAM_BOOL,   "false"},
+    {CN_COMPRESSION,                 MXS_MODULE_PARAM_BOOL,   "false"},
     {CN_SSL,                         MXS_MODULE_PARAM_ENUM,   "false",
      MXS_MODULE_OPT_ENUM_UNIQUE,
      ssl_values},
@@ -448,6 +459,9 @@ const char* config_pre_parse_global_params[] =
     CN_MAXLOG,
     CN_LOG_AUGMENTATION,
     CN_LOG_TO_SHM,
+    CN_LOG_ASYNC,
+    CN_LOG_ASYNC_BUFFER_SIZE,
+    CN_LOG_ASYNC_OVERFLOW,
     CN_SUBSTITUTE_VARIABLES,
     NULL
 };
@@ -2586,6 +2600,65 @@ static int handle_global_item(const char* name, const char* value)
             return 0;
         }
     }
+    else if (strcmp(name, CN_IO_BACKEND) == 0)
+    {
+        mxb::Worker::io_backend_t backend;
+
+        if (mxb::Worker::io_backend_from_string(value, &backend))
+        {
+            if (backend == mxb::Worker::IO_BACKEND_IO_URING)
+            {
+                MXS_WARNING("%s=%s is experimental and should not be used in production.",
+                            CN_IO_BACKEND, value);
+            }
+
+            mxb::Worker::set_io_backend(backend);
+        }
+        else
+        {
+            MXS_ERROR("%s can have the values 'epoll' or 'io_uring'.", CN_IO_BACKEND);
+            return 0;
+        }
+    }
+    else if (strcmp(name, CN_LISTENER_MODE) == 0)
+    {
+        mxs::RoutingWorker::listener_mode_t mode;
+
+        if (mxs::RoutingWorker::listener_mode_from_string(value, &mode))
+        {
+            mxs::RoutingWorker::set_listener_mode(mode);
+        }
+        else
+        {
+            MXS_ERROR("%s can have the values 'shared', 'reuseport' or 'reuseport_cpu'.",
+                      CN_LISTENER_MODE);
+            return 0;
+        }
+    }
+    else if (strcmp(name, CN_WORKER_AFFINITY) == 0)
+    {
+        if (!mxs::RoutingWorker::set_affinity(value))
+        {
+            MXS_ERROR("%s can have the values 'none', 'cores' or a list of CPUs, e.g. '0-3,8'.",
+                      CN_WORKER_AFFINITY);
+            return 0;
+        }
+    }
+    else if (strcmp(name, CN_WORKER_ASSIGNMENT) == 0)
+    {
+        mxs::RoutingWorker::assignment_t assignment;
+
+        if (mxs::RoutingWorker::assignment_from_string(value, &assignment))
+        {
+            mxs::RoutingWorker::set_assignment(assignment);
+        }
+        else
+        {
+            MXS_ERROR("%s can have the values 'round_robin', 'least_loaded' or 'address_hash'.",
+                      CN_WORKER_ASSIGNMENT);
+            return 0;
+        }
+    }
     else if (strcmp(name, CN_DUMP_LAST_STATEMENTS) == 0)
     {
         if (strcmp(value, "on_close") == 0)
@@ -2813,6 +2886,7 @@ void config_set_global_defaults()
     gateway.skip_permission_checks = false;
     gateway.syslog = 1;
     gateway.maxlog = 1;
+    mxb_log_get_async(&gateway.log_async);
     gateway.admin_port = DEFAULT_ADMIN_HTTP_PORT;
     gateway.admin_auth = true;
     gateway.admin_log_auth_failures = true;
@@ -4503,6 +4577,14 @@ json_t* config_maxscale_to_json(const char* host)
     json_object_set_new(param, CN_THREAD_STACK_SIZE, json_integer(config_thread_stack_size()));
     json_object_set_new(param, CN_WRITEQ_HIGH_WATER, json_integer(config_writeq_high_water()));
     json_object_set_new(param, CN_WRITEQ_LOW_WATER, json_integer(config_writeq_low_water()));
+    json_object_set_new(param, CN_IO_BACKEND,
+                        json_string(mxb::Worker::io_backend_to_string(mxb::Worker::get_io_backend())));
+    json_object_set_new(param, CN_LISTENER_MODE,
+                        json_string(mxs::RoutingWorker::listener_mode_to_string(
+                                        mxs::RoutingWorker::get_listener_mode())));
+    json_object_set_new(param, CN_WORKER_ASSIGNMENT,
+                        json_string(mxs::RoutingWorker::assignment_to_string(mxs::RoutingWorker::get_assignment())));
+    json_object_set_new(param, CN_WORKER_AFFINITY, json_string(mxs::RoutingWorker::get_affinity()));
 
     MXS_CONFIG* cnf = config_get_global_options();
 
@@ -32,6 +32,7 @@
 #include <maxscale/json_api.h>
 #include <maxscale/paths.h>
 #include <maxscale/router.h>
+#include <maxscale/routingworker.hh>
 #include <maxscale/users.h>
 
 #include "internal/config.hh"
@@ -507,6 +508,13 @@ bool runtime_alter_server(SERVER* server, const char* key, const char* value)
             server->persistpoolmax = atoi(value);
         }
     }
+    else if (strcmp(key, CN_PERSISTPOOLMIN) == 0)
+    {
+        if (is_valid_integer(value))
+        {
+            server->persistpoolmin = atoi(value);
+        }
+    }
     else if (strcmp(key, CN_PERSISTMAXTIME) == 0)
     {
         if (is_valid_integer(value))
@@ -630,6 +638,10 @@ bool do_alter_monitor(MXS_MONITOR* monitor, const char* key, const char* value)
                                         CN_BACKEND_CONNECT_ATTEMPTS);
         }
     }
+    else if (strcmp(key, CN_CONCURRENT_PROBING) == 0)
+    {
+        monitor->concurrent_probing = config_truth_value(value);
+    }
     else if (strcmp(key, CN_JOURNAL_MAX_AGE) == 0)
     {
         if (auto ival = get_positive_int(value))
@@ -986,6 +998,21 @@ bool runtime_alter_maxscale(const char* name, const char* value)
             config_runtime_error("Invalid value for '%s': %s", CN_RETAIN_LAST_STATEMENTS, value);
         }
     }
+    else if (key == CN_WORKER_ASSIGNMENT)
+    {
+        mxs::RoutingWorker::assignment_t assignment;
+
+        if (mxs::RoutingWorker::assignment_from_string(value, &assignment))
+        {
+            mxs::RoutingWorker::set_assignment(assignment);
+            rval = true;
+        }
+        else
+        {
+            config_runtime_error("%s can have the values 'round_robin', 'least_loaded' or 'address_hash'.",
+                                 CN_WORKER_ASSIGNMENT);
+        }
+    }
     else if (key == CN_DUMP_LAST_STATEMENTS)
     {
         rval = true;
@@ -25,6 +25,7 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <linux/filter.h>
 #include <netinet/tcp.h>
 #include <signal.h>
 #include <stdarg.h>
@@ -35,12 +36,17 @@
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <time.h>
+#include <limits.h>
+#include <vector>
 
 #include <maxscale/alloc.h>
 #include <maxbase/atomic.h>
 #include <maxbase/atomic.hh>
+#include <maxbase/stopwatch.hh>
+#include <maxbase/timingwheel.hh>
 #include <maxscale/clock.h>
 #include <maxscale/limits.h>
 #include <maxscale/listener.h>
@@ -71,24 +77,36 @@ constexpr uint32_t poll_events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLHUP | EP
 constexpr uint32_t poll_events = EPOLLIN | EPOLLOUT | EPOLLHUP | EPOLLET;
 #endif
 
+/**
+ * The bounds of the size of a single read from a socket. The size of the reads of
+ * a DCB starts at the minimum and is adapted to the amount of data that recent
+ * reads have returned.
+ */
+const int DCB_MIN_READ_SIZE = 512;
+const int DCB_MAX_READ_SIZE = MXS_SO_RCVBUF_SIZE;
+
 namespace
 {
 
 static struct
 {
-    DCB   dcb_initialized;  /** A DCB with null values, used for initialization. */
-    DCB** all_dcbs;         /** #workers sized array of pointers to DCBs where dcbs are listed. */
-    bool  check_timeouts;   /** Should session timeouts be checked. */
+    DCB               dcb_initialized;  /** A DCB with null values, used for initialization. */
+    DCB**             all_dcbs;         /** #workers sized array of pointers to DCBs where dcbs are listed. */
+    mxb::TimingWheel* idle_timers;      /** #workers sized array of the idle timeouts of client DCBs. */
+    bool              check_timeouts;   /** Should session timeouts be checked. */
+    int               timeouts_version; /** Incremented when session timeouts are changed. */
 } this_unit;
 
 static thread_local struct
 {
     long next_timeout_check;/** When to next check for idle sessions. */
+    int  timeouts_version;  /** The version of the session timeouts the idle timers are for. */
     DCB* current_dcb;       /** The DCB currently being handled by event handlers. */
 } this_thread;
 }
 
 static void        dcb_initialize(DCB* dcb);
+static void        dcb_schedule_idle_timeout(DCB* dcb, int thr);
 static void        dcb_final_free(DCB* dcb);
 static void        dcb_call_callback(DCB* dcb, DCB_REASON reason);
 static int         dcb_null_write(DCB* dcb, GWBUF* buf);
@@ -101,18 +119,15 @@ static int         dcb_bytes_readable(DCB* dcb);
 static int         dcb_read_no_bytes_available(DCB* dcb, int nreadtotal);
 static int         dcb_create_SSL(DCB* dcb, SSL_LISTENER* ssl);
 static int         dcb_read_SSL(DCB* dcb, GWBUF** head);
-static GWBUF*      dcb_basic_read(DCB* dcb,
-                                  int bytesavailable,
-                                  int maxbytes,
-                                  int nreadtotal,
-                                  int* nsingleread);
+static GWBUF*      dcb_basic_read(DCB* dcb, int bufsize, int* nsingleread);
 static GWBUF* dcb_basic_read_SSL(DCB* dcb, int* nsingleread);
 static void   dcb_log_write_failure(DCB* dcb, GWBUF* queue, int eno);
 static int    gw_write(DCB* dcb, GWBUF* writeq, bool* stop_writing);
 static int    gw_write_SSL(DCB* dcb, GWBUF* writeq, bool* stop_writing);
 static int    dcb_log_errors_SSL(DCB* dcb, int ret);
 static int    dcb_accept_one_connection(DCB* dcb, struct sockaddr* client_conn);
-static int    dcb_listen_create_socket_inet(const char* host, uint16_t port);
+static int    dcb_listen_create_socket_inet(const char* host, uint16_t port, enum mxs_socket_type type);
+static bool   dcb_listen_create_reuseport_group(DCB* dcb, int first, const char* host, uint16_t port);
 static int    dcb_listen_create_socket_unix(const char* path);
 static int    dcb_set_socket_option(int sockfd, int level, int optname, void* optval, socklen_t optlen);
 static void   dcb_add_to_all_list(DCB* dcb);
@@ -136,6 +151,7 @@ void dcb_global_init()
     this_unit.dcb_initialized.high_water_reached = false;
     this_unit.dcb_initialized.low_water = config_writeq_low_water();
     this_unit.dcb_initialized.high_water = config_writeq_high_water();
+    this_unit.dcb_initialized.read_size = DCB_MIN_READ_SIZE;
 
     int nthreads = config_threadcount();
 
@@ -144,6 +160,13 @@ void dcb_global_init()
         MXS_OOM();
         raise(SIGABRT);
     }
+
+    // The idle timeouts are measured in clock ticks.
+    if ((this_unit.idle_timers = new(std::nothrow) mxb::TimingWheel[nthreads]) == NULL)
+    {
+        MXS_OOM();
+        raise(SIGABRT);
+    }
 }
 
 void dcb_finish()
@@ -367,6 +390,15 @@ static void dcb_stop_polling_and_shutdown(DCB* dcb)
     }
 }
 
+/**
+ * @return The current time of the monotonic clock in microseconds
+ */
+static int64_t dcb_monotonic_usecs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        mxb::Clock::now().time_since_epoch()).count();
+}
+
 /**
  * Connect to a server
  *
@@ -406,6 +438,7 @@ DCB* dcb_connect(SERVER* server, MXS_SESSION* session, const char* protocol)
             MXS_DEBUG("Reusing a persistent connection, dcb %p", dcb);
             dcb->persistentstart = 0;
             dcb->was_persistent = true;
+            dcb->flags &= ~(DCBF_IDLE | DCBF_PREWARMED);
             dcb->last_read = mxs_clock();
             mxb::atomic::add(&server->stats.n_from_pool, 1, mxb::atomic::RELAXED);
             return dcb;
@@ -413,6 +446,11 @@ DCB* dcb_connect(SERVER* server, MXS_SESSION* session, const char* protocol)
         else
         {
             MXS_DEBUG("Failed to find a reusable persistent connection");
+
+            if (server->persistpoolmax)
+            {
+                mxb::atomic::add(&server->stats.n_pool_misses, 1, mxb::atomic::RELAXED);
+            }
         }
     }
 
@@ -493,6 +531,7 @@ DCB* dcb_connect(SERVER* server, MXS_SESSION* session, const char* protocol)
     dcb->server = server;
 
     dcb->was_persistent = false;
+    dcb->connect_start = dcb_monotonic_usecs();
 
     /**
      * backend_dcb is connected to backend server, and once backend_dcb
@@ -546,6 +585,21 @@ DCB* dcb_connect(SERVER* server, MXS_SESSION* session, const char* protocol)
     return dcb;
 }
 
+void dcb_handshake_complete(DCB* dcb)
+{
+    mxb_assert(dcb->dcb_role == DCB_ROLE_BACKEND_HANDLER && dcb->server);
+
+    if (dcb->connect_start)
+    {
+        SERVER_STATS* stats = &dcb->server->stats;
+        mxb::atomic::add(&stats->n_handshakes, 1, mxb::atomic::RELAXED);
+        mxb::atomic::add(&stats->handshake_time,
+                         dcb_monotonic_usecs() - dcb->connect_start,
+                         mxb::atomic::RELAXED);
+        dcb->connect_start = 0;
+    }
+}
+
 /**
  * General purpose read routine to read data from a socket in the
  * Descriptor Control Block and append it to a linked list of buffers.
@@ -589,42 +643,66 @@ int dcb_read(DCB* dcb,
         return 0;
     }
 
+    // A read that fills the buffer tells that more data may be pending, in which
+    // case FIONREAD is used for finding out how much. Otherwise the socket is read
+    // directly, until a read comes up short which means that it has been drained.
+    bool filled = false;
+
     while (0 == maxbytes || nreadtotal < maxbytes)
     {
-        int bytes_available;
+        int bufsize = dcb->read_size;
 
-        bytes_available = dcb_bytes_readable(dcb);
-        if (bytes_available <= 0)
+        if (filled)
         {
-            return bytes_available < 0 ? -1
-                                       :/** Handle closed client socket */
-                   dcb_read_no_bytes_available(dcb, nreadtotal);
+            int bytes_available = dcb_bytes_readable(dcb);
+
+            if (bytes_available <= 0)
+            {
+                return bytes_available < 0 ? -1 : nreadtotal;
+            }
+
+            bufsize = bytes_available;
         }
-        else
+
+        if (maxbytes != 0)
         {
-            GWBUF* buffer;
-            dcb->last_read = mxs_clock();
+            bufsize = MXS_MIN(bufsize, maxbytes - nreadtotal);
+        }
 
-            buffer = dcb_basic_read(dcb, bytes_available, maxbytes, nreadtotal, &nsingleread);
-            if (buffer)
-            {
-                nreadtotal += nsingleread;
-                MXS_DEBUG("Read %d bytes from dcb %p in state %s fd %d.",
-                          nsingleread,
-                          dcb,
-                          STRDCBSTATE(dcb->state),
-                          dcb->fd);
+        GWBUF* buffer;
+        dcb->last_read = mxs_clock();
 
-                /*< Assign the target server for the gwbuf */
-                buffer->server = dcb->server;
-                /*< Append read data to the gwbuf */
-                *head = gwbuf_append(*head, buffer);
-            }
-            else
+        buffer = dcb_basic_read(dcb, bufsize, &nsingleread);
+        if (buffer)
+        {
+            nreadtotal += nsingleread;
+            MXS_DEBUG("Read %d bytes from dcb %p in state %s fd %d.",
+                      nsingleread,
+                      dcb,
+                      STRDCBSTATE(dcb->state),
+                      dcb->fd);
+
+            /*< Assign the target server for the gwbuf */
+            buffer->server = dcb->server;
+            /*< Append read data to the gwbuf */
+            *head = gwbuf_append(*head, buffer);
+
+            filled = nsingleread == bufsize;
+
+            if (!filled)
             {
                 break;
             }
         }
+        else if (nsingleread == 0 || errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            /** Handle closed client socket */
+            return dcb_read_no_bytes_available(dcb, nreadtotal);
+        }
+        else
+        {
+            break;
+        }
     }   /*< while (0 == maxbytes || nreadtotal < maxbytes) */
 
     return nreadtotal;
@@ -640,6 +718,8 @@ static int dcb_bytes_readable(DCB* dcb)
 {
     int bytesavailable;
 
+    dcb->stats.n_ioctls++;
+
     if (-1 == ioctl(dcb->fd, FIONREAD, &bytesavailable))
     {
         MXS_ERROR("ioctl FIONREAD for dcb %p in state %s fd %d failed: %d, %s",
@@ -687,20 +767,43 @@ static int dcb_read_no_bytes_available(DCB* dcb, int nreadtotal)
     return nreadtotal;
 }
 
+/**
+ * Adapt the size of the next read of a DCB to the outcome of the latest one. The
+ * size is doubled when a read fills its buffer and halved when reads return much
+ * less than what was asked for.
+ *
+ * @param dcb      The DCB that was read from
+ * @param bufsize  The size of the latest read
+ * @param nread    The number of bytes it returned
+ */
+static void dcb_adapt_read_size(DCB* dcb, int bufsize, int nread)
+{
+    if (nread == bufsize)
+    {
+        dcb->read_size = MXS_MIN(MXS_MAX(dcb->read_size, nread) * 2, DCB_MAX_READ_SIZE);
+    }
+    else if (nread < dcb->read_size / 4)
+    {
+        dcb->read_size = MXS_MAX(dcb->read_size / 2, DCB_MIN_READ_SIZE);
+    }
+}
+
 /**
  * Basic read function to carry out a single read operation on the DCB socket.
  *
+ * The data is read directly into a buffer of the requested size. If the read
+ * returns much less than that, the data is moved into a right-sized buffer so
+ * that the large one goes back to the buffer pool of the worker at once,
+ * instead of lingering half-empty in the read queue of the DCB.
+ *
  * @param dcb               The DCB to read from
- * @param bytesavailable    Pointer to linked list to append data to
- * @param maxbytes          Maximum bytes to read (0 = no limit)
- * @param nreadtotal        Total number of bytes already read
+ * @param bufsize           The maximum number of bytes to read
  * @param nsingleread       To be set as the number of bytes read this time
  * @return                  GWBUF* buffer containing new data, or null.
  */
-static GWBUF* dcb_basic_read(DCB* dcb, int bytesavailable, int maxbytes, int nreadtotal, int* nsingleread)
+static GWBUF* dcb_basic_read(DCB* dcb, int bufsize, int* nsingleread)
 {
     GWBUF* buffer;
-    int bufsize = maxbytes == 0 ? bytesavailable : MXS_MIN(bytesavailable, maxbytes - nreadtotal);
 
     if ((buffer = gwbuf_alloc(bufsize)) == NULL)
     {
@@ -713,7 +816,7 @@ static GWBUF* dcb_basic_read(DCB* dcb, int bytesavailable, int maxbytes, int nre
 
         if (*nsingleread <= 0)
         {
-            if (errno != 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+            if (*nsingleread < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
             {
                 MXS_ERROR("Read failed, dcb %p in state %s fd %d: %d, %s",
                           dcb,
@@ -725,6 +828,26 @@ static GWBUF* dcb_basic_read(DCB* dcb, int bytesavailable, int maxbytes, int nre
             gwbuf_free(buffer);
             buffer = NULL;
         }
+        else
+        {
+            dcb_adapt_read_size(dcb, bufsize, *nsingleread);
+
+            if (*nsingleread < bufsize)
+            {
+                GWBUF* trimmed = *nsingleread < bufsize / 2 ?
+                    gwbuf_alloc_and_load(*nsingleread, GWBUF_DATA(buffer)) : NULL;
+
+                if (trimmed)
+                {
+                    gwbuf_free(buffer);
+                    buffer = trimmed;
+                }
+                else
+                {
+                    buffer = gwbuf_rtrim(buffer, bufsize - *nsingleread);
+                }
+            }
+        }
     }
     return buffer;
 }
@@ -1050,6 +1173,7 @@ int dcb_drain_writeq(DCB* dcb)
 
     mxb_assert(dcb->writeqlen >= (uint32_t)total_written);
     dcb->writeqlen -= total_written;
+    dcb->stats.n_written += total_written;
 
     if (dcb->high_water_reached && DCB_BELOW_LOW_WATER(dcb))
     {
@@ -1272,6 +1396,18 @@ void dcb_final_close(DCB* dcb)
                 MXS_DEBUG("Closed socket %d on dcb %p.", dcb->fd, dcb);
             }
 
+            if (dcb->reuseport_fds)
+            {
+                // The socket of the first worker is the one in dcb->fd.
+                for (int i = 1; i < config_threadcount(); ++i)
+                {
+                    close(dcb->reuseport_fds[i]);
+                }
+
+                MXS_FREE(dcb->reuseport_fds);
+                dcb->reuseport_fds = NULL;
+            }
+
             if (dcb->path && (dcb->dcb_role == DCB_ROLE_SERVICE_LISTENER))
             {
                 if (unlink(dcb->path) != 0)
@@ -1307,7 +1443,7 @@ static bool dcb_maybe_add_persistent(DCB* dcb)
         && strlen(dcb->user)
         && dcb->server
         && dcb->session
-        && session_valid_for_pool(dcb->session)
+        && ((dcb->flags & DCBF_IDLE) || session_valid_for_pool(dcb->session))
         && dcb->server->persistpoolmax
         && (dcb->server->status & SERVER_RUNNING)
         && !dcb->dcb_errhandle_called
@@ -1413,8 +1549,12 @@ void printDCB(DCB* dcb)
     printf("\tStatistics:\n");
     printf("\t\tNo. of Reads:                       %d\n",
            dcb->stats.n_reads);
+    printf("\t\tNo. of FIONREADs:                   %d\n",
+           dcb->stats.n_ioctls);
     printf("\t\tNo. of Writes:                      %d\n",
            dcb->stats.n_writes);
+    printf("\t\tBytes per Write:                    %ld\n",
+           dcb->stats.n_writes ? dcb->stats.n_written / dcb->stats.n_writes : 0);
     printf("\t\tNo. of Buffered Writes:             %d\n",
            dcb->stats.n_buffered);
     printf("\t\tNo. of Accepts:                     %d\n",
@@ -1525,7 +1665,10 @@ void dprintOneDCB(DCB* pdcb, DCB* dcb)
     }
     dcb_printf(pdcb, "\tStatistics:\n");
     dcb_printf(pdcb, "\t\tNo. of Reads:             %d\n", dcb->stats.n_reads);
+    dcb_printf(pdcb, "\t\tNo. of FIONREADs:         %d\n", dcb->stats.n_ioctls);
     dcb_printf(pdcb, "\t\tNo. of Writes:            %d\n", dcb->stats.n_writes);
+    dcb_printf(pdcb, "\t\tBytes per Write:          %ld\n",
+               dcb->stats.n_writes ? dcb->stats.n_written / dcb->stats.n_writes : 0);
     dcb_printf(pdcb, "\t\tNo. of Buffered Writes:   %d\n", dcb->stats.n_buffered);
     dcb_printf(pdcb, "\t\tNo. of Accepts:           %d\n", dcb->stats.n_accepts);
     dcb_printf(pdcb, "\t\tNo. of High Water Events: %d\n", dcb->stats.n_high_water);
@@ -1781,7 +1924,8 @@ void dcb_printf(DCB* dcb, const char* fmt, ...)
 /**
  * Write data to a DCB socket through an SSL structure. The SSL structure is
  * linked from the DCB. All communication is encrypted and done via the SSL
- * structure. Data is written from the DCB write queue.
+ * structure. Data is written from the DCB write queue. Small buffers at the
+ * head of the queue are copied together into one TLS record.
  *
  * @param dcb           The DCB having an SSL connection
  * @param writeq        A buffer list containing the data to be written
@@ -1790,9 +1934,24 @@ void dcb_printf(DCB* dcb, const char* fmt, ...)
  */
 static int gw_write_SSL(DCB* dcb, GWBUF* writeq, bool* stop_writing)
 {
-    int written;
+    /**
+     * The largest amount of data that fits in one TLS record. Buffers smaller
+     * than this are copied together so that each SSL_write() fills a record.
+     */
+    static const size_t SSL_COALESCE_SIZE = 16384;
+    static thread_local uint8_t coalesced[SSL_COALESCE_SIZE];
+
+    const void* data = GWBUF_DATA(writeq);
+    size_t len = GWBUF_LENGTH(writeq);
+
+    if (len < SSL_COALESCE_SIZE && writeq->next)
+    {
+        len = gwbuf_copy_data(writeq, 0, SSL_COALESCE_SIZE, coalesced);
+        data = coalesced;
+    }
 
-    written = SSL_write(dcb->ssl, GWBUF_DATA(writeq), GWBUF_LENGTH(writeq));
+    int written = SSL_write(dcb->ssl, data, len);
+    dcb->stats.n_writes++;
 
     *stop_writing = false;
     switch ((SSL_get_error(dcb->ssl, written)))
@@ -1845,7 +2004,8 @@ static int gw_write_SSL(DCB* dcb, GWBUF* writeq, bool* stop_writing)
 }
 
 /**
- * Write data to a DCB. The data is taken from the DCB's write queue.
+ * Write data to a DCB. The data is taken from the DCB's write queue and as
+ * many buffers of the list as possible are written with a single writev().
  *
  * @param dcb           The DCB to write buffer
  * @param writeq        A buffer list containing the data to be written
@@ -1854,17 +2014,37 @@ static int gw_write_SSL(DCB* dcb, GWBUF* writeq, bool* stop_writing)
  */
 static int gw_write(DCB* dcb, GWBUF* writeq, bool* stop_writing)
 {
+    /** Limits the total so that the number of bytes written fits in an int */
+    static const size_t MAX_WRITEV_BYTES = INT_MAX / 2;
+
     int written = 0;
     int fd = dcb->fd;
-    size_t nbytes = GWBUF_LENGTH(writeq);
-    void* buf = GWBUF_DATA(writeq);
     int saved_errno;
 
+    // Gather as much of the buffer chain as possible into one system call.
+    struct iovec iov[IOV_MAX];
+    int niov = 0;
+    size_t nbytes = 0;
+
+    for (GWBUF* buf = writeq; buf && niov < IOV_MAX && nbytes < MAX_WRITEV_BYTES; buf = buf->next)
+    {
+        size_t len = MXS_MIN(GWBUF_LENGTH(buf), MAX_WRITEV_BYTES - nbytes);
+
+        if (len > 0)
+        {
+            iov[niov].iov_base = GWBUF_DATA(buf);
+            iov[niov].iov_len = len;
+            ++niov;
+            nbytes += len;
+        }
+    }
+
     errno = 0;
 
     if (fd > 0)
     {
-        written = write(fd, buf, nbytes);
+        written = writev(fd, iov, niov);
+        dcb->stats.n_writes++;
     }
 
     saved_errno = errno;
@@ -2211,9 +2391,48 @@ static int dcb_create_SSL(DCB* dcb, SSL_LISTENER* ssl)
         return -1;
     }
 
+    // Small buffers are coalesced into a per-thread buffer before being written,
+    // so a retried write may not use the same buffer as the original one.
+    SSL_set_mode(dcb->ssl, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+
     return 0;
 }
 
+/**
+ * Create the SSL structure for a connection to a server. The latest session
+ * with the server is resumed, if there is one, to avoid a full handshake.
+ *
+ * @param dcb  Backend DCB
+ * @param ssl  The SSL configuration of the server
+ * @return     -1 on error, 0 otherwise.
+ */
+static int dcb_create_client_SSL(DCB* dcb, SSL_LISTENER* ssl)
+{
+    int rval = dcb_create_SSL(dcb, ssl);
+
+    if (rval == 0)
+    {
+        SSL_LISTENER_resume_session(ssl, dcb->ssl);
+    }
+
+    return rval;
+}
+
+/**
+ * @return A description of how the SSL connection was established, for logging
+ */
+static const char* dcb_SSL_established_info(DCB* dcb)
+{
+    bool resumed = SSL_session_reused(dcb->ssl);
+    bool ktls = false;
+
+#ifdef SSL_OP_ENABLE_KTLS
+    ktls = BIO_get_ktls_send(SSL_get_wbio(dcb->ssl));
+#endif
+
+    return resumed ? (ktls ? " (resumed, kTLS)" : " (resumed)") : (ktls ? " (kTLS)" : "");
+}
+
 /**
  * Accept a SSL connection and do the SSL authentication handshake.
  * This function accepts a client connection to a DCB. It assumes that the SSL
@@ -2242,6 +2461,9 @@ int dcb_accept_SSL(DCB* dcb)
     {
     case SSL_ERROR_NONE:
         MXS_DEBUG("SSL_accept done for %s@%s", user, remote);
+        MXS_INFO("TLS handshake with client %s done%s.",
+                 dcb->remote ? dcb->remote : "",
+                 dcb_SSL_established_info(dcb));
         dcb->ssl_state = SSL_ESTABLISHED;
         dcb->ssl_read_want_write = false;
         return 1;
@@ -2305,7 +2527,7 @@ int dcb_connect_SSL(DCB* dcb)
     int return_code;
 
     if ((NULL == dcb->server || NULL == dcb->server->server_ssl)
-        || (NULL == dcb->ssl && dcb_create_SSL(dcb, dcb->server->server_ssl) != 0))
+        || (NULL == dcb->ssl && dcb_create_client_SSL(dcb, dcb->server->server_ssl) != 0))
     {
         mxb_assert((NULL != dcb->server) && (NULL != dcb->server->server_ssl));
         return -1;
@@ -2316,6 +2538,7 @@ int dcb_connect_SSL(DCB* dcb)
     {
     case SSL_ERROR_NONE:
         MXS_DEBUG("SSL_connect done for %s", dcb->remote);
+        MXS_INFO("TLS handshake with server '%s' done%s.", dcb->server->name, dcb_SSL_established_info(dcb));
         dcb->ssl_state = SSL_ESTABLISHED;
         dcb->ssl_read_want_write = false;
         return_code = 1;
@@ -2488,7 +2711,8 @@ DCB* dcb_accept(DCB* dcb)
             }
 
             if (client_dcb->service->max_connections
-                && client_dcb->service->client_count >= client_dcb->service->max_connections)
+                && client_dcb->service->client_count - client_dcb->service->internal_count
+                >= client_dcb->service->max_connections)
             {
                 // TODO: If connections can be queued, this is the place to put the
                 // TODO: connection on that queue.
@@ -2524,6 +2748,16 @@ DCB* dcb_accept(DCB* dcb)
 static int dcb_accept_one_connection(DCB* dcb, struct sockaddr* client_conn)
 {
     int c_sock;
+    int listener_fd = dcb->fd;
+
+    if (dcb->reuseport_fds)
+    {
+        // Accept only from the socket of this worker, the kernel has put the
+        // connections of the other workers into the queues of their sockets.
+        int id = RoutingWorker::get_current_id();
+        mxb_assert(id >= 0 && id < config_threadcount());
+        listener_fd = dcb->reuseport_fds[id];
+    }
 
     /* Try up to 10 times to get a file descriptor by use of accept */
     for (int i = 0; i < 10; i++)
@@ -2532,7 +2766,7 @@ static int dcb_accept_one_connection(DCB* dcb, struct sockaddr* client_conn)
         int eno = 0;
 
         /* new connection from client */
-        c_sock = accept(dcb->fd,
+        c_sock = accept(listener_fd,
                         client_conn,
                         &client_len);
         eno = errno;
@@ -2620,9 +2854,14 @@ int dcb_listen(DCB* dcb, const char* config, const char* protocol_name)
     }
 
     int listener_socket = -1;
+    bool reuseport = RoutingWorker::get_listener_mode() != RoutingWorker::LISTENER_SHARED
+        && config_threadcount() > 1;
 
     if (strchr(host, '/'))
     {
+        // The connections of a Unix domain socket are not distributed by the
+        // kernel, so it is always shared by the workers.
+        reuseport = false;
         listener_socket = dcb_listen_create_socket_unix(host);
 
         if (listener_socket != -1)
@@ -2632,7 +2871,8 @@ int dcb_listen(DCB* dcb, const char* config, const char* protocol_name)
     }
     else if (port > 0)
     {
-        listener_socket = dcb_listen_create_socket_inet(host, port);
+        enum mxs_socket_type type = reuseport ? MXS_SOCKET_LISTENER_REUSEPORT : MXS_SOCKET_LISTENER;
+        listener_socket = dcb_listen_create_socket_inet(host, port, type);
 
         if (listener_socket == -1 && strcmp(host, "::") == 0)
         {
@@ -2640,7 +2880,7 @@ int dcb_listen(DCB* dcb, const char* config, const char* protocol_name)
             MXS_WARNING("Failed to bind on default IPv6 host '::', attempting "
                         "to bind on IPv4 version '0.0.0.0'");
             strcpy(host, "0.0.0.0");
-            listener_socket = dcb_listen_create_socket_inet(host, port);
+            listener_socket = dcb_listen_create_socket_inet(host, port, type);
         }
     }
     else
@@ -2674,7 +2914,21 @@ int dcb_listen(DCB* dcb, const char* config, const char* protocol_name)
         return -1;
     }
 
-    MXS_NOTICE("Listening for connections at [%s]:%u with protocol %s", host, port, protocol_name);
+    if (reuseport)
+    {
+        if (!dcb_listen_create_reuseport_group(dcb, listener_socket, host, port))
+        {
+            close(listener_socket);
+            return -1;
+        }
+
+        MXS_NOTICE("Listening for connections at [%s]:%u with protocol %s, using a socket per thread",
+                   host, port, protocol_name);
+    }
+    else
+    {
+        MXS_NOTICE("Listening for connections at [%s]:%u with protocol %s", host, port, protocol_name);
+    }
 
     // assign listener_socket to dcb
     dcb->fd = listener_socket;
@@ -2694,12 +2948,149 @@ int dcb_listen(DCB* dcb, const char* config, const char* protocol_name)
  *
  * @param host The network address to listen on
  * @param port The port to listen on
+ * @param type MXS_SOCKET_LISTENER or MXS_SOCKET_LISTENER_REUSEPORT
  * @return     The opened socket or -1 on error
  */
-static int dcb_listen_create_socket_inet(const char* host, uint16_t port)
+static int dcb_listen_create_socket_inet(const char* host, uint16_t port, enum mxs_socket_type type)
 {
     struct sockaddr_storage server_address = {};
-    return open_network_socket(MXS_SOCKET_LISTENER, &server_address, host, port);
+    return open_network_socket(type, &server_address, host, port);
+}
+
+/**
+ * @brief Make the kernel pick the socket of a new connection by CPU
+ *
+ * Attaches a classic BPF program to the SO_REUSEPORT group of the socket. If
+ * the workers are bound to CPUs, the program looks up the CPU that processes
+ * the packet in the map of the CPUs to the workers, so that the connection is
+ * accepted by the worker bound to that CPU or by one on the same NUMA node.
+ * Otherwise, it returns the CPU modulo the number of sockets, so that the
+ * connection is accepted by the worker with the same index as the CPU.
+ *
+ * @param fd       A socket of the group
+ * @param nSockets The number of sockets in the group
+ * @return         True, if the program could be attached
+ */
+static bool dcb_listen_attach_cpu_steering(int fd, int nSockets)
+{
+    bool rv = false;
+
+#ifdef SO_ATTACH_REUSEPORT_CBPF
+    std::vector<int> map = RoutingWorker::get_cpu_map();
+
+    if (2 * map.size() + 3 > BPF_MAXINSNS)
+    {
+        map.clear();
+    }
+
+    std::vector<struct sock_filter> code;
+    code.push_back({BPF_LD | BPF_W | BPF_ABS, 0, 0, (uint32_t)(SKF_AD_OFF + SKF_AD_CPU)});
+
+    for (size_t cpu = 0; cpu < map.size(); ++cpu)
+    {
+        code.push_back({BPF_JMP | BPF_JEQ | BPF_K, 0, 1, (uint32_t)cpu});
+        code.push_back({BPF_RET | BPF_K, 0, 0, (uint32_t)map[cpu]});
+    }
+
+    code.push_back({BPF_ALU | BPF_MOD | BPF_K, 0, 0, (uint32_t)nSockets});
+    code.push_back({BPF_RET | BPF_A, 0, 0, 0});
+
+    struct sock_fprog prog = {};
+    prog.len = code.size();
+    prog.filter = code.data();
+
+    if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)) == 0)
+    {
+        rv = true;
+    }
+    else
+    {
+        MXS_WARNING("Failed to attach the CPU steering program to the listener sockets, "
+                    "the connections are distributed by hash: %d, %s",
+                    errno,
+                    mxs_strerror(errno));
+    }
+#else
+    MXS_WARNING("MaxScale was built without support for SO_ATTACH_REUSEPORT_CBPF, "
+                "the connections are distributed by hash.");
+#endif
+
+    return rv;
+}
+
+/**
+ * @brief Open the listener sockets of the other workers
+ *
+ * In the reuseport listener modes, each routing worker has a socket of its
+ * own, bound to the same address with SO_REUSEPORT. The kernel puts each new
+ * connection into the accept queue of one of the sockets and the worker
+ * owning the socket is the only one woken up.
+ *
+ * @param dcb   The listener DCB
+ * @param first The listening socket of the first worker
+ * @param host  The network address to listen on
+ * @param port  The port to listen on
+ * @return      True, if each worker has a listening socket. Otherwise false
+ *              and only @c first is left open.
+ */
+static bool dcb_listen_create_reuseport_group(DCB* dcb, int first, const char* host, uint16_t port)
+{
+    int nWorkers = config_threadcount();
+    int* fds = (int*)MXS_CALLOC(nWorkers, sizeof(int));
+    bool rv = fds != NULL;
+    int n = 0;
+
+    if (rv)
+    {
+        fds[n++] = first;
+
+        while (rv && n < nWorkers)
+        {
+            int fd = dcb_listen_create_socket_inet(host, port, MXS_SOCKET_LISTENER_REUSEPORT);
+
+            if (fd == -1)
+            {
+                rv = false;
+            }
+            else if (listen(fd, INT_MAX) != 0)
+            {
+                MXS_ERROR("Failed to start listening on [%s]:%u: %d, %s",
+                          host,
+                          port,
+                          errno,
+                          mxs_strerror(errno));
+                close(fd);
+                rv = false;
+            }
+            else
+            {
+                fds[n++] = fd;
+            }
+        }
+    }
+
+    if (rv)
+    {
+        // The sockets join the group in the order they start listening, which
+        // is the order of the worker ids.
+        if (RoutingWorker::get_listener_mode() == RoutingWorker::LISTENER_REUSEPORT_CPU)
+        {
+            dcb_listen_attach_cpu_steering(first, nWorkers);
+        }
+
+        dcb->reuseport_fds = fds;
+    }
+    else if (fds)
+    {
+        for (int i = 1; i < n; ++i)
+        {
+            close(fds[i]);
+        }
+
+        MXS_FREE(fds);
+    }
+
+    return rv;
 }
 
 /**
@@ -2828,6 +3219,11 @@ static void dcb_add_to_list(DCB* dcb)
             this_unit.all_dcbs[id]->thread.tail->thread.next = dcb;
             this_unit.all_dcbs[id]->thread.tail = dcb;
         }
+
+        if (dcb->dcb_role == DCB_ROLE_CLIENT_HANDLER && this_unit.check_timeouts)
+        {
+            dcb_schedule_idle_timeout(dcb, id);
+        }
     }
 }
 
@@ -2840,6 +3236,8 @@ static void dcb_remove_from_list(DCB* dcb)
 {
     int id = static_cast<RoutingWorker*>(dcb->poll.owner)->id();
 
+    this_unit.idle_timers[id].remove(&dcb->idle_timer);
+
     if (dcb == this_unit.all_dcbs[id])
     {
         DCB* tail = this_unit.all_dcbs[id]->thread.tail;
@@ -2882,12 +3280,39 @@ static void dcb_remove_from_list(DCB* dcb)
 
 /**
  * Enable the timing out of idle connections.
+ *
+ * Called whenever the connection timeout of a service is set, so that the
+ * workers reschedule the idle timeouts of their clients.
  */
 void dcb_enable_session_timeouts()
 {
+    mxb::atomic::add(&this_unit.timeouts_version, 1, mxb::atomic::RELAXED);
     this_unit.check_timeouts = true;
 }
 
+/**
+ * Schedule the idle timeout of a client DCB, if its service has a connection
+ * timeout. The timeout is scheduled at the time the DCB would time out if it
+ * does not read anything more and is checked and rescheduled when it expires,
+ * so reads do not need to touch the timer.
+ *
+ * @param dcb  A client DCB
+ * @param thr  The id of the owning worker
+ */
+static void dcb_schedule_idle_timeout(DCB* dcb, int thr)
+{
+    mxb_assert(dcb->listener);
+    SERVICE* service = dcb->listener->service;
+    mxb::TimingWheel& idle_timers = this_unit.idle_timers[thr];
+
+    idle_timers.remove(&dcb->idle_timer);
+
+    if (service->conn_idle_timeout)
+    {
+        idle_timers.add(&dcb->idle_timer, dcb->last_read + service->conn_idle_timeout * 10);
+    }
+}
+
 /**
  * Close sessions that have been idle for too long.
  *
@@ -2902,29 +3327,56 @@ void dcb_process_idle_sessions(int thr)
          * check for it once per second. One heartbeat is 100 milliseconds. */
         this_thread.next_timeout_check = mxs_clock() + 10;
 
-        for (DCB* dcb = this_unit.all_dcbs[thr]; dcb; dcb = dcb->thread.next)
+        int version = mxb::atomic::load(&this_unit.timeouts_version, mxb::atomic::RELAXED);
+
+        if (this_thread.timeouts_version != version)
         {
-            if (dcb->dcb_role == DCB_ROLE_CLIENT_HANDLER)
-            {
-                mxb_assert(dcb->listener);
-                SERVICE* service = dcb->listener->service;
+            // A connection timeout has been changed, so all clients are rescheduled.
+            this_thread.timeouts_version = version;
 
-                if (service->conn_idle_timeout && dcb->state == DCB_STATE_POLLING)
+            for (DCB* dcb = this_unit.all_dcbs[thr]; dcb; dcb = dcb->thread.next)
+            {
+                if (dcb->dcb_role == DCB_ROLE_CLIENT_HANDLER)
                 {
-                    int64_t idle = mxs_clock() - dcb->last_read;
-                    int64_t timeout = service->conn_idle_timeout * 10;
+                    dcb_schedule_idle_timeout(dcb, thr);
+                }
+            }
+        }
 
-                    if (idle > timeout)
-                    {
-                        MXS_WARNING("Timing out '%s'@%s, idle for %.1f seconds",
-                                    dcb->user ? dcb->user : "<unknown>",
-                                    dcb->remote ? dcb->remote : "<unknown>",
-                                    (float)idle / 10.f);
-                        dcb->session->close_reason = SESSION_CLOSE_TIMEOUT;
-                        poll_fake_hangup_event(dcb);
-                    }
+        int64_t now = mxs_clock();
+        MXB_TIMER* pTimer;
+
+        while ((pTimer = this_unit.idle_timers[thr].expire(now)) != NULL)
+        {
+            DCB* dcb = reinterpret_cast<DCB*>(reinterpret_cast<char*>(pTimer) - offsetof(DCB, idle_timer));
+            mxb_assert(dcb->dcb_role == DCB_ROLE_CLIENT_HANDLER);
+            SERVICE* service = dcb->listener->service;
+
+            if (service->conn_idle_timeout && dcb->state == DCB_STATE_POLLING)
+            {
+                int64_t idle = now - dcb->last_read;
+                int64_t timeout = service->conn_idle_timeout * 10;
+
+                if (idle > timeout)
+                {
+                    MXS_WARNING("Timing out '%s'@%s, idle for %.1f seconds",
+                                dcb->user ? dcb->user : "<unknown>",
+                                dcb->remote ? dcb->remote : "<unknown>",
+                                (float)idle / 10.f);
+                    dcb->session->close_reason = SESSION_CLOSE_TIMEOUT;
+                    poll_fake_hangup_event(dcb);
+                }
+                else
+                {
+                    // The client has read something since the timeout was scheduled.
+                    dcb_schedule_idle_timeout(dcb, thr);
                 }
             }
+            else if (service->conn_idle_timeout && dcb->state == DCB_STATE_NOPOLLING)
+            {
+                // Throttled, check again in a second.
+                this_unit.idle_timers[thr].add(&dcb->idle_timer, now + 10);
+            }
         }
     }
 }
@@ -3450,12 +3902,19 @@ private:
 };
 }
 
-static bool add_fd_to_routing_workers(int fd, uint32_t events, MXB_POLL_DATA* data)
+static bool add_fd_to_routing_workers(int fd, const int* reuseport_fds, uint32_t events, MXB_POLL_DATA* data)
 {
     bool rv = true;
     MXB_WORKER* previous_owner = data->owner;
 
-    rv = RoutingWorker::add_shared_fd(fd, events, data);
+    if (reuseport_fds)
+    {
+        rv = RoutingWorker::add_reuseport_fds(reuseport_fds, events, data);
+    }
+    else
+    {
+        rv = RoutingWorker::add_shared_fd(fd, events, data);
+    }
 
     if (rv)
     {
@@ -3491,7 +3950,7 @@ static bool dcb_add_to_worker(Worker* worker, DCB* dcb, uint32_t events)
         mxb_assert(dcb->dcb_role == DCB_ROLE_SERVICE_LISTENER);
 
         // A listening DCB, we add it immediately.
-        if (add_fd_to_routing_workers(dcb->fd, events, (MXB_POLL_DATA*)dcb))
+        if (add_fd_to_routing_workers(dcb->fd, dcb->reuseport_fds, events, (MXB_POLL_DATA*)dcb))
         {
             // If this takes place on the main thread (all listening DCBs are
             // stored on the main thread)...
@@ -3682,7 +4141,9 @@ int poll_remove_dcb(DCB* dcb)
 
         if (dcb->dcb_role == DCB_ROLE_SERVICE_LISTENER)
         {
-            if (RoutingWorker::remove_shared_fd(dcbfd))
+            if (dcb->reuseport_fds ?
+                RoutingWorker::remove_reuseport_fds(dcb->reuseport_fds) :
+                RoutingWorker::remove_shared_fd(dcbfd))
             {
                 rc = 0;
             }
@@ -747,14 +747,18 @@ static bool init_log()
                 errno,
                 strerror(errno));
     }
-    else if (mxs_log_init(NULL, get_logdir(), cnf->log_target))
+    else
     {
+        mxs_log_set_async(&cnf->log_async);
 
-        mxs_log_set_syslog_enabled(cnf->syslog);
-        mxs_log_set_maxlog_enabled(cnf->maxlog);
+        if (mxs_log_init(NULL, get_logdir(), cnf->log_target))
+        {
+            mxs_log_set_syslog_enabled(cnf->syslog);
+            mxs_log_set_maxlog_enabled(cnf->maxlog);
 
-        atexit(mxs_log_finish);
-        rval = true;
+            atexit(mxs_log_finish);
+            rval = true;
+        }
     }
 
     return rval;
@@ -2856,6 +2860,46 @@ static int cnf_preparser(void* data, const char* section, const char* name, cons
                     "and will be ignored\n",
                     CN_LOG_TO_SHM);
         }
+        else if (strcmp(name, CN_LOG_ASYNC) == 0)
+        {
+            cnf->log_async.enabled = config_truth_value(value);
+        }
+        else if (strcmp(name, CN_LOG_ASYNC_BUFFER_SIZE) == 0)
+        {
+            uint64_t size;
+
+            if (get_suffixed_size(value, &size) && size > 0)
+            {
+                cnf->log_async.buffer_size = size;
+            }
+            else
+            {
+                fprintf(stderr,
+                        "Error: Invalid value for '%s': %s\n",
+                        CN_LOG_ASYNC_BUFFER_SIZE,
+                        value);
+                return 0;
+            }
+        }
+        else if (strcmp(name, CN_LOG_ASYNC_OVERFLOW) == 0)
+        {
+            if (strcmp(value, "drop") == 0)
+            {
+                cnf->log_async.overflow = MXB_LOG_OVERFLOW_DROP;
+            }
+            else if (strcmp(value, "block") == 0)
+            {
+                cnf->log_async.overflow = MXB_LOG_OVERFLOW_BLOCK;
+            }
+            else
+            {
+                fprintf(stderr,
+                        "Error: Invalid value for '%s': %s. Valid values are 'drop' and 'block'.\n",
+                        CN_LOG_ASYNC_OVERFLOW,
+                        value);
+                return 0;
+            }
+        }
         else if (strcmp(name, CN_SUBSTITUTE_VARIABLES) == 0)
         {
             cnf->substitute_variables = config_truth_value(value);
@@ -46,6 +46,15 @@ uint32_t qc_get_trx_type_mask_using(GWBUF* stmt, qc_trx_parse_using_t use);
  */
 std::unique_ptr<json_t> qc_as_json(const char* zHost);
 
+/**
+ * Cache statistics as JSON.
+ *
+ * @param stats  The statistics of the cache of one worker.
+ *
+ * @return A json object containing the statistics.
+ */
+json_t* qc_cache_stats_to_json(const QC_CACHE_STATS& stats);
+
 /**
  * Alter common query classifier properties.
  *
@@ -18,6 +18,7 @@
 
 #include <maxbase/ccdefs.hh>
 
+#include <map>
 #include <mutex>
 
 #include <maxbase/average.hh>
@@ -51,8 +52,25 @@ public:
 
     mutable std::mutex m_lock;
 
+    /** The replication position of the server, the sequence number of each domain */
+    using GtidPos = std::map<uint32_t, uint64_t>;
+
+    mutable std::mutex m_gtid_lock;
+    GtidPos            m_gtid_pos;
+
 private:
     maxbase::EMAverage m_response_time;
 };
 
 void server_free(Server* server);
+
+/**
+ * Maintain the persistent connection pools of the current routing worker
+ *
+ * Opens connections to the servers whose pool has fewer connections than the
+ * configured minimum and pings the idle connections of those pools. Does the
+ * work at most once a second, so it can be called on every tick.
+ *
+ * @param id  The id of the current routing worker
+ */
+void server_process_persistent_pools(int id);
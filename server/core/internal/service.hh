@@ -260,6 +260,20 @@ bool service_isvalid(Service* service);
  */
 bool service_server_in_use(const SERVER* server);
 
+/**
+ * Find a service that uses a server and reserve it for an internal session
+ *
+ * The client count of the service is incremented so that the service is not
+ * destroyed before the session created for it has been freed. The internal
+ * count is incremented as well, so that the session is not counted against
+ * max_connections. The caller decrements the internal count when it closes the
+ * session.
+ *
+ * @param server Server that is queried
+ * @return A service that uses the server or NULL if no active service uses it
+ */
+Service* service_reserve_for_server(const SERVER* server);
+
 /**
  * Check if filter is used by any service
  *
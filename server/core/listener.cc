@@ -33,6 +33,7 @@
 #include <fcntl.h>
 #include <string>
 
+#include <maxbase/atomic.hh>
 #include <maxscale/listener.h>
 #include <maxscale/paths.h>
 #include <maxscale/ssl.h>
@@ -271,6 +272,53 @@ static const char* get_ssl_errors()
     return ssl_errbuf->c_str();
 }
 
+static const unsigned char SESSION_ID_CONTEXT[] = "MaxScale";
+
+/**
+ * Called by OpenSSL when a new session is established or a session ticket is
+ * received. The sessions received from servers are stored for resumption.
+ *
+ * @return 1 if a reference to the session was taken, 0 otherwise
+ */
+static int new_session_callback(SSL* ssl_conn, SSL_SESSION* session)
+{
+    int rval = 0;
+
+    if (!SSL_is_server(ssl_conn))
+    {
+        SSL_LISTENER* ssl = (SSL_LISTENER*)SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl_conn));
+        SSL_SESSION* old = mxb::atomic::exchange(&ssl->session, session);
+
+        if (old)
+        {
+            SSL_SESSION_free(old);
+        }
+
+        rval = 1;
+    }
+
+    return rval;
+}
+
+void SSL_LISTENER_resume_session(SSL_LISTENER* ssl, SSL* ssl_conn)
+{
+    // The session is taken out while it is used so that it cannot be freed
+    // by a concurrent update. A newer session, if one was stored meanwhile,
+    // is replaced when the session is put back.
+    SSL_SESSION* session = mxb::atomic::exchange(&ssl->session, (SSL_SESSION*)NULL);
+
+    if (session)
+    {
+        SSL_set_session(ssl_conn, session);
+        SSL_SESSION* other = mxb::atomic::exchange(&ssl->session, session);
+
+        if (other)
+        {
+            SSL_SESSION_free(other);
+        }
+    }
+}
+
 bool SSL_LISTENER_init(SSL_LISTENER* ssl)
 {
     mxb_assert(!ssl->ssl_init_done);
@@ -328,8 +376,19 @@ bool SSL_LISTENER_init(SSL_LISTENER* ssl)
     /** Disable SSLv3 */
     SSL_CTX_set_options(ctx, SSL_OP_NO_SSLv3);
 
-    // Disable session cache
-    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+    // Cache the sessions of the clients so that a reconnecting client can resume its
+    // session with a session ID or a ticket instead of doing a full handshake. The
+    // sessions received from servers are passed to new_session_callback.
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_BOTH);
+    SSL_CTX_set_session_id_context(ctx, SESSION_ID_CONTEXT, sizeof(SESSION_ID_CONTEXT) - 1);
+    SSL_CTX_sess_set_new_cb(ctx, new_session_callback);
+    SSL_CTX_set_app_data(ctx, ssl);
+
+#ifdef SSL_OP_ENABLE_KTLS
+    // Let the kernel encrypt and decrypt the records once the handshake is done, if
+    // it supports the negotiated cipher. OpenSSL falls back to doing it by itself.
+    SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS);
+#endif
 
     //
     // Note: This is not safe if SSL initialization is done concurrently
@@ -411,6 +470,12 @@ void SSL_LISTENER_free(SSL_LISTENER* ssl)
     if (ssl)
     {
         SSL_CTX_free(ssl->ctx);
+
+        if (ssl->session)
+        {
+            SSL_SESSION_free(ssl->session);
+        }
+
         MXS_FREE(ssl->ssl_ca_cert);
         MXS_FREE(ssl->ssl_cert);
         MXS_FREE(ssl->ssl_key);
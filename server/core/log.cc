@@ -117,11 +117,31 @@ json_t* mxs_logs_to_json(const char* host)
     json_object_set_new(param, "log_debug", json_boolean(mxb_log_is_priority_enabled(LOG_DEBUG)));
     json_object_set_new(param, "log_to_shm", json_boolean(false));
 
+    MXB_LOG_ASYNC async;
+    mxb_log_get_async(&async);
+    json_object_set_new(param, CN_LOG_ASYNC, json_boolean(async.enabled));
+    json_object_set_new(param, CN_LOG_ASYNC_BUFFER_SIZE, json_integer(async.buffer_size));
+    json_object_set_new(param, CN_LOG_ASYNC_OVERFLOW,
+                        json_string(async.overflow == MXB_LOG_OVERFLOW_BLOCK ? "block" : "drop"));
+
     json_t* attr = json_object();
     json_object_set_new(attr, CN_PARAMETERS, param);
     json_object_set_new(attr, "log_file", json_string(mxb_log_get_filename()));
     json_object_set_new(attr, "log_priorities", get_log_priorities());
 
+    if (async.enabled)
+    {
+        MXB_LOG_ASYNC_STATS stats;
+        mxb_log_get_async_stats(&stats);
+        json_t* async_stats = json_object();
+        json_object_set_new(async_stats, "written", json_integer(stats.written));
+        json_object_set_new(async_stats, "dropped", json_integer(stats.dropped));
+        json_object_set_new(async_stats, "blocked", json_integer(stats.blocked));
+        json_object_set_new(async_stats, "batches", json_integer(stats.batches));
+        json_object_set_new(async_stats, "buffers", json_integer(stats.buffers));
+        json_object_set_new(attr, "async_statistics", async_stats);
+    }
+
     json_t* data = json_object();
     json_object_set_new(data, CN_ATTRIBUTES, attr);
     json_object_set_new(data, CN_ID, json_string("logs"));
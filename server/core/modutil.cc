@@ -23,11 +23,14 @@
 #include <mutex>
 #include <functional>
 #include <cctype>
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include <maxscale/alloc.h>
 #include <maxscale/buffer.h>
 #include <maxscale/buffer.hh>
-#include <maxscale/modutil.h>
+#include <maxscale/modutil.hh>
 #include <maxscale/poll.h>
 #include <maxscale/protocol/mysql.h>
 #include <maxscale/utils.h>
@@ -1250,7 +1253,8 @@ mxs_pcre2_result_t modutil_mysql_wildcard_match(const char* pattern, const char*
     return rval;
 }
 
-static inline bool is_next(mxs::Buffer::iterator it, mxs::Buffer::iterator end, const std::string& str)
+template<class Iterator>
+static inline bool is_next(Iterator it, Iterator end, const std::string& str)
 {
     mxb_assert(it != end);
     for (auto s_it = str.begin(); s_it != str.end(); ++s_it, ++it)
@@ -1307,12 +1311,12 @@ static const LUT is_special([](uint8_t c) {
                                     c) != std::string::npos;
                             });
 
-static std::pair<bool, mxs::Buffer::iterator> probe_number(mxs::Buffer::iterator it,
-                                                           mxs::Buffer::iterator end)
+template<class Iterator>
+static std::pair<bool, Iterator> probe_number(Iterator it, Iterator end)
 {
     mxb_assert(it != end);
     mxb_assert(is_digit(*it));
-    std::pair<bool, mxs::Buffer::iterator> rval = std::make_pair(true, it);
+    std::pair<bool, Iterator> rval = std::make_pair(true, it);
     bool is_hex = *it == '0';
     bool allow_hex = false;
 
@@ -1406,7 +1410,8 @@ static inline bool is_negation(const std::string& str, int i)
     return rval;
 }
 
-mxs::Buffer::iterator find_char(mxs::Buffer::iterator it, const mxs::Buffer::iterator& end, char c)
+template<class Iterator>
+static Iterator find_char(Iterator it, const Iterator& end, char c)
 {
     for (; it != end; ++it)
     {
@@ -1426,30 +1431,180 @@ mxs::Buffer::iterator find_char(mxs::Buffer::iterator it, const mxs::Buffer::ite
     return it;
 }
 
-namespace maxscale
+/**
+ * Whether a character can be copied as such into the canonical form of a
+ * statement, provided the preceding character was also copied as such.
+ *
+ * @param prev  The preceding character.
+ * @param c     The character.
+ *
+ * @return True, if @c c needs no handling beyond being copied.
+ */
+static inline bool is_plain(uint8_t prev, uint8_t c)
 {
+    return !is_special(c)
+           || (is_space(c) && !is_space(prev))
+           || (is_digit(c) && (is_alnum(prev) || prev == '_'));
+}
 
-std::string get_canonical(GWBUF* querybuf)
+#if defined (__SSE2__)
+/**
+ * Return a mask of the bytes of a vector that are within a range.
+ */
+static inline __m128i in_range(__m128i v, uint8_t low, uint8_t high)
+{
+    return _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(low)), v),
+                         _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(high)), v));
+}
+
+/**
+ * Return a mask of the whitespace bytes of a vector, as classified by isspace().
+ */
+static inline __m128i whitespace(__m128i v)
+{
+    return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), in_range(v, '\t', '\r'));
+}
+
+/**
+ * Return a bitmask of the bytes in the 16 bytes starting at @c p that are
+ * not plain, given the preceding byte at @c p[-1] was plain.
+ */
+static inline int non_plain_mask(const uint8_t* p)
+{
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p - 1));
+
+    // Characters that always need special handling.
+    __m128i hard = _mm_cmpeq_epi8(c, _mm_set1_epi8('"'));
+    hard = _mm_or_si128(hard, _mm_cmpeq_epi8(c, _mm_set1_epi8('\'')));
+    hard = _mm_or_si128(hard, _mm_cmpeq_epi8(c, _mm_set1_epi8('`')));
+    hard = _mm_or_si128(hard, _mm_cmpeq_epi8(c, _mm_set1_epi8('#')));
+    hard = _mm_or_si128(hard, _mm_cmpeq_epi8(c, _mm_set1_epi8('-')));
+    hard = _mm_or_si128(hard, _mm_cmpeq_epi8(c, _mm_set1_epi8('/')));
+    hard = _mm_or_si128(hard, _mm_cmpeq_epi8(c, _mm_set1_epi8('\\')));
+
+    // Repeated whitespace is collapsed.
+    __m128i spaces = _mm_and_si128(whitespace(c), whitespace(prev));
+
+    // A digit that does not continue an identifier may start a number.
+    __m128i word = _mm_or_si128(in_range(prev, '0', '9'), in_range(prev, 'a', 'z'));
+    word = _mm_or_si128(word, in_range(prev, 'A', 'Z'));
+    word = _mm_or_si128(word, _mm_cmpeq_epi8(prev, _mm_set1_epi8('_')));
+    __m128i digits = _mm_andnot_si128(word, in_range(c, '0', '9'));
+
+    return _mm_movemask_epi8(_mm_or_si128(hard, _mm_or_si128(spaces, digits)));
+}
+#endif
+
+/**
+ * Find the end of a run of plain characters.
+ *
+ * @param p    The first character after one that was plain.
+ * @param end  The end of the statement.
+ *
+ * @return The first character that is not plain, or @c end.
+ */
+static inline const uint8_t* find_non_plain(const uint8_t* p, const uint8_t* end)
+{
+#if defined (__SSE2__)
+    while (end - p >= 16)
+    {
+        int mask = non_plain_mask(p);
+
+        if (mask)
+        {
+            return p + __builtin_ctz(mask);
+        }
+
+        p += 16;
+    }
+#endif
+
+    while (p != end && is_plain(p[-1], *p))
+    {
+        ++p;
+    }
+
+    return p;
+}
+
+/**
+ * Copy a plain character to the canonical form. With an iterator over
+ * a possibly fragmented buffer, one character is copied at a time.
+ */
+template<class Iterator>
+static inline void copy_plain(Iterator& it, const Iterator& end, std::string& rval, int& i)
+{
+    rval[i++] = *it;
+}
+
+/**
+ * Copy a plain character and the run of plain characters following it to
+ * the canonical form. Leaves @c it at the last character copied.
+ */
+static inline void copy_plain(const uint8_t*& it, const uint8_t* const& end, std::string& rval, int& i)
+{
+    const uint8_t* run_end = find_non_plain(it + 1, end);
+    memcpy(&rval[i], it, run_end - it);
+    i += run_end - it;
+    it = run_end - 1;
+}
+
+/**
+ * Compute the 64-bit fingerprint of a canonical statement.
+ */
+static uint64_t fingerprint(const char* p, size_t len)
+{
+    const uint64_t M = 0x9e3779b97f4a7c15ULL;
+    uint64_t h = len * M;
+
+    for (; len >= 8; p += 8, len -= 8)
+    {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        h = (h ^ word) * M;
+        h ^= h >> 32;
+    }
+
+    if (len)
+    {
+        uint64_t word = 0;
+        memcpy(&word, p, len);
+        h = (h ^ word) * M;
+        h ^= h >> 32;
+    }
+
+    return h;
+}
+
+/**
+ * Canonicalize the SQL of a COM_QUERY or COM_STMT_PREPARE.
+ *
+ * @param it    The first character of the SQL.
+ * @param end   The end of the SQL.
+ * @param rval  Where to store the canonical form, must have been sized
+ *              to hold at least as many characters as there are in the SQL.
+ *
+ * @return The length of the canonical form.
+ */
+template<class Iterator>
+static int canonicalize(Iterator it, Iterator end, std::string& rval)
 {
-    std::string rval;
     int i = 0;
-    rval.resize(gwbuf_length(querybuf) - MYSQL_HEADER_LEN + 1);
-    mxs::Buffer buf(querybuf);
 
-    for (auto it = std::next(buf.begin(), MYSQL_HEADER_LEN + 1);    // Skip packet header and command
-         it != buf.end(); ++it)
+    for (; it != end; ++it)
     {
         if (!is_special(*it))
         {
             // Normal character, no special handling required
-            rval[i++] = *it;
+            copy_plain(it, end, rval, i);
         }
         else if (*it == '\\')
         {
             // Jump over any escaped values
             rval[i++] += *it++;
 
-            if (it != buf.end())
+            if (it != end)
             {
                 rval[i++] = *it;
             }
@@ -1463,19 +1618,19 @@ std::string get_canonical(GWBUF* querybuf)
         {
             // Repeating space, skip it
         }
-        else if (*it == '/' && is_next(it, buf.end(), "/*"))
+        else if (*it == '/' && is_next(it, end, "/*"))
         {
             auto comment_start = std::next(it, 2);
-            if (comment_start == buf.end())
+            if (comment_start == end)
             {
                 break;
             }
             else if (*comment_start != '!' && *comment_start != 'M')
             {
                 // Non-executable comment
-                while (it != buf.end())
+                while (it != end)
                 {
-                    if (is_next(it, buf.end(), "*/"))
+                    if (is_next(it, end, "*/"))
                     {
                         // Comment end marker, return to normal parsing
                         ++it;
@@ -1484,7 +1639,7 @@ std::string get_canonical(GWBUF* querybuf)
                     ++it;
                 }
 
-                if (it == buf.end())
+                if (it == end)
                 {
                     break;
                 }
@@ -1496,10 +1651,10 @@ std::string get_canonical(GWBUF* querybuf)
             }
         }
         else if ((*it == '#' || *it == '-')
-                 && (is_next(it, buf.end(), "# ") || is_next(it, buf.end(), "-- ")))
+                 && (is_next(it, end, "# ") || is_next(it, end, "-- ")))
         {
             // End-of-line comment, jump to the next line if one exists
-            while (it != buf.end())
+            while (it != end)
             {
                 if (*it == '\n')
                 {
@@ -1507,7 +1662,7 @@ std::string get_canonical(GWBUF* querybuf)
                 }
                 else if (*it == '\r')
                 {
-                    if ((is_next(it, buf.end(), "\r\n")))
+                    if ((is_next(it, end, "\r\n")))
                     {
                         ++it;
                     }
@@ -1517,14 +1672,14 @@ std::string get_canonical(GWBUF* querybuf)
                 ++it;
             }
 
-            if (it == buf.end())
+            if (it == end)
             {
                 break;
             }
         }
         else if (is_digit(*it) && (i == 0 || (!is_alnum(rval[i - 1]) && rval[i - 1] != '_')))
         {
-            auto num_end = probe_number(it, buf.end());
+            auto num_end = probe_number(it, end);
 
             if (num_end.first)
             {
@@ -1540,7 +1695,7 @@ std::string get_canonical(GWBUF* querybuf)
         else if (*it == '\'' || *it == '"')
         {
             char c = *it;
-            if ((it = find_char(std::next(it), buf.end(), c)) == buf.end())
+            if ((it = find_char(std::next(it), end, c)) == end)
             {
                 break;
             }
@@ -1549,7 +1704,7 @@ std::string get_canonical(GWBUF* querybuf)
         else if (*it == '`')
         {
             auto start = it;
-            if ((it = find_char(std::next(it), buf.end(), '`')) == buf.end())
+            if ((it = find_char(std::next(it), end, '`')) == end)
             {
                 break;
             }
@@ -1562,13 +1717,44 @@ std::string get_canonical(GWBUF* querybuf)
             rval[i++] = *it;
         }
 
-        mxb_assert(it != buf.end());
+        mxb_assert(it != end);
+    }
+
+    return i;
+}
+
+namespace maxscale
+{
+
+std::string get_canonical(GWBUF* querybuf, uint64_t* pFingerprint)
+{
+    std::string rval;
+    int i = 0;
+    rval.resize(gwbuf_length(querybuf) - MYSQL_HEADER_LEN + 1);
+
+    if (querybuf->next == NULL)
+    {
+        // A contiguous buffer, the plain parts of the SQL are copied in runs.
+        const uint8_t* pData = GWBUF_DATA(querybuf);
+        i = canonicalize(pData + MYSQL_HEADER_LEN + 1, pData + GWBUF_LENGTH(querybuf), rval);
+    }
+    else
+    {
+        mxs::Buffer buf(querybuf);
+
+        // Skip packet header and command
+        i = canonicalize(std::next(buf.begin(), MYSQL_HEADER_LEN + 1), buf.end(), rval);
+
+        buf.release();
     }
 
     // Shrink the buffer so that the internal bookkeeping of std::string remains up to date
     rval.resize(i);
 
-    buf.release();
+    if (pFingerprint)
+    {
+        *pFingerprint = fingerprint(rval.data(), rval.size());
+    }
 
     return rval;
 }
@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <chrono>
+#include <map>
 #include <string>
 #include <sstream>
 #include <set>
@@ -73,6 +74,7 @@ const char CN_BACKEND_CONNECT_ATTEMPTS[] = "backend_connect_attempts";
 const char CN_BACKEND_CONNECT_TIMEOUT[] = "backend_connect_timeout";
 const char CN_BACKEND_READ_TIMEOUT[] = "backend_read_timeout";
 const char CN_BACKEND_WRITE_TIMEOUT[] = "backend_write_timeout";
+const char CN_CONCURRENT_PROBING[] = "concurrent_probing";
 const char CN_DISK_SPACE_CHECK_INTERVAL[] = "disk_space_check_interval";
 const char CN_EVENTS[] = "events";
 const char CN_JOURNAL_MAX_AGE[] = "journal_max_age";
@@ -142,6 +144,7 @@ MXS_MONITOR* monitor_create(const char* name, const char* module, MXS_CONFIG_PAR
     mon->events = config_get_enum(params, CN_EVENTS, mxs_monitor_event_enum_values);
     mon->check_maintenance_flag = MAINTENANCE_FLAG_NOCHECK;
     mon->ticks = 0;
+    mon->concurrent_probing = config_get_bool(params, CN_CONCURRENT_PROBING);
     mon->parameters = NULL;
     memset(mon->journal_hash, 0, sizeof(mon->journal_hash));
     mon->disk_space_threshold = NULL;
@@ -386,6 +389,7 @@ bool monitor_add_server(MXS_MONITOR* mon, SERVER* server)
         db->log_version_err = true;
         // Pretend disk space was just checked.
         db->disk_space_checked = maxscale::MonitorInstance::get_time_ms();
+        db->probe_latency_us = 0;
 
 
         /** Server status is uninitialized */
@@ -558,6 +562,7 @@ void monitor_show(DCB* dcb, MXS_MONITOR* monitor)
     dcb_printf(dcb, "Read Timeout:           %i seconds\n", monitor->read_timeout);
     dcb_printf(dcb, "Write Timeout:          %i seconds\n", monitor->write_timeout);
     dcb_printf(dcb, "Connect attempts:       %i \n", monitor->connect_attempts);
+    dcb_printf(dcb, "Concurrent probing:     %s\n", monitor->concurrent_probing ? "yes" : "no");
     dcb_printf(dcb, "Monitored servers:      ");
 
     const char* sep = "";
@@ -568,6 +573,18 @@ void monitor_show(DCB* dcb, MXS_MONITOR* monitor)
         sep = ", ";
     }
 
+    dcb_printf(dcb, "\n");
+    dcb_printf(dcb, "Probe latency:          ");
+
+    sep = "";
+
+    for (MXS_MONITORED_SERVER* db = monitor->monitored_servers; db; db = db->next)
+    {
+        dcb_printf(dcb, "%s%s: %ldus", sep, db->server->name,
+                   mxb::atomic::load(&db->probe_latency_us, mxb::atomic::RELAXED));
+        sep = ", ";
+    }
+
     dcb_printf(dcb, "\n");
 
     if (monitor->instance)
@@ -1836,6 +1853,16 @@ json_t* monitor_json_data(const MXS_MONITOR* monitor, const char* host)
 
     if (monitor->monitored_servers)
     {
+        json_t* latencies = json_object();
+
+        for (MXS_MONITORED_SERVER* db = monitor->monitored_servers; db; db = db->next)
+        {
+            int64_t latency = mxb::atomic::load(&db->probe_latency_us, mxb::atomic::RELAXED);
+            json_object_set_new(latencies, db->server->name, json_integer(latency));
+        }
+
+        json_object_set_new(attr, "probe_latency_us", latencies);
+
         json_t* mon_rel = mxs_json_relationship(host, MXS_JSON_API_SERVERS);
 
         for (MXS_MONITORED_SERVER* db = monitor->monitored_servers; db; db = db->next)
@@ -2519,6 +2546,42 @@ void monitor_debug_wait()
 namespace maxscale
 {
 
+/**
+ * A thread for probing a server concurrently with other servers.
+ */
+class MonitorInstance::ProbeWorker : public mxb::Worker
+{
+public:
+    ProbeWorker(const ProbeWorker&) = delete;
+    ProbeWorker& operator=(const ProbeWorker&) = delete;
+
+    ProbeWorker()
+    {
+    }
+
+private:
+    bool pre_run() override
+    {
+        return mysql_thread_init() == 0;
+    }
+
+    void post_run() override
+    {
+        mysql_thread_end();
+    }
+};
+
+namespace
+{
+
+int64_t elapsed_us(std::chrono::steady_clock::time_point start)
+{
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+}
+
 MonitorInstance::MonitorInstance(MXS_MONITOR* pMonitor)
     : m_monitor(pMonitor)
     , m_master(NULL)
@@ -2531,6 +2594,7 @@ MonitorInstance::MonitorInstance(MXS_MONITOR* pMonitor)
 
 MonitorInstance::~MonitorInstance()
 {
+    mxb_assert(m_probe_workers.empty());
 }
 
 monitor_state_t MonitorInstance::monitor_state() const
@@ -2777,6 +2841,97 @@ void MonitorInstance::update_disk_space_status(MXS_MONITORED_SERVER* pMs)
     }
 }
 
+void MonitorInstance::probe_servers(const std::function<void (MXS_MONITORED_SERVER*)>& probe)
+{
+    auto timed_probe = [&probe](MXS_MONITORED_SERVER* pMs) {
+            auto start = std::chrono::steady_clock::now();
+            probe(pMs);
+            mxb::atomic::store(&pMs->probe_latency_us, elapsed_us(start), mxb::atomic::RELAXED);
+        };
+
+    std::vector<MXS_MONITORED_SERVER*> servers;
+
+    for (MXS_MONITORED_SERVER* pMs = m_monitor->monitored_servers; pMs; pMs = pMs->next)
+    {
+        servers.push_back(pMs);
+    }
+
+    if (m_monitor->concurrent_probing && servers.size() > 1 && start_probe_workers(servers.size()))
+    {
+        // Each server gets a thread of its own, so a server that does not
+        // respond cannot delay the probing of any other server.
+        mxb::Semaphore sem;
+        size_t n_posted = 0;
+
+        for (size_t i = 0; i < servers.size(); ++i)
+        {
+            MXS_MONITORED_SERVER* pMs = servers[i];
+
+            if (m_probe_workers[i]->execute([&timed_probe, pMs]() {
+                                                timed_probe(pMs);
+                                            }, &sem, Worker::EXECUTE_QUEUED))
+            {
+                ++n_posted;
+            }
+            else
+            {
+                timed_probe(pMs);
+            }
+        }
+
+        sem.wait_n(n_posted);
+    }
+    else
+    {
+        for (MXS_MONITORED_SERVER* pMs : servers)
+        {
+            timed_probe(pMs);
+        }
+    }
+}
+
+bool MonitorInstance::start_probe_workers(size_t n)
+{
+    while (m_probe_workers.size() < n)
+    {
+        std::unique_ptr<ProbeWorker> sWorker(new(std::nothrow) ProbeWorker);
+
+        if (!sWorker || !sWorker->start())
+        {
+            break;
+        }
+        else if (sWorker->state() == Worker::STOPPED)
+        {
+            // pre_run() failed and the thread has exited.
+            sWorker->join();
+            break;
+        }
+
+        m_probe_workers.push_back(std::move(sWorker));
+    }
+
+    bool rv = m_probe_workers.size() >= n;
+
+    if (!rv)
+    {
+        MXS_ERROR("Could not start the threads needed for probing the servers of monitor '%s' "
+                  "concurrently, the servers will be probed one at a time.", m_monitor->name);
+    }
+
+    return rv;
+}
+
+void MonitorInstance::stop_probe_workers()
+{
+    for (auto& sWorker : m_probe_workers)
+    {
+        sWorker->shutdown();
+        sWorker->join();
+    }
+
+    m_probe_workers.clear();
+}
+
 bool MonitorInstance::configure(const MXS_CONFIG_PARAMETER* pParams)
 {
     return true;
@@ -2810,26 +2965,54 @@ void MonitorInstanceSimple::tick()
 {
     pre_tick();
 
+    // The connections are checked, possibly concurrently, after which the status
+    // of the servers is updated one server at a time.
+    std::map<MXS_MONITORED_SERVER*, mxs_connect_result_t> results;
+
     for (MXS_MONITORED_SERVER* pMs = m_monitor->monitored_servers; pMs; pMs = pMs->next)
     {
         if (!server_is_in_maint(pMs->server))
         {
-            pMs->mon_prev_status = pMs->server->status;
-            pMs->pending_status = pMs->server->status;
+            results[pMs] = MONITOR_CONN_REFUSED;
+        }
+    }
 
-            mxs_connect_result_t rval = mon_ping_or_connect_to_db(m_monitor, pMs);
+    probe_servers([this, &results](MXS_MONITORED_SERVER* pMs) {
+                      auto it = results.find(pMs);
 
-            if (mon_connection_is_ok(rval))
-            {
-                monitor_clear_pending_status(pMs, SERVER_AUTH_ERROR);
-                monitor_set_pending_status(pMs, SERVER_RUNNING);
+                      if (it != results.end())
+                      {
+                          pMs->mon_prev_status = pMs->server->status;
+                          pMs->pending_status = pMs->server->status;
 
-                if (should_update_disk_space_status(pMs))
-                {
-                    update_disk_space_status(pMs);
-                }
+                          it->second = mon_ping_or_connect_to_db(m_monitor, pMs);
+
+                          if (mon_connection_is_ok(it->second))
+                          {
+                              monitor_clear_pending_status(pMs, SERVER_AUTH_ERROR);
+                              monitor_set_pending_status(pMs, SERVER_RUNNING);
+
+                              if (should_update_disk_space_status(pMs))
+                              {
+                                  update_disk_space_status(pMs);
+                              }
+                          }
+                      }
+                  });
+
+    for (MXS_MONITORED_SERVER* pMs = m_monitor->monitored_servers; pMs; pMs = pMs->next)
+    {
+        auto it = results.find(pMs);
+
+        if (it != results.end())
+        {
+            mxs_connect_result_t rval = it->second;
 
+            if (mon_connection_is_ok(rval))
+            {
+                auto start = std::chrono::steady_clock::now();
                 update_server_status(pMs);
+                mxb::atomic::add(&pMs->probe_latency_us, elapsed_us(start), mxb::atomic::RELAXED);
             }
             else
             {
@@ -2925,6 +3108,7 @@ bool MonitorInstance::pre_run()
 void MonitorInstance::post_run()
 {
     post_loop();
+    stop_probe_workers();
 
     mysql_thread_end();
 }
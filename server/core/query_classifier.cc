@@ -15,8 +15,8 @@
 #include <inttypes.h>
 #include <algorithm>
 #include <atomic>
-#include <random>
 #include <unordered_map>
+#include <vector>
 #include <maxscale/alloc.h>
 #include <maxbase/atomic.h>
 #include <maxbase/format.hh>
@@ -102,11 +102,60 @@ static thread_local struct
 };
 
 
+/**
+ * Return the histogram bucket of a statement size.
+ *
+ * @param size  The size of a canonical statement.
+ *
+ * @return 0 for sizes below 64, and one more for each doubling of that.
+ */
+int size_bucket(size_t size)
+{
+    int bucket = 0;
+
+    size >>= 6;
+
+    while (size && bucket < QC_CACHE_STATS_BUCKETS - 1)
+    {
+        size >>= 1;
+        ++bucket;
+    }
+
+    return bucket;
+}
+
+/**
+ * Return the histogram bucket of a hit count.
+ *
+ * @param hits  The number of hits of a cache entry.
+ *
+ * @return 0 for no hits, 1 for one hit and n for 2^(n-1) to 2^n - 1 hits.
+ */
+int hits_bucket(uint32_t hits)
+{
+    int bucket = 0;
+
+    while (hits && bucket < QC_CACHE_STATS_BUCKETS - 1)
+    {
+        hits >>= 1;
+        ++bucket;
+    }
+
+    return bucket;
+}
+
 /**
  * @class QCInfoCache
  *
  * An instance of this class maintains a mapping from a canonical statement to
  * the QC_STMT_INFO object created by the actual query classifier.
+ *
+ * The entries are keyed by a hash of the canonical statement, and the statement
+ * itself is stored in the entry and compared on lookup. When space is needed,
+ * entries are evicted using CLOCK with a small frequency counter: the clock hand
+ * sweeps over the entries, and an entry that has been hit since the hand last
+ * passed it is spared once for every hit, up to MAX_FREQUENCY times. Frequently
+ * used statements thus survive a stream of statements that are used only once.
  */
 class QCInfoCache
 {
@@ -115,7 +164,7 @@ public:
     QCInfoCache& operator=(const QCInfoCache&) = delete;
 
     QCInfoCache()
-        : m_reng(m_rdev())
+        : m_hand(0)
     {
         memset(&m_stats, 0, sizeof(m_stats));
     }
@@ -124,28 +173,28 @@ public:
     {
         mxb_assert(this_unit.classifier);
 
-        for (auto a : m_infos)
+        for (const auto& a : m_infos)
         {
             this_unit.classifier->qc_info_close(a.second.pInfo);
         }
     }
 
-    QC_STMT_INFO* peek(const std::string& canonical_stmt) const
+    QC_STMT_INFO* peek(const std::string& canonical_stmt, uint64_t key) const
     {
-        auto i = m_infos.find(canonical_stmt);
+        auto i = m_infos.find(key);
 
-        return i != m_infos.end() ? i->second.pInfo : nullptr;
+        return i != m_infos.end() && i->second.stmt == canonical_stmt ? i->second.pInfo : nullptr;
     }
 
-    QC_STMT_INFO* get(const std::string& canonical_stmt)
+    QC_STMT_INFO* get(const std::string& canonical_stmt, uint64_t key)
     {
         QC_STMT_INFO* pInfo = nullptr;
 
-        auto i = m_infos.find(canonical_stmt);
+        auto i = m_infos.find(key);
 
-        if (i != m_infos.end())
+        if (i != m_infos.end() && i->second.stmt == canonical_stmt)
         {
-            const Entry& entry = i->second;
+            Entry& entry = i->second;
 
             if (entry.sql_mode == this_unit.qc_sql_mode)
             {
@@ -153,27 +202,35 @@ public:
                 this_unit.classifier->qc_info_dup(entry.pInfo);
                 pInfo = entry.pInfo;
 
+                ++entry.hits;
+
+                if (entry.frequency < MAX_FREQUENCY)
+                {
+                    ++entry.frequency;
+                }
+
                 ++m_stats.hits;
+                ++m_stats.hits_by_size[size_bucket(canonical_stmt.size())];
             }
             else
             {
                 // If the sql_mode has changed, we discard the existing result.
                 erase(i);
-
-                ++m_stats.misses;
             }
         }
-        else
+
+        if (!pInfo)
         {
             ++m_stats.misses;
+            ++m_stats.misses_by_size[size_bucket(canonical_stmt.size())];
         }
 
         return pInfo;
     }
 
-    void insert(const std::string& canonical_stmt, QC_STMT_INFO* pInfo)
+    void insert(const std::string& canonical_stmt, uint64_t key, QC_STMT_INFO* pInfo)
     {
-        mxb_assert(peek(canonical_stmt) == nullptr);
+        mxb_assert(peek(canonical_stmt, key) == nullptr);
         mxb_assert(this_unit.classifier);
 
         int64_t cache_max_size = this_unit.cache_max_size() / config_get_global_options()->n_threads;
@@ -181,6 +238,14 @@ public:
 
         if (size <= cache_max_size)
         {
+            auto i = m_infos.find(key);
+
+            if (i != m_infos.end())
+            {
+                // A different statement with the same hash, the new one replaces it.
+                erase(i);
+            }
+
             int64_t required_space = (m_stats.size + size) - cache_max_size;
 
             if (required_space > 0)
@@ -192,7 +257,8 @@ public:
             {
                 this_unit.classifier->qc_info_dup(pInfo);
 
-                m_infos.emplace(canonical_stmt, Entry(pInfo, this_unit.qc_sql_mode));
+                m_infos.emplace(key, Entry(canonical_stmt, pInfo, this_unit.qc_sql_mode, m_clock.size()));
+                m_clock.push_back(key);
 
                 ++m_stats.inserts;
                 m_stats.size += size;
@@ -206,88 +272,106 @@ public:
     }
 
 private:
+    enum
+    {
+        MAX_FREQUENCY = 3
+    };
+
     struct Entry
     {
-        Entry(QC_STMT_INFO* pInfo, qc_sql_mode_t sql_mode)
-            : pInfo(pInfo)
+        Entry(const std::string& stmt, QC_STMT_INFO* pInfo, qc_sql_mode_t sql_mode, size_t slot)
+            : stmt(stmt)
+            , pInfo(pInfo)
             , sql_mode(sql_mode)
+            , slot(slot)
+            , hits(0)
+            , frequency(0)
         {
         }
 
+        std::string   stmt;         // The canonical statement, for verifying a match.
         QC_STMT_INFO* pInfo;
         qc_sql_mode_t sql_mode;
+        size_t        slot;         // The position of the entry in m_clock.
+        uint32_t      hits;         // Hits since the entry was inserted.
+        uint8_t       frequency;    // Hits since the clock hand last passed, at most MAX_FREQUENCY.
     };
 
-    typedef std::unordered_map<std::string, Entry> InfosByStmt;
+    typedef std::unordered_map<uint64_t, Entry> InfosByKey;
 
-    void erase(InfosByStmt::iterator& i)
+    void erase(InfosByKey::iterator i)
     {
         mxb_assert(i != m_infos.end());
 
-        m_stats.size -= i->first.size();
+        const Entry& entry = i->second;
+
+        // The last entry of the clock takes the place of the erased one.
+        size_t slot = entry.slot;
+        uint64_t last = m_clock.back();
+        m_clock[slot] = last;
+        m_infos.find(last)->second.slot = slot;
+        m_clock.pop_back();
+
+        m_stats.size -= entry.stmt.size();
 
         mxb_assert(this_unit.classifier);
-        this_unit.classifier->qc_info_close(i->second.pInfo);
+        this_unit.classifier->qc_info_close(entry.pInfo);
 
         m_infos.erase(i);
 
         ++m_stats.evictions;
     }
 
-    bool erase(const std::string& canonical_stmt)
-    {
-        bool erased = false;
-
-        auto i = m_infos.find(canonical_stmt);
-        mxb_assert(i != m_infos.end());
-
-        if (i != m_infos.end())
-        {
-            erase(i);
-            erased = true;
-        }
-
-        return erased;
-    }
-
     void make_space(int64_t required_space)
     {
         int64_t freed_space = 0;
 
-        std::uniform_int_distribution<> dis(0, m_infos.bucket_count() - 1);
-
         while ((freed_space < required_space) && !m_infos.empty())
         {
-            freed_space += evict(dis);
+            freed_space += evict();
         }
     }
 
-    int64_t evict(std::uniform_int_distribution<>& dis)
+    int64_t evict()
     {
         int64_t freed_space = 0;
+        bool evicted = false;
 
-        int bucket = dis(m_reng);
-        mxb_assert((bucket >= 0) && (bucket < static_cast<int>(m_infos.bucket_count())));
+        // Terminates, as every entry that is spared gets its frequency decremented.
+        while (!evicted)
+        {
+            if (m_hand >= m_clock.size())
+            {
+                m_hand = 0;
+            }
 
-        auto i = m_infos.begin(bucket);
+            auto i = m_infos.find(m_clock[m_hand]);
+            mxb_assert(i != m_infos.end());
+            Entry& entry = i->second;
 
-        // We just remove the first entry in the bucket. In the general case
-        // there will be just one.
-        if (i != m_infos.end(bucket))
-        {
-            freed_space += i->first.size();
+            if (entry.frequency > 0)
+            {
+                --entry.frequency;
+                ++m_hand;
+            }
+            else
+            {
+                freed_space = entry.stmt.size();
+                ++m_stats.evictions_by_hits[hits_bucket(entry.hits)];
 
-            MXB_AT_DEBUG(bool erased = ) erase(i->first);
-            mxb_assert(erased);
+                // The entry now at m_hand, moved from the end, is looked at next.
+                erase(i);
+                evicted = true;
+            }
         }
 
         return freed_space;
     }
 
-    InfosByStmt        m_infos;
-    QC_CACHE_STATS     m_stats;
-    std::random_device m_rdev;
-    std::mt19937       m_reng;
+    InfosByKey            m_infos;
+    std::vector<uint64_t> m_clock;  // The keys of the entries, in clock order.
+    size_t                m_hand;   // The position of the clock hand in m_clock.
+    QC_CACHE_STATS        m_stats;
 };
 
 bool use_cached_result()
@@ -328,19 +412,21 @@ public:
 
     QCInfoCacheScope(GWBUF* pStmt)
         : m_pStmt(pStmt)
+        , m_key(0)
     {
         if (use_cached_result() && has_not_been_parsed(m_pStmt))
         {
-            m_canonical = mxs::get_canonical(m_pStmt);
+            m_canonical = mxs::get_canonical(m_pStmt, &m_key);
 
             if (modutil_is_SQL_prepare(pStmt))
             {
                 // P as in prepare, and appended so as not to cause a
                 // need for copying the data.
                 m_canonical += ":P";
+                m_key = ~m_key;
             }
 
-            QC_STMT_INFO* pInfo = this_thread.pInfo_cache->get(m_canonical);
+            QC_STMT_INFO* pInfo = this_thread.pInfo_cache->get(m_canonical, m_key);
 
             if (pInfo)
             {
@@ -358,13 +444,14 @@ public:
             mxb_assert(pData);
             QC_STMT_INFO* pInfo = static_cast<QC_STMT_INFO*>(pData);
 
-            this_thread.pInfo_cache->insert(m_canonical, pInfo);
+            this_thread.pInfo_cache->insert(m_canonical, m_key, pInfo);
         }
     }
 
 private:
     GWBUF*      m_pStmt;
     std::string m_canonical;
+    uint64_t    m_key;  // The fingerprint of the canonical statement.
 };
 }
 
@@ -1323,12 +1410,36 @@ json_t* qc_get_cache_stats_as_json()
     QC_CACHE_STATS stats = {};
     qc_get_cache_stats(&stats);
 
+    return qc_cache_stats_to_json(stats);
+}
+
+namespace
+{
+
+json_t* histogram_to_json(const int64_t* pHistogram)
+{
+    json_t* pArray = json_array();
+
+    for (int i = 0; i < QC_CACHE_STATS_BUCKETS; ++i)
+    {
+        json_array_append_new(pArray, json_integer(pHistogram[i]));
+    }
+
+    return pArray;
+}
+}
+
+json_t* qc_cache_stats_to_json(const QC_CACHE_STATS& stats)
+{
     json_t* pStats = json_object();
     json_object_set_new(pStats, "size", json_integer(stats.size));
     json_object_set_new(pStats, "inserts", json_integer(stats.inserts));
     json_object_set_new(pStats, "hits", json_integer(stats.hits));
     json_object_set_new(pStats, "misses", json_integer(stats.misses));
     json_object_set_new(pStats, "evictions", json_integer(stats.evictions));
+    json_object_set_new(pStats, "hits_by_size", histogram_to_json(stats.hits_by_size));
+    json_object_set_new(pStats, "misses_by_size", histogram_to_json(stats.misses_by_size));
+    json_object_set_new(pStats, "evictions_by_hits", histogram_to_json(stats.evictions_by_hits));
 
     return pStats;
 }
@@ -13,14 +13,23 @@
 
 #include <maxscale/routingworker.hh>
 
+#include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
 #include <signal.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <sys/sysinfo.h>
 #ifdef HAVE_SYSTEMD
 #include <systemd/sd-daemon.h>
 #endif
+#include <map>
+#include <set>
+#include <string>
 #include <vector>
 #include <sstream>
 
@@ -37,6 +46,8 @@
 #include "internal/dcb.h"
 #include "internal/modules.h"
 #include "internal/poll.hh"
+#include "internal/query_classifier.hh"
+#include "internal/server.hh"
 #include "internal/service.hh"
 
 #define WORKER_ABSENT_ID -1
@@ -69,6 +80,8 @@ struct this_unit
     int id_main_worker;     // The id of the worker running in the main thread.
     int id_min_worker;      // The smallest routing worker id.
     int id_max_worker;      // The largest routing worker id.
+    int assignment;         // How new client connections are assigned, a RoutingWorker::assignment_t.
+    int listener_mode;      // How listeners distribute connections, a RoutingWorker::listener_mode_t.
 } this_unit =
 {
     false,              // initialized
@@ -81,6 +94,8 @@ struct this_unit
     WORKER_ABSENT_ID,   // id_main_worker
     WORKER_ABSENT_ID,   // id_min_worker
     WORKER_ABSENT_ID,   // id_max_worker
+    RoutingWorker::ASSIGN_ROUND_ROBIN, // assignment
+    RoutingWorker::LISTENER_SHARED,    // listener_mode
 };
 
 int next_worker_id()
@@ -88,6 +103,210 @@ int next_worker_id()
     return mxb::atomic::add(&this_unit.next_worker_id, 1, mxb::atomic::RELAXED);
 }
 
+/**
+ * FNV-1a hash of a client address.
+ */
+uint32_t hash_address(const char* zAddress)
+{
+    uint32_t hash = 2166136261;
+
+    while (*zAddress)
+    {
+        hash ^= (uint8_t)*zAddress++;
+        hash *= 16777619;
+    }
+
+    return hash;
+}
+
+// The worker_affinity parameter, resolved to the CPUs of the workers when they are created.
+std::string affinity = "none";
+
+/**
+ * Parse a list of CPUs and CPU ranges, such as "0-3,8".
+ *
+ * @param zList  The list.
+ * @param pCpus  On success, the CPUs in the order they are listed.
+ *
+ * @return True, if the list was valid, false otherwise.
+ */
+bool parse_cpu_list(const char* zList, vector<int>* pCpus)
+{
+    bool rv = *zList != 0;
+    vector<int> cpus;
+    const char* z = zList;
+
+    while (rv && *z)
+    {
+        char* zEnd;
+        long first = strtol(z, &zEnd, 10);
+        long last = first;
+
+        if (zEnd == z || first < 0)
+        {
+            rv = false;
+        }
+        else if (*zEnd == '-')
+        {
+            z = zEnd + 1;
+            last = strtol(z, &zEnd, 10);
+            rv = zEnd != z && last >= first;
+        }
+
+        if (rv && last < CPU_SETSIZE && (*zEnd == ',' || *zEnd == 0))
+        {
+            for (long cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+
+            z = *zEnd ? zEnd + 1 : zEnd;
+        }
+        else
+        {
+            rv = false;
+        }
+    }
+
+    if (rv)
+    {
+        pCpus->swap(cpus);
+    }
+
+    return rv;
+}
+
+/**
+ * @return A value from the topology of the CPU in sysfs, or -1 if it is not available.
+ */
+int read_cpu_topology(int cpu, const char* zName)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s", cpu, zName);
+    int value = -1;
+
+    if (FILE* pFile = fopen(path, "r"))
+    {
+        if (fscanf(pFile, "%d", &value) != 1)
+        {
+            value = -1;
+        }
+
+        fclose(pFile);
+    }
+
+    return value;
+}
+
+/**
+ * @return The NUMA node of the CPU, 0 if the system has no NUMA nodes.
+ */
+int cpu_node(int cpu)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+    int node = 0;
+
+    if (DIR* pDir = opendir(path))
+    {
+        while (struct dirent* pEntry = readdir(pDir))
+        {
+            if (sscanf(pEntry->d_name, "node%d", &node) == 1)
+            {
+                break;
+            }
+        }
+
+        closedir(pDir);
+    }
+
+    return node;
+}
+
+/**
+ * One CPU of each physical core the process may run on. The cores of the NUMA
+ * nodes are interleaved, so that the workers are spread evenly over the nodes.
+ */
+vector<int> physical_core_cpus()
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(allowed), &allowed);
+
+    std::set<std::pair<int, int>> cores;
+    std::map<int, vector<int>> cpus_by_node;
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (CPU_ISSET(cpu, &allowed))
+        {
+            int core_id = read_cpu_topology(cpu, "core_id");
+            auto core = core_id == -1 ?
+                std::make_pair(-1, cpu) :
+                std::make_pair(read_cpu_topology(cpu, "physical_package_id"), core_id);
+
+            if (cores.insert(core).second)
+            {
+                cpus_by_node[cpu_node(cpu)].push_back(cpu);
+            }
+        }
+    }
+
+    vector<int> cpus;
+
+    for (size_t i = 0; cpus.size() < cores.size(); ++i)
+    {
+        for (const auto& node : cpus_by_node)
+        {
+            if (i < node.second.size())
+            {
+                cpus.push_back(node.second[i]);
+            }
+        }
+    }
+
+    return cpus;
+}
+
+/**
+ * @return The CPUs of the workers, in the order of the worker ids, or an empty
+ *         vector if the workers are not bound to CPUs.
+ */
+vector<int> worker_cpus(int nWorkers)
+{
+    vector<int> cpus;
+
+    if (affinity == "cores")
+    {
+        cpus = physical_core_cpus();
+    }
+    else if (affinity != "none")
+    {
+        MXB_AT_DEBUG(bool valid = ) parse_cpu_list(affinity.c_str(), &cpus);
+        mxb_assert(valid);
+    }
+
+    vector<int> rv;
+
+    if (!cpus.empty())
+    {
+        if (cpus.size() < (size_t)nWorkers)
+        {
+            MXS_WARNING("There are %d routing threads but only %lu CPUs to bind them to, "
+                        "some threads share a CPU.",
+                        nWorkers,
+                        cpus.size());
+        }
+
+        for (int i = 0; i < nWorkers; ++i)
+        {
+            rv.push_back(cpus[i % cpus.size()]);
+        }
+    }
+
+    return rv;
+}
+
 thread_local struct this_thread
 {
     int current_worker_id;      // The worker id of the current thread
@@ -252,6 +471,8 @@ private:
 
 RoutingWorker::RoutingWorker()
     : m_id(next_worker_id())
+    , m_nAssigned(0)
+    , m_cpu(-1)
     , m_alive(true)
     , m_pWatchdog_notifier(nullptr)
 {
@@ -333,6 +554,13 @@ bool RoutingWorker::init()
 
             if (ppWorkers)
             {
+                vector<int> cpus = worker_cpus(nWorkers);
+
+                for (size_t j = 0; j < cpus.size(); ++j)
+                {
+                    ppWorkers[j]->m_cpu = cpus[j];
+                }
+
                 this_unit.ppWorkers = ppWorkers;
                 this_unit.nWorkers = nWorkers;
                 this_unit.id_main_worker = id_main_worker;
@@ -439,6 +667,73 @@ bool RoutingWorker::remove_shared_fd(int fd)
     return rv;
 }
 
+// static
+bool RoutingWorker::add_reuseport_fds(const int* pFds, uint32_t events, MXB_POLL_DATA* pData)
+{
+    mxb_assert(this_unit.initialized);
+    bool rv = true;
+
+    // Level-triggered for the same reason as in add_shared_fd(). The descriptors
+    // are added directly to the epoll instance of each worker, which is polled
+    // also when the worker waits using io_uring.
+    events &= ~EPOLLET;
+
+    struct epoll_event ev;
+
+    ev.events = events;
+    ev.data.ptr = pData;
+
+    // As with add_shared_fd(), the data is shared by all workers and owned by the main worker.
+    pData->owner = RoutingWorker::get(RoutingWorker::MAIN);
+
+    int i;
+
+    for (i = 0; i < this_unit.nWorkers; ++i)
+    {
+        RoutingWorker* pWorker = this_unit.ppWorkers[this_unit.id_min_worker + i];
+
+        if (epoll_ctl(pWorker->m_epoll_fd, EPOLL_CTL_ADD, pFds[i], &ev) != 0)
+        {
+            Worker::resolve_poll_error(pFds[i], errno, EPOLL_CTL_ADD);
+            rv = false;
+            break;
+        }
+    }
+
+    if (!rv)
+    {
+        while (i-- > 0)
+        {
+            RoutingWorker* pWorker = this_unit.ppWorkers[this_unit.id_min_worker + i];
+            epoll_ctl(pWorker->m_epoll_fd, EPOLL_CTL_DEL, pFds[i], &ev);
+        }
+    }
+
+    return rv;
+}
+
+// static
+bool RoutingWorker::remove_reuseport_fds(const int* pFds)
+{
+    mxb_assert(this_unit.initialized);
+    bool rv = true;
+
+    struct epoll_event ev = {};
+
+    for (int i = 0; i < this_unit.nWorkers; ++i)
+    {
+        RoutingWorker* pWorker = this_unit.ppWorkers[this_unit.id_min_worker + i];
+
+        if (epoll_ctl(pWorker->m_epoll_fd, EPOLL_CTL_DEL, pFds[i], &ev) != 0)
+        {
+            Worker::resolve_poll_error(pFds[i], errno, EPOLL_CTL_DEL);
+            rv = false;
+        }
+    }
+
+    return rv;
+}
+
 bool mxs_worker_should_shutdown(MXB_WORKER* pWorker)
 {
     return static_cast<RoutingWorker*>(pWorker)->should_shutdown();
@@ -558,6 +853,29 @@ bool RoutingWorker::pre_run()
 {
     this_thread.current_worker_id = m_id;
 
+    if (m_cpu != -1)
+    {
+        // Bound before anything is allocated, so that the memory the worker
+        // allocates is placed on the NUMA node of the CPU.
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(m_cpu, &cpus);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+        if (err == 0)
+        {
+            MXS_INFO("Routing worker %d bound to CPU %d.", m_id, m_cpu);
+        }
+        else
+        {
+            MXS_WARNING("Could not bind routing worker %d to CPU %d: %d, %s",
+                        m_id,
+                        m_cpu,
+                        err,
+                        mxs_strerror(err));
+        }
+    }
+
     bool rv = modules_thread_init() && service_thread_init() && qc_thread_init(QC_INIT_SELF);
 
     if (!rv)
@@ -633,6 +951,8 @@ void RoutingWorker::epoll_tick()
 {
     dcb_process_idle_sessions(m_id);
 
+    server_process_persistent_pools(m_id);
+
     m_state = ZPROCESSING;
 
     delete_zombies();
@@ -996,12 +1316,7 @@ namespace
 
 json_t* qc_stats_to_json(const char* zHost, int id, const QC_CACHE_STATS& stats)
 {
-    json_t* pStats = json_object();
-    json_object_set_new(pStats, "size", json_integer(stats.size));
-    json_object_set_new(pStats, "inserts", json_integer(stats.inserts));
-    json_object_set_new(pStats, "hits", json_integer(stats.hits));
-    json_object_set_new(pStats, "misses", json_integer(stats.misses));
-    json_object_set_new(pStats, "evictions", json_integer(stats.evictions));
+    json_t* pStats = qc_cache_stats_to_json(stats);
 
     json_t* pAttributes = json_object();
     json_object_set_new(pAttributes, "stats", pStats);
@@ -1060,12 +1375,253 @@ std::unique_ptr<json_t> RoutingWorker::get_qc_stats_as_json(const char* zHost)
 }
 
 // static
-RoutingWorker* RoutingWorker::pick_worker()
+void RoutingWorker::set_assignment(assignment_t assignment)
+{
+    mxb::atomic::store(&this_unit.assignment, assignment, mxb::atomic::RELAXED);
+}
+
+// static
+RoutingWorker::assignment_t RoutingWorker::get_assignment()
+{
+    return static_cast<assignment_t>(mxb::atomic::load(&this_unit.assignment, mxb::atomic::RELAXED));
+}
+
+// static
+const char* RoutingWorker::assignment_to_string(assignment_t assignment)
+{
+    const char* zValue = "round_robin";
+
+    switch (assignment)
+    {
+    case ASSIGN_ROUND_ROBIN:
+        break;
+
+    case ASSIGN_LEAST_LOADED:
+        zValue = "least_loaded";
+        break;
+
+    case ASSIGN_ADDRESS_HASH:
+        zValue = "address_hash";
+        break;
+    }
+
+    return zValue;
+}
+
+// static
+bool RoutingWorker::assignment_from_string(const char* zValue, assignment_t* pAssignment)
+{
+    bool rv = true;
+
+    if (strcmp(zValue, "round_robin") == 0)
+    {
+        *pAssignment = ASSIGN_ROUND_ROBIN;
+    }
+    else if (strcmp(zValue, "least_loaded") == 0)
+    {
+        *pAssignment = ASSIGN_LEAST_LOADED;
+    }
+    else if (strcmp(zValue, "address_hash") == 0)
+    {
+        *pAssignment = ASSIGN_ADDRESS_HASH;
+    }
+    else
+    {
+        rv = false;
+    }
+
+    return rv;
+}
+
+// static
+void RoutingWorker::set_listener_mode(listener_mode_t mode)
+{
+    mxb::atomic::store(&this_unit.listener_mode, mode, mxb::atomic::RELAXED);
+}
+
+// static
+RoutingWorker::listener_mode_t RoutingWorker::get_listener_mode()
+{
+    return static_cast<listener_mode_t>(mxb::atomic::load(&this_unit.listener_mode, mxb::atomic::RELAXED));
+}
+
+// static
+const char* RoutingWorker::listener_mode_to_string(listener_mode_t mode)
+{
+    const char* zValue = "shared";
+
+    switch (mode)
+    {
+    case LISTENER_SHARED:
+        break;
+
+    case LISTENER_REUSEPORT:
+        zValue = "reuseport";
+        break;
+
+    case LISTENER_REUSEPORT_CPU:
+        zValue = "reuseport_cpu";
+        break;
+    }
+
+    return zValue;
+}
+
+// static
+bool RoutingWorker::listener_mode_from_string(const char* zValue, listener_mode_t* pMode)
+{
+    bool rv = true;
+
+    if (strcmp(zValue, "shared") == 0)
+    {
+        *pMode = LISTENER_SHARED;
+    }
+    else if (strcmp(zValue, "reuseport") == 0)
+    {
+        *pMode = LISTENER_REUSEPORT;
+    }
+    else if (strcmp(zValue, "reuseport_cpu") == 0)
+    {
+        *pMode = LISTENER_REUSEPORT_CPU;
+    }
+    else
+    {
+        rv = false;
+    }
+
+    return rv;
+}
+
+// static
+bool RoutingWorker::set_affinity(const char* zValue)
+{
+    vector<int> cpus;
+    bool rv = strcmp(zValue, "none") == 0
+        || strcmp(zValue, "cores") == 0
+        || parse_cpu_list(zValue, &cpus);
+
+    if (rv)
+    {
+        affinity = zValue;
+    }
+
+    return rv;
+}
+
+// static
+const char* RoutingWorker::get_affinity()
+{
+    return affinity.c_str();
+}
+
+// static
+vector<int> RoutingWorker::get_cpu_map()
+{
+    mxb_assert(this_unit.initialized);
+    vector<int> map;
+    vector<int> nodes;
+
+    for (int i = 0; i < this_unit.nWorkers; ++i)
+    {
+        int cpu = get(this_unit.id_min_worker + i)->m_cpu;
+        nodes.push_back(cpu == -1 ? -1 : cpu_node(cpu));
+    }
+
+    if (nodes[0] != -1)
+    {
+        int nCpus = get_nprocs_conf();
+
+        for (int cpu = 0; cpu < nCpus; ++cpu)
+        {
+            int node = cpu_node(cpu);
+            int index = -1;
+            vector<int> same_node;
+
+            for (int i = 0; i < this_unit.nWorkers && index == -1; ++i)
+            {
+                if (get(this_unit.id_min_worker + i)->m_cpu == cpu)
+                {
+                    index = i;
+                }
+                else if (nodes[i] == node)
+                {
+                    same_node.push_back(i);
+                }
+            }
+
+            if (index == -1)
+            {
+                index = same_node.empty() ? cpu % this_unit.nWorkers : same_node[cpu % same_node.size()];
+            }
+
+            map.push_back(index);
+        }
+    }
+
+    return map;
+}
+
+// static
+RoutingWorker* RoutingWorker::pick_worker(const char* zAddress)
 {
     static int id_generator = 0;
-    int id = this_unit.id_min_worker
-        + (mxb::atomic::add(&id_generator, 1, mxb::atomic::RELAXED) % this_unit.nWorkers);
-    return get(id);
+    int next = mxb::atomic::add(&id_generator, 1, mxb::atomic::RELAXED) % this_unit.nWorkers;
+    int id = this_unit.id_min_worker + next;
+    int current_id = get_current_id();
+
+    if (get_listener_mode() != LISTENER_SHARED && current_id != WORKER_ABSENT_ID)
+    {
+        // The connection was accepted from the socket of this worker, so the kernel
+        // has already balanced it and handing it over would only add latency.
+        id = current_id;
+    }
+    else
+    {
+        switch (get_assignment())
+        {
+        case ASSIGN_ROUND_ROBIN:
+            break;
+
+        case ASSIGN_LEAST_LOADED:
+            {
+                // The load is only updated once a second, so the descriptor count, which
+                // changes as soon as a connection is added, decides and the load weighs it.
+                // The search starts from the round-robin worker so that ties are spread out.
+                uint64_t min_weight = UINT64_MAX;
+
+                for (int i = 0; i < this_unit.nWorkers; ++i)
+                {
+                    int candidate = this_unit.id_min_worker + (next + i) % this_unit.nWorkers;
+                    RoutingWorker* pCandidate = get(candidate);
+
+                    uint32_t nCurrent;
+                    uint64_t nTotal;
+                    pCandidate->get_descriptor_counts(&nCurrent, &nTotal);
+
+                    uint64_t weight = (uint64_t)(nCurrent + 1) * (100 + pCandidate->load(Load::ONE_SECOND));
+
+                    if (weight < min_weight)
+                    {
+                        min_weight = weight;
+                        id = candidate;
+                    }
+                }
+            }
+            break;
+
+        case ASSIGN_ADDRESS_HASH:
+            if (zAddress)
+            {
+                id = this_unit.id_min_worker + hash_address(zAddress) % this_unit.nWorkers;
+            }
+            break;
+        }
+    }
+
+    RoutingWorker* pWorker = get(id);
+    mxb::atomic::add(&pWorker->m_nAssigned, 1, mxb::atomic::RELAXED);
+
+    return pWorker;
 }
 
 // static
@@ -1195,6 +1751,8 @@ public:
         : m_zHost(zHost)
     {
         m_data.resize(nThreads);
+        m_descriptors.resize(nThreads);
+        m_loads.resize(nThreads);
     }
 
     void execute(Worker& worker)
@@ -1218,6 +1776,11 @@ public:
         rworker.get_descriptor_counts(&nCurrent, &nTotal);
         json_object_set_new(pStats, "current_descriptors", json_integer(nCurrent));
         json_object_set_new(pStats, "total_descriptors", json_integer(nTotal));
+        json_object_set_new(pStats, "sessions", json_integer(rworker.session_registry().size()));
+        json_object_set_new(pStats, "assigned_connections", json_integer(rworker.assigned_connections()));
+        json_object_set_new(pStats, "io_backend",
+                            json_string(Worker::io_backend_to_string(rworker.io_backend())));
+        json_object_set_new(pStats, "cpu", json_integer(rworker.cpu()));
 
         json_t* load = json_object();
         json_object_set_new(load, "last_second", json_integer(rworker.load(Worker::Load::ONE_SECOND)));
@@ -1225,6 +1788,19 @@ public:
         json_object_set_new(load, "last_hour", json_integer(rworker.load(Worker::Load::ONE_HOUR)));
         json_object_set_new(pStats, "load", load);
 
+        GWBUF_POOL_STATS pool;
+
+        if (gwbuf_get_pool_stats(&pool))
+        {
+            json_t* pPool = json_object();
+            json_object_set_new(pPool, "hits", json_integer(pool.hits));
+            json_object_set_new(pPool, "misses", json_integer(pool.misses));
+            json_object_set_new(pPool, "fallbacks", json_integer(pool.fallbacks));
+            json_object_set_new(pPool, "remote_frees", json_integer(pool.remote_frees));
+            json_object_set_new(pPool, "cached", json_integer(pool.cached));
+            json_object_set_new(pStats, "buffer_pool", pPool);
+        }
+
         json_t* qc = qc_get_cache_stats_as_json();
 
         if (qc)
@@ -1247,10 +1823,14 @@ public:
 
         mxb_assert((size_t)idx < m_data.size());
         m_data[idx] = pJson;
+        m_descriptors[idx] = nCurrent;
+        m_loads[idx] = rworker.load(Worker::Load::ONE_SECOND);
     }
 
     json_t* resource()
     {
+        add_balance();
+
         json_t* pArr = json_array();
 
         for (auto it = m_data.begin(); it != m_data.end(); it++)
@@ -1269,8 +1849,40 @@ public:
     }
 
 private:
-    vector<json_t*> m_data;
-    const char*     m_zHost;
+    /**
+     * Add to the statistics of each worker how its share of the descriptors
+     * and its load compare with those of the other workers.
+     */
+    void add_balance()
+    {
+        uint64_t total_descriptors = 0;
+        double total_load = 0;
+
+        for (size_t i = 0; i < m_data.size(); ++i)
+        {
+            total_descriptors += m_descriptors[i];
+            total_load += m_loads[i];
+        }
+
+        double average_load = m_data.empty() ? 0 : total_load / m_data.size();
+
+        for (size_t i = 0; i < m_data.size(); ++i)
+        {
+            double share = total_descriptors ? 100.0 * m_descriptors[i] / total_descriptors : 0;
+
+            json_t* pBalance = json_object();
+            json_object_set_new(pBalance, "descriptor_share", json_real(share));
+            json_object_set_new(pBalance, "load_deviation", json_real(m_loads[i] - average_load));
+
+            json_t* pStats = json_object_get(json_object_get(m_data[i], CN_ATTRIBUTES), "stats");
+            json_object_set_new(pStats, "balance", pBalance);
+        }
+    }
+
+    vector<json_t*>  m_data;
+    vector<uint32_t> m_descriptors;
+    vector<int>      m_loads;
+    const char*      m_zHost;
 };
 
 class FunctionTask : public Worker::DisposableTask
@@ -18,18 +18,23 @@
 
 #include "internal/server.hh"
 
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 
+#include <algorithm>
 #include <string>
 #include <list>
 #include <mutex>
 #include <sstream>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include <maxbase/atomic.hh>
 #include <maxbase/stopwatch.hh>
@@ -48,9 +53,13 @@
 #include <maxscale/clock.h>
 #include <maxscale/http.hh>
 #include <maxscale/maxscale.h>
+#include <maxscale/modutil.h>
+#include <maxscale/secrets.h>
 #include <maxscale/server.hh>
 #include <maxscale/routingworker.hh>
+#include <maxscale/protocol/mysql.h>
 
+#include "internal/dcb.h"
 #include "internal/monitor.h"
 #include "internal/poll.hh"
 #include "internal/config.hh"
@@ -71,7 +80,9 @@ const char CN_MONITORPW[] = "monitorpw";
 const char CN_MONITORUSER[] = "monitoruser";
 const char CN_PERSISTMAXTIME[] = "persistmaxtime";
 const char CN_PERSISTPOOLMAX[] = "persistpoolmax";
+const char CN_PERSISTPOOLMIN[] = "persistpoolmin";
 const char CN_PROXY_PROTOCOL[] = "proxy_protocol";
+const char CN_COMPRESSION[] = "compression";
 
 static std::mutex server_lock;
 static std::list<Server*> all_servers;
@@ -160,8 +171,10 @@ SERVER* server_alloc(const char* name, MXS_CONFIG_PARAMETER* params)
     server->monuser[0] = '\0';
     server->monpw[0] = '\0';
     server->persistpoolmax = config_get_integer(params, CN_PERSISTPOOLMAX);
+    server->persistpoolmin = config_get_integer(params, CN_PERSISTPOOLMIN);
     server->persistmaxtime = config_get_integer(params, CN_PERSISTMAXTIME);
     server->proxy_protocol = config_get_bool(params, CN_PROXY_PROTOCOL);
+    server->compression = config_get_bool(params, CN_COMPRESSION);
     server->parameters = NULL;
     server->is_active = true;
     server->auth_instance = auth_instance;
@@ -186,6 +199,17 @@ SERVER* server_alloc(const char* name, MXS_CONFIG_PARAMETER* params)
     server->rlag_state = RLAG_NONE;
     server->disk_space_threshold = NULL;
 
+    if (server->persistpoolmin > server->persistpoolmax)
+    {
+        MXS_WARNING("The value of '%s' for server '%s' is larger than the value of '%s', "
+                    "using %ld instead.",
+                    CN_PERSISTPOOLMIN,
+                    name,
+                    CN_PERSISTPOOLMAX,
+                    server->persistpoolmax);
+        server->persistpoolmin = server->persistpoolmax;
+    }
+
     if (*monuser && *monpw)
     {
         server_add_mon_user(server, monuser, monpw);
@@ -265,15 +289,18 @@ DCB* server_get_persistent(SERVER* server, const char* user, const char* ip, con
         dcb = server->persistent[id];
         while (dcb)
         {
-            if (dcb->user
-                && dcb->protoname
-                && dcb->remote
-                && ip
+            // A prewarmed connection is not tied to a user and is taken by any session,
+            // the COM_CHANGE_USER sent when it is reused authenticates the user.
+            if (dcb->protoname
                 && !dcb->dcb_errhandle_called
-                && !(dcb->flags & DCBF_HUNG)
-                && 0 == strcmp(dcb->user, user)
-                && 0 == strcmp(dcb->remote, ip)
-                && 0 == strcmp(dcb->protoname, protocol))
+                && !(dcb->flags & (DCBF_HUNG | DCBF_POOL_PING))
+                && 0 == strcmp(dcb->protoname, protocol)
+                && ((dcb->flags & DCBF_PREWARMED)
+                    || (dcb->user
+                        && dcb->remote
+                        && ip
+                        && 0 == strcmp(dcb->user, user)
+                        && 0 == strcmp(dcb->remote, ip))))
             {
                 if (NULL == previous)
                 {
@@ -582,8 +609,11 @@ void dprintServer(DCB* dcb, const SERVER* srv)
         dcb_printf(dcb, "\tPersistent measured pool size:       %d\n", server->stats.n_persistent);
         dcb_printf(dcb, "\tPersistent actual size max:          %d\n", server->persistmax);
         dcb_printf(dcb, "\tPersistent pool size limit:          %ld\n", server->persistpoolmax);
+        dcb_printf(dcb, "\tPersistent pool minimum size:        %ld\n", server->persistpoolmin);
         dcb_printf(dcb, "\tPersistent max time (secs):          %ld\n", server->persistmaxtime);
         dcb_printf(dcb, "\tConnections taken from pool:         %lu\n", server->stats.n_from_pool);
+        dcb_printf(dcb, "\tConnections not found in pool:       %lu\n", server->stats.n_pool_misses);
+        dcb_printf(dcb, "\tPrewarmed connections:               %lu\n", server->stats.n_prewarmed);
         double d = (double)server->stats.n_from_pool / (double)(server->stats.n_connections
                                                                 + server->stats.n_from_pool + 1);
         dcb_printf(dcb, "\tPool availability:                   %0.2lf%%\n", d * 100.0);
@@ -613,6 +643,19 @@ void dprintServer(DCB* dcb, const SERVER* srv)
     {
         dcb_printf(dcb, "\tPROXY protocol:                      on.\n");
     }
+    if (server->stats.n_handshakes)
+    {
+        dcb_printf(dcb, "\tAverage handshake time (usecs):      %lu\n",
+                   server->stats.handshake_time / server->stats.n_handshakes);
+    }
+    if (server->compression)
+    {
+        dcb_printf(dcb, "\tCompressed bytes read:               %lu\n", server->stats.compressed_in);
+        dcb_printf(dcb, "\tDecompressed bytes read:             %lu\n", server->stats.uncompressed_in);
+        dcb_printf(dcb, "\tCompressed bytes written:            %lu\n", server->stats.compressed_out);
+        dcb_printf(dcb, "\tUncompressed bytes written:          %lu\n", server->stats.uncompressed_out);
+        dcb_printf(dcb, "\tCompression time (usecs):            %lu\n", server->stats.compression_time);
+    }
 }
 
 /**
@@ -1375,6 +1418,120 @@ bool mxs::server_clear_status(SERVER* srv, int bit, string* errmsg_out)
     return written;
 }
 
+namespace
+{
+
+/**
+ * Parse a MariaDB GTID list of the form "domain-server_id-sequence,...".
+ *
+ * @return True if the list could be parsed
+ */
+bool parse_gtid_pos(const std::string& str, Server::GtidPos* pPos)
+{
+    bool rval = true;
+    const char* z = str.c_str();
+
+    while (*z && rval)
+    {
+        char* end;
+        unsigned long domain = strtoul(z, &end, 10);
+
+        if (*end == '-' && end != z)
+        {
+            strtoul(end + 1, &end, 10);
+        }
+        else
+        {
+            rval = false;
+        }
+
+        if (rval && *end == '-')
+        {
+            z = end + 1;
+            unsigned long long seq = strtoull(z, &end, 10);
+
+            if (end != z && (*end == ',' || *end == '\0'))
+            {
+                uint64_t& current = (*pPos)[domain];
+                current = std::max(current, (uint64_t)seq);
+                z = *end ? end + 1 : end;
+
+                while (isspace(*z))
+                {
+                    ++z;
+                }
+            }
+            else
+            {
+                rval = false;
+            }
+        }
+        else
+        {
+            rval = false;
+        }
+    }
+
+    return rval;
+}
+}
+
+void mxs::server_set_gtid_pos(SERVER* srv, const std::string& gtid_pos)
+{
+    Server* server = static_cast<Server*>(srv);
+    Server::GtidPos pos;
+
+    if (!parse_gtid_pos(gtid_pos, &pos))
+    {
+        pos.clear();
+    }
+
+    std::lock_guard<std::mutex> guard(server->m_gtid_lock);
+    server->m_gtid_pos.swap(pos);
+}
+
+void mxs::server_advance_gtid_pos(SERVER* srv, const std::string& gtid_pos)
+{
+    Server* server = static_cast<Server*>(srv);
+    Server::GtidPos pos;
+
+    if (parse_gtid_pos(gtid_pos, &pos))
+    {
+        std::lock_guard<std::mutex> guard(server->m_gtid_lock);
+
+        for (const auto& domain : pos)
+        {
+            uint64_t& current = server->m_gtid_pos[domain.first];
+            current = std::max(current, domain.second);
+        }
+    }
+}
+
+bool mxs::server_has_gtid_pos(const SERVER* srv, const std::string& gtid_pos)
+{
+    const Server* server = static_cast<const Server*>(srv);
+    Server::GtidPos pos;
+    bool rval = parse_gtid_pos(gtid_pos, &pos) && !pos.empty();
+
+    if (rval)
+    {
+        std::lock_guard<std::mutex> guard(server->m_gtid_lock);
+
+        for (const auto& domain : pos)
+        {
+            auto it = server->m_gtid_pos.find(domain.first);
+
+            if (it == server->m_gtid_pos.end() || it->second < domain.second)
+            {
+                rval = false;
+                break;
+            }
+        }
+    }
+
+    return rval;
+}
+
 bool server_is_mxs_service(const SERVER* server)
 {
     bool rval = false;
@@ -1463,6 +1620,35 @@ static json_t* server_json_attributes(const SERVER* server)
     maxbase::Duration response_ave(server_response_time_average(server));
     json_object_set_new(stats, "adaptive_avg_select_time", json_string(to_string(response_ave).c_str()));
 
+    const SERVER_STATS& s = server->stats;
+    json_object_set_new(stats, "handshakes", json_integer(s.n_handshakes));
+    json_object_set_new(stats, "avg_handshake_time",
+                        json_integer(s.n_handshakes ? s.handshake_time / s.n_handshakes : 0));
+
+    if (server->persistpoolmax)
+    {
+        json_t* pool = json_object();
+        json_object_set_new(pool, "hits", json_integer(s.n_from_pool));
+        json_object_set_new(pool, "misses", json_integer(s.n_pool_misses));
+        json_object_set_new(pool, "prewarmed_connections", json_integer(s.n_prewarmed));
+        json_object_set_new(stats, "persistent_pool", pool);
+    }
+
+    if (server->compression)
+    {
+        json_t* compression = json_object();
+        json_object_set_new(compression, "compressed_bytes_read", json_integer(s.compressed_in));
+        json_object_set_new(compression, "decompressed_bytes_read", json_integer(s.uncompressed_in));
+        json_object_set_new(compression, "compressed_bytes_written", json_integer(s.compressed_out));
+        json_object_set_new(compression, "uncompressed_bytes_written", json_integer(s.uncompressed_out));
+        json_object_set_new(compression, "read_ratio",
+                            json_real(s.compressed_in ? (double)s.uncompressed_in / s.compressed_in : 0));
+        json_object_set_new(compression, "write_ratio",
+                            json_real(s.compressed_out ? (double)s.uncompressed_out / s.compressed_out : 0));
+        json_object_set_new(compression, "time", json_integer(s.compression_time));
+        json_object_set_new(stats, "compression", compression);
+    }
+
     json_object_set_new(attr, "statistics", stats);
 
     return attr;
@@ -1614,3 +1800,312 @@ void Server::response_time_add(double ave, int num_samples)
     m_response_time.set_sample_max(new_max);
     m_response_time.add(ave, num_samples);
 }
+
+namespace
+{
+
+/** How long a prewarmed connection may take to be established, in seconds. */
+const int PREWARM_TIMEOUT = 10;
+
+/** How long to wait before prewarming again after a failure, in seconds. */
+const int PREWARM_RETRY_DELAY = 10;
+
+/** How often the idle connections of a prewarmed pool are pinged, in seconds. */
+const int POOL_PING_INTERVAL = 60;
+
+struct PrewarmedDCB
+{
+    DCB*    dcb;        /** The backend DCB being connected. */
+    int64_t started;    /** When the connection was started. */
+};
+
+thread_local struct
+{
+    int64_t                                   next_check;   /** When to next check the pools. */
+    std::vector<PrewarmedDCB>                 pending;      /** Connections not yet established. */
+    std::unordered_map<const SERVER*, int64_t> retry_at;    /** When to retry after a failure. */
+} this_thread;
+
+bool can_prewarm(const SERVER* server)
+{
+    return server->persistpoolmin
+           && server->persistmaxtime
+           && !server->proxy_protocol
+           && server->is_active
+           && server_is_usable(server)
+           && (strcasecmp(server->protocol, "mariadbbackend") == 0
+               || strcasecmp(server->protocol, "mysqlbackend") == 0);
+}
+
+/**
+ * Close a prewarmed backend DCB and the internal session it was opened with
+ *
+ * @param dcb  The backend DCB
+ */
+void close_prewarmed(DCB* dcb)
+{
+    DCB* client = dcb->session->client_dcb;
+
+    // The service is kept alive by the client count until the session has been freed
+    mxb::atomic::add(&dcb->session->service->internal_count, -1);
+    dcb_close(dcb);
+
+    MXS_FREE(client->data);
+    client->data = NULL;
+    dcb_close(client);
+}
+
+/**
+ * Open a connection that is placed into the persistent pool once established
+ *
+ * The connection is opened with an internal session that uses the credentials
+ * of a service that uses the server. The user is changed with COM_CHANGE_USER
+ * when the connection is taken from the pool.
+ *
+ * @param server  The server to connect to
+ *
+ * @return The backend DCB or NULL on failure
+ */
+DCB* prewarm_connection(SERVER* server)
+{
+    DCB* dcb = NULL;
+    Service* service = service_reserve_for_server(server);
+
+    if (service)
+    {
+        DCB* client = dcb_alloc(DCB_ROLE_INTERNAL, NULL);
+        MYSQL_session* data = (MYSQL_session*)MXS_CALLOC(1, sizeof(MYSQL_session));
+        const char* user;
+        const char* password;
+        serviceGetUser(service, &user, &password);
+        char* decrypted = decrypt_password(password);
+
+        if (client && data && decrypted && strlen(user) <= MYSQL_USER_MAXLEN)
+        {
+            strcpy(data->user, user);
+            gw_sha1_str((const uint8_t*)decrypted, strlen(decrypted), data->client_sha1);
+
+            client->state = DCB_STATE_POLLING;
+            client->data = data;
+            client->service = service;
+            client->poll.owner = RoutingWorker::get_current();
+            data = NULL;
+
+            // The client DCB has no user so dcb_connect always opens a new connection.
+            MXS_SESSION* session = session_alloc(service, client);
+
+            if (session)
+            {
+                client->session = session;
+                dcb = dcb_connect(server, session, server->protocol);
+            }
+
+            if (dcb)
+            {
+                dcb->user = MXS_STRDUP_A(user);
+                dcb->flags |= DCBF_PREWARMED;
+            }
+            else
+            {
+                MXS_FREE(client->data);
+                client->data = NULL;
+                dcb_close(client);
+                mxb::atomic::add(&service->internal_count, -1);
+
+                if (!session)
+                {
+                    // Without a session, nothing releases the reservation
+                    mxb::atomic::add(&service->client_count, -1);
+                }
+            }
+        }
+        else
+        {
+            if (client)
+            {
+                dcb_free_all_memory(client);
+            }
+
+            mxb::atomic::add(&service->internal_count, -1);
+            mxb::atomic::add(&service->client_count, -1);
+        }
+
+        MXS_FREE(data);
+        MXS_FREE(decrypted);
+    }
+
+    return dcb;
+}
+
+/**
+ * Place the established prewarmed connections into the persistent pool and
+ * close the ones that failed.
+ *
+ * @param id   The id of the current routing worker
+ * @param now  The current time
+ */
+void process_pending(int id, int64_t now)
+{
+    auto& pending = this_thread.pending;
+
+    for (auto it = pending.begin(); it != pending.end();)
+    {
+        DCB* dcb = it->dcb;
+        SERVER* server = dcb->server;
+
+        if (!dcb->dcb_errhandle_called && dcb->func.established(dcb))
+        {
+            // Marking the connection as idle allows it to be pooled even though
+            // the session was never used.
+            dcb->flags |= DCBF_IDLE;
+            close_prewarmed(dcb);
+
+            if (server->persistent[id] == dcb)
+            {
+                mxb::atomic::add(&server->stats.n_prewarmed, 1, mxb::atomic::RELAXED);
+            }
+
+            it = pending.erase(it);
+        }
+        else if (dcb->dcb_errhandle_called || now - it->started > MXS_SEC_TO_CLOCK(PREWARM_TIMEOUT))
+        {
+            MXS_WARNING("Failed to open a connection to '%s' for the persistent pool, "
+                        "retrying in %d seconds.",
+                        server->name,
+                        PREWARM_RETRY_DELAY);
+            this_thread.retry_at[server] = now + MXS_SEC_TO_CLOCK(PREWARM_RETRY_DELAY);
+            close_prewarmed(dcb);
+            it = pending.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+/**
+ * Ping the idle connections in the persistent pool of a server
+ *
+ * The reply to the ping is read by the protocol module. A connection whose
+ * reply does not arrive in time is marked as failed and is evicted from the
+ * pool by the next clean-up.
+ *
+ * @param server  The server
+ * @param id      The id of the current routing worker
+ * @param now     The current time
+ */
+void ping_pooled_connections(SERVER* server, int id, int64_t now)
+{
+    for (DCB* dcb = server->persistent[id]; dcb; dcb = dcb->nextpersistent)
+    {
+        if (dcb->dcb_errhandle_called)
+        {
+            continue;
+        }
+
+        if (dcb->flags & DCBF_POOL_PING)
+        {
+            if (now - dcb->last_read > MXS_SEC_TO_CLOCK(2 * POOL_PING_INTERVAL))
+            {
+                dcb->dcb_errhandle_called = true;
+            }
+        }
+        else if (now - dcb->last_read >= MXS_SEC_TO_CLOCK(POOL_PING_INTERVAL))
+        {
+            dcb->flags |= DCBF_POOL_PING;
+
+            if (!modutil_ignorable_ping(dcb))
+            {
+                dcb->dcb_errhandle_called = true;
+            }
+        }
+    }
+}
+
+/**
+ * Open connections until the persistent pool of a server has the minimum
+ * number of connections. The connections being opened count towards the
+ * minimum and the total size of the pool is limited by persistpoolmax.
+ *
+ * @param server  The server
+ * @param id      The id of the current routing worker
+ * @param now     The current time
+ */
+void fill_pool(SERVER* server, int id, int64_t now)
+{
+    auto it = this_thread.retry_at.find(server);
+
+    if (it != this_thread.retry_at.end())
+    {
+        if (now < it->second)
+        {
+            return;
+        }
+
+        this_thread.retry_at.erase(it);
+    }
+
+    long n_pending = std::count_if(this_thread.pending.begin(),
+                                   this_thread.pending.end(),
+                                   [server](const PrewarmedDCB& p) {
+                                       return p.dcb->server == server;
+                                   });
+
+    long n_pooled = dcb_persistent_clean_count(server->persistent[id], id, false);
+    long n_missing = std::min(server->persistpoolmin - n_pooled,
+                              server->persistpoolmax - mxb::atomic::load(&server->stats.n_persistent))
+        - n_pending;
+
+    for (long i = 0; i < n_missing; i++)
+    {
+        DCB* dcb = prewarm_connection(server);
+
+        if (!dcb)
+        {
+            MXS_WARNING("Failed to open a connection to '%s' for the persistent pool, "
+                        "retrying in %d seconds.",
+                        server->name,
+                        PREWARM_RETRY_DELAY);
+            this_thread.retry_at[server] = now + MXS_SEC_TO_CLOCK(PREWARM_RETRY_DELAY);
+            break;
+        }
+
+        this_thread.pending.push_back({dcb, now});
+    }
+}
+}
+
+void server_process_persistent_pools(int id)
+{
+    int64_t now = mxs_clock();
+
+    if (now < this_thread.next_check)
+    {
+        return;
+    }
+
+    this_thread.next_check = now + MXS_SEC_TO_CLOCK(1);
+
+    process_pending(id, now);
+
+    std::vector<SERVER*> servers;
+
+    {
+        Guard guard(server_lock);
+
+        for (Server* server : all_servers)
+        {
+            if (can_prewarm(server))
+            {
+                servers.push_back(server);
+            }
+        }
+    }
+
+    for (SERVER* server : servers)
+    {
+        ping_pooled_connections(server, id, now);
+        fill_pool(server, id, now);
+    }
+}
@@ -169,6 +169,7 @@ Service::Service(const std::string& service_name,
     router = (MXS_ROUTER_OBJECT*)module->module_object;
     capabilities = module->module_capabilities;
     client_count = 0;
+    internal_count = 0;
     n_dbref = 0;
     // TODO: Remove once the name and router module are not directly visible to modules
     name = m_name.c_str();
@@ -1788,6 +1789,31 @@ bool service_server_in_use(const SERVER* server)
     return false;
 }
 
+Service* service_reserve_for_server(const SERVER* server)
+{
+    LockGuard guard(this_unit.lock);
+
+    for (Service* service : this_unit.services)
+    {
+        LockGuard guard(service->lock);
+
+        if (service->active)
+        {
+            for (SERVER_REF* ref = service->dbref; ref; ref = ref->next)
+            {
+                if (ref->active && ref->server == server)
+                {
+                    mxb::atomic::add(&service->client_count, 1);
+                    mxb::atomic::add(&service->internal_count, 1);
+                    return service;
+                }
+            }
+        }
+    }
+
+    return NULL;
+}
+
 bool service_filter_in_use(const SFilterDef& filter)
 {
     mxb_assert(filter);
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include <maxscale/ccdefs.hh>
+
+#include <stdlib.h>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <maxscale/buffer.hh>
+#include <maxscale/modutil.hh>
+#include <maxscale/protocol/mysql.h>
+
+using namespace std;
+
+namespace
+{
+
+/**
+ * Create a COM_QUERY packet.
+ *
+ * @param sql         The SQL of the packet.
+ * @param chunk_size  If non-zero, the packet is split into buffers of at
+ *                    most this size, otherwise it is a single buffer.
+ *
+ * @return The packet.
+ */
+GWBUF* create_packet(const string& sql, size_t chunk_size)
+{
+    GWBUF* pPacket = modutil_create_query(sql.c_str());
+
+    if (chunk_size)
+    {
+        GWBUF* pContiguous = pPacket;
+        const uint8_t* pData = GWBUF_DATA(pContiguous);
+        size_t len = GWBUF_LENGTH(pContiguous);
+        pPacket = NULL;
+
+        for (size_t i = 0; i < len; i += chunk_size)
+        {
+            pPacket = gwbuf_append(pPacket, gwbuf_alloc_and_load(min(chunk_size, len - i), pData + i));
+        }
+
+        gwbuf_free(pContiguous);
+    }
+
+    return pPacket;
+}
+
+vector<string> read_statements(int argc, char* argv[])
+{
+    vector<string> statements;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        ifstream in(argv[i]);
+
+        if (!in)
+        {
+            cerr << "error: Could not open " << argv[i] << "." << endl;
+        }
+
+        for (string line; getline(in, line);)
+        {
+            if (!line.empty())
+            {
+                statements.push_back(line);
+            }
+        }
+    }
+
+    return statements;
+}
+
+/**
+ * Check that contiguous and fragmented packets produce the same canonical
+ * form and fingerprint.
+ */
+int test_equivalence(const vector<string>& statements)
+{
+    int rv = 0;
+
+    for (const string& sql : statements)
+    {
+        GWBUF* pContiguous = create_packet(sql, 0);
+        uint64_t contiguous_fingerprint;
+        string contiguous = mxs::get_canonical(pContiguous, &contiguous_fingerprint);
+
+        for (size_t chunk_size : {1, 3, 17})
+        {
+            GWBUF* pFragmented = create_packet(sql, chunk_size);
+            uint64_t fragmented_fingerprint;
+            string fragmented = mxs::get_canonical(pFragmented, &fragmented_fingerprint);
+
+            if (contiguous != fragmented || contiguous_fingerprint != fragmented_fingerprint)
+            {
+                cerr << "error: Canonical forms of '" << sql << "' differ, contiguous: '" << contiguous
+                     << "', fragmented into " << chunk_size << " byte buffers: '" << fragmented << "'." << endl;
+                ++rv;
+            }
+
+            gwbuf_free(pFragmented);
+        }
+
+        gwbuf_free(pContiguous);
+    }
+
+    return rv;
+}
+
+double statements_per_second(const vector<GWBUF*>& packets, int n_rounds)
+{
+    auto start = chrono::steady_clock::now();
+    size_t total = 0;
+
+    for (int i = 0; i < n_rounds; ++i)
+    {
+        for (GWBUF* pPacket : packets)
+        {
+            uint64_t fingerprint;
+            total += mxs::get_canonical(pPacket, &fingerprint).length();
+        }
+    }
+
+    chrono::duration<double> secs = chrono::steady_clock::now() - start;
+
+    return total && secs.count() > 0 ? packets.size() * n_rounds / secs.count() : 0;
+}
+
+void benchmark(const vector<string>& statements, int n_rounds)
+{
+    vector<GWBUF*> contiguous;
+    vector<GWBUF*> fragmented;
+
+    for (const string& sql : statements)
+    {
+        contiguous.push_back(create_packet(sql, 0));
+        fragmented.push_back(create_packet(sql, 64));
+    }
+
+    double contiguous_rate = statements_per_second(contiguous, n_rounds);
+    double fragmented_rate = statements_per_second(fragmented, n_rounds);
+
+    cout << statements.size() << " statements, " << n_rounds << " rounds: "
+         << (int)contiguous_rate << " statements/s contiguous, "
+         << (int)fragmented_rate << " statements/s fragmented." << endl;
+
+    for (GWBUF* pPacket : contiguous)
+    {
+        gwbuf_free(pPacket);
+    }
+
+    for (GWBUF* pPacket : fragmented)
+    {
+        gwbuf_free(pPacket);
+    }
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int rv = EXIT_FAILURE;
+
+    if (argc < 2)
+    {
+        cout << "Usage: canonical_bench <file>..." << endl;
+    }
+    else
+    {
+        vector<string> statements = read_statements(argc, argv);
+
+        if (!statements.empty())
+        {
+            rv = test_equivalence(statements) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+            benchmark(statements, 1000);
+        }
+    }
+
+    return rv;
+}
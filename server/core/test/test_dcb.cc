@@ -33,6 +33,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 #include <maxscale/config.h>
 #include <maxscale/listener.h>
@@ -69,6 +71,121 @@ static int test1()
     return 0;
 }
 
+/**
+ * Read packets of a given size through a DCB and report the number of system
+ * calls needed per packet.
+ *
+ * @param dcb        A DCB whose descriptor is one end of a socket pair
+ * @param fd         The other end of the socket pair
+ * @param size       The size of a packet
+ * @param n_packets  How many packets to read
+ * @return           The number of system calls per packet, or -1 on error
+ */
+static double read_packets(DCB* dcb, int fd, int size, int n_packets)
+{
+    uint8_t* packet = (uint8_t*)MXS_MALLOC(size);
+    int n_syscalls = 0;
+    int n_reads = 0;
+    int n_ioctls = 0;
+
+    for (int i = 0; i < size; ++i)
+    {
+        packet[i] = i;
+    }
+
+    for (int i = 0; i < n_packets && n_syscalls != -1; ++i)
+    {
+        DCBSTATS before = dcb->stats;
+        GWBUF* head = NULL;
+
+        if (write(fd, packet, size) != size
+            || dcb_read(dcb, &head, 0) != size
+            || gwbuf_length(head) != (size_t)size)
+        {
+            fprintf(stderr, "\nFailed to read packet %d of %d bytes.\n", i, size);
+            n_syscalls = -1;
+        }
+        else
+        {
+            head = gwbuf_make_contiguous(head);
+
+            if (memcmp(GWBUF_DATA(head), packet, size) != 0)
+            {
+                fprintf(stderr, "\nPacket %d of %d bytes was corrupted.\n", i, size);
+                n_syscalls = -1;
+            }
+            else
+            {
+                n_reads += dcb->stats.n_reads - before.n_reads;
+                n_ioctls += dcb->stats.n_ioctls - before.n_ioctls;
+                n_syscalls = n_reads + n_ioctls;
+            }
+        }
+
+        gwbuf_free(head);
+    }
+
+    MXS_FREE(packet);
+
+    if (n_syscalls != -1)
+    {
+        fprintf(stderr,
+                "\t%6d byte packets: %.2f syscalls per packet (%d reads, %d FIONREADs), read size %d\n",
+                size,
+                (double)n_syscalls / n_packets,
+                n_reads,
+                n_ioctls,
+                dcb->read_size);
+    }
+
+    return n_syscalls == -1 ? -1 : (double)n_syscalls / n_packets;
+}
+
+/**
+ * test2    Read through a DCB and count the system calls per packet
+ *
+ */
+static int test2()
+{
+    int rval = 0;
+    int fds[2];
+    SERV_LISTENER dummy;
+
+    fprintf(stderr, "testdcb : reading from a socket pair\n");
+
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) != 0)
+    {
+        fprintf(stderr, "Failed to create socket pair: %d, %s\n", errno, mxs_strerror(errno));
+        return 1;
+    }
+
+    DCB* dcb = dcb_alloc(DCB_ROLE_INTERNAL, &dummy);
+    dcb->fd = fds[0];
+
+    // Small packets, such as most queries, are read with one system call each,
+    // and larger ones adapt the read size so that the count stays small.
+    double small = read_packets(dcb, fds[1], 64, 10000);
+    double medium = read_packets(dcb, fds[1], 4096, 10000);
+    double large = read_packets(dcb, fds[1], 65536, 1000);
+
+    if (small != 1 || medium == -1 || large == -1)
+    {
+        fprintf(stderr, "Unexpected number of system calls.\n");
+        rval = 1;
+    }
+
+    fprintf(stderr, "\t..done\n");
+
+    dcb->fd = DCBFD_CLOSED;
+    close(fds[0]);
+    close(fds[1]);
+    dcb->state = DCB_STATE_POLLING;
+    this_thread.current_dcb = dcb;
+    dcb_close(dcb);
+
+    return rval;
+}
+
 int main(int argc, char** argv)
 {
     int result = 0;
@@ -76,6 +193,7 @@ int main(int argc, char** argv)
     init_test_env(NULL);
 
     result += test1();
+    result += test2();
 
     exit(result);
 }
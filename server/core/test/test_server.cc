@@ -176,6 +176,35 @@ bool test_serialize()
     return true;
 }
 
+bool test_gtid_pos()
+{
+    SERVER* server = server_alloc("gtid-server", params.params());
+    TEST(server, "Server allocation failed");
+
+    TEST(!mxs::server_has_gtid_pos(server, "0-1-10"), "Position should be unknown");
+
+    mxs::server_set_gtid_pos(server, "0-1-10,1-2-5");
+    TEST(mxs::server_has_gtid_pos(server, "0-1-10"), "Position should be reached");
+    TEST(mxs::server_has_gtid_pos(server, "0-3-9,1-2-5"), "Positions of both domains should be reached");
+    TEST(!mxs::server_has_gtid_pos(server, "0-1-11"), "Position should not be reached");
+    TEST(!mxs::server_has_gtid_pos(server, "2-1-1"), "Unknown domain should not be reached");
+    TEST(!mxs::server_has_gtid_pos(server, "garbage"), "Invalid position should not be reached");
+
+    mxs::server_advance_gtid_pos(server, "0-1-20");
+    TEST(mxs::server_has_gtid_pos(server, "0-1-20,1-2-5"), "Position should be advanced");
+    mxs::server_advance_gtid_pos(server, "0-1-15");
+    TEST(mxs::server_has_gtid_pos(server, "0-1-20"), "Position should not move backwards");
+
+    mxs::server_set_gtid_pos(server, "0-1-12");
+    TEST(!mxs::server_has_gtid_pos(server, "0-1-20"), "Position should be replaced");
+    TEST(!mxs::server_has_gtid_pos(server, "1-2-1"), "Domain should be forgotten");
+
+    mxs::server_set_gtid_pos(server, "");
+    TEST(!mxs::server_has_gtid_pos(server, "0-1-1"), "Position should be cleared");
+
+    return true;
+}
+
 int main(int argc, char** argv)
 {
     /**
@@ -198,6 +227,11 @@ int main(int argc, char** argv)
         result++;
     }
 
+    if (!test_gtid_pos())
+    {
+        result++;
+    }
+
     mxs_log_finish();
     exit(result);
 }
@@ -16,6 +16,7 @@
  */
 
 #include "mysql_auth.h"
+#include "userindex.hh"
 
 #include <ctype.h>
 #include <netdb.h>
@@ -242,40 +243,9 @@ static bool check_password(const char* output,
     return memcmp(final_step, stored_token, stored_token_len) == 0;
 }
 
-/** Callback for check_database() */
-static int database_cb(void* data, int columns, char** rows, char** row_names)
+static bool check_database(const UserIndex& index, const char* database)
 {
-    bool* rval = (bool*)data;
-    *rval = true;
-    return 0;
-}
-
-static bool check_database(MYSQL_AUTH* instance, sqlite3* handle, const char* database)
-{
-    bool rval = true;
-
-    if (*database)
-    {
-        rval = false;
-        const char* query = instance->lower_case_table_names ?
-            mysqlauth_validate_database_query_lower :
-            mysqlauth_validate_database_query;
-        size_t len = strlen(query) + strlen(database) + 1;
-        char sql[len];
-
-        sprintf(sql, query, database);
-
-        char* err;
-
-        if (sqlite3_exec(handle, sql, database_cb, &rval, &err) != SQLITE_OK)
-        {
-            MXS_ERROR("Failed to execute auth query: %s", err);
-            sqlite3_free(err);
-            rval = false;
-        }
-    }
-
-    return rval;
+    return !*database || index.has_database(database);
 }
 
 static bool no_password_required(const char* result, size_t tok_len)
@@ -283,20 +253,24 @@ static bool no_password_required(const char* result, size_t tok_len)
     return *result == '\0' && tok_len == 0;
 }
 
-/** Used to detect empty result sets */
-struct user_query_result
+bool update_user_index(MYSQL_AUTH* instance)
 {
-    bool ok;
-    char output[SHA_DIGEST_LENGTH * 2 + 1];
-};
+    std::shared_ptr<const UserIndex> sIndex(UserIndex::create(get_handle(instance),
+                                                              instance->lower_case_table_names));
 
-/** @brief Callback for sqlite3_exec() */
-static int auth_cb(void* data, int columns, char** rows, char** row_names)
+    if (sIndex)
+    {
+        // The index of the calling worker is updated immediately, the
+        // indexes of the other workers when they next get to run.
+        instance->index->assign(sIndex);
+    }
+
+    return sIndex.get() != NULL;
+}
+
+std::shared_ptr<const UserIndex> get_user_index(MYSQL_AUTH* instance)
 {
-    struct user_query_result* res = (struct user_query_result*)data;
-    strcpy(res->output, rows[0] ? rows[0] : "");
-    res->ok = true;
-    return 0;
+    return **instance->index;
 }
 
 int validate_mysql_user(MYSQL_AUTH* instance,
@@ -305,88 +279,53 @@ int validate_mysql_user(MYSQL_AUTH* instance,
                         uint8_t* scramble,
                         size_t   scramble_len)
 {
-    sqlite3* handle = get_handle(instance);
-    const char* validate_query = instance->lower_case_table_names ?
-        mysqlauth_validate_user_query_lower :
-        mysqlauth_validate_user_query;
-    size_t len = strlen(validate_query) + 1 + strlen(session->user) * 2
-        + strlen(session->db) * 2 + MYSQL_HOST_MAXLEN + session->auth_token_len * 4 + 1;
-    char sql[len + 1];
+    std::shared_ptr<const UserIndex> sIndex = get_user_index(instance);
     int rval = MXS_AUTH_FAILED;
-    char* err;
 
-    if (instance->skip_auth)
-    {
-        sprintf(sql, mysqlauth_skip_auth_query, session->user, session->db, session->db);
-    }
-    else
+    if (!sIndex)
     {
-        sprintf(sql,
-                validate_query,
-                session->user,
-                dcb->remote,
-                dcb->remote,
-                session->db,
-                session->db);
+        // The users have not been loaded yet.
+        return rval;
     }
 
-    struct user_query_result res = {};
+    std::string password;
+    bool found;
 
-    if (sqlite3_exec(handle, sql, auth_cb, &res, &err) != SQLITE_OK)
+    if (instance->skip_auth)
     {
-        MXS_ERROR("Failed to execute auth query: %s", err);
-        sqlite3_free(err);
+        found = sIndex->find(session->user, NULL, session->db, &password);
     }
-
-    /** Check for IPv6 mapped IPv4 address */
-    if (!res.ok && strchr(dcb->remote, ':') && strchr(dcb->remote, '.'))
+    else
     {
-        const char* ipv4 = strrchr(dcb->remote, ':') + 1;
-        sprintf(sql,
-                validate_query,
-                session->user,
-                ipv4,
-                ipv4,
-                session->db,
-                session->db);
-
-        if (sqlite3_exec(handle, sql, auth_cb, &res, &err) != SQLITE_OK)
+        found = sIndex->find(session->user, dcb->remote, session->db, &password);
+
+        /** Check for IPv6 mapped IPv4 address */
+        if (!found && strchr(dcb->remote, ':') && strchr(dcb->remote, '.'))
         {
-            MXS_ERROR("Failed to execute auth query: %s", err);
-            sqlite3_free(err);
+            const char* ipv4 = strrchr(dcb->remote, ':') + 1;
+            found = sIndex->find(session->user, ipv4, session->db, &password);
         }
-    }
 
-    if (!res.ok)
-    {
         /**
          * Try authentication with the hostname instead of the IP. We do this only
-         * as a last resort so we avoid the high cost of the DNS lookup.
+         * as a last resort so we avoid the high cost of the DNS lookup. If there
+         * are no grants for the user, the lookup would be pointless.
          */
-        char client_hostname[MYSQL_HOST_MAXLEN] = "";
-        get_hostname(dcb, client_hostname, sizeof(client_hostname) - 1);
-
-        sprintf(sql,
-                validate_query,
-                session->user,
-                client_hostname,
-                client_hostname,
-                session->db,
-                session->db);
-
-        if (sqlite3_exec(handle, sql, auth_cb, &res, &err) != SQLITE_OK)
+        if (!found && sIndex->has_user(session->user))
         {
-            MXS_ERROR("Failed to execute auth query: %s", err);
-            sqlite3_free(err);
+            char client_hostname[MYSQL_HOST_MAXLEN] = "";
+            get_hostname(dcb, client_hostname, sizeof(client_hostname) - 1);
+
+            found = sIndex->find(session->user, client_hostname, session->db, &password);
         }
     }
 
-    if (res.ok)
+    if (found)
     {
         /** Found a matching row */
 
-        if (no_password_required(res.output, session->auth_token_len)
-            || check_password(res.output,
+        if (no_password_required(password.c_str(), session->auth_token_len)
+            || check_password(password.c_str(),
                               session->auth_token,
                               session->auth_token_len,
                               scramble,
@@ -394,7 +333,7 @@ int validate_mysql_user(MYSQL_AUTH* instance,
                               session->client_sha1))
         {
             /** Password is OK, check that the database exists */
-            if (check_database(instance, handle, session->db))
+            if (check_database(*sIndex, session->db))
             {
                 rval = MXS_AUTH_SUCCEEDED;
             }
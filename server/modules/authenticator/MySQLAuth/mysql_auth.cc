@@ -26,7 +26,9 @@
  */
 
 #include "mysql_auth.h"
+#include "userindex.hh"
 
+#include <new>
 #include <maxscale/protocol/mysql.h>
 #include <maxscale/authenticator.h>
 #include <maxscale/alloc.h>
@@ -182,7 +184,8 @@ static void* mysql_auth_init(char** options)
     MYSQL_AUTH* instance = static_cast<MYSQL_AUTH*>(MXS_MALLOC(sizeof(*instance)));
 
     if (instance
-        && (instance->handles = static_cast<sqlite3**>(MXS_CALLOC(config_threadcount(), sizeof(sqlite3*)))))
+        && (instance->handles = static_cast<sqlite3**>(MXS_CALLOC(config_threadcount(), sizeof(sqlite3*))))
+        && (instance->index = new(std::nothrow) mxs::rworker_local<std::shared_ptr<const UserIndex>>()))
     {
         bool error = false;
         instance->cache_dir = NULL;
@@ -234,6 +237,7 @@ static void* mysql_auth_init(char** options)
 
         if (error)
         {
+            delete instance->index;
             MXS_FREE(instance->cache_dir);
             MXS_FREE(instance->handles);
             MXS_FREE(instance);
@@ -242,6 +246,7 @@ static void* mysql_auth_init(char** options)
     }
     else if (instance)
     {
+        MXS_FREE(instance->handles);
         MXS_FREE(instance);
         instance = NULL;
     }
@@ -812,6 +817,18 @@ static int mysql_auth_load_users(SERV_LISTENER* port)
         }
     }
 
+    if (loaded < 0 && !injected && get_user_index(instance))
+    {
+        /** The index is shared by all workers, so the users loaded by an earlier
+         * refresh are kept instead of publishing the empty result of a failed one */
+        MXS_INFO("[%s] Keeping the previously loaded users of listener %s.", service->name, port->name);
+    }
+    else if (!update_user_index(instance))
+    {
+        MXS_ERROR("[%s] Failed to index the users of listener %s.", service->name, port->name);
+        rc = MXS_AUTH_LOADUSERS_ERROR;
+    }
+
     if (injected)
     {
         if (service_has_servers(service))
@@ -871,58 +888,36 @@ int mysql_auth_reauthenticate(DCB* dcb,
     return rval;
 }
 
-int diag_cb(void* data, int columns, char** row, char** field_names)
-{
-    DCB* dcb = (DCB*)data;
-    dcb_printf(dcb, "%s@%s ", row[0], row[1]);
-    return 0;
-}
-
 void mysql_auth_diagnostic(DCB* dcb, SERV_LISTENER* port)
 {
     MYSQL_AUTH* instance = (MYSQL_AUTH*)port->auth_instance;
-    sqlite3* handle = get_handle(instance);
-    char* err;
+    std::shared_ptr<const UserIndex> sIndex = get_user_index(instance);
 
-    if (sqlite3_exec(handle,
-                     "SELECT user, host FROM " MYSQLAUTH_USERS_TABLE_NAME,
-                     diag_cb,
-                     dcb,
-                     &err) != SQLITE_OK)
+    if (sIndex)
     {
-        dcb_printf(dcb, "Could not access users: %s", err);
-        MXS_ERROR("Could not access users: %s", err);
-        sqlite3_free(err);
+        for (const auto& user_host : sIndex->user_hosts())
+        {
+            dcb_printf(dcb, "%s@%s ", user_host.first.c_str(), user_host.second.c_str());
+        }
     }
 }
 
-int diag_cb_json(void* data, int columns, char** row, char** field_names)
-{
-    json_t* obj = json_object();
-    json_object_set_new(obj, "user", json_string(row[0]));
-    json_object_set_new(obj, "host", json_string(row[1]));
-
-    json_t* arr = (json_t*)data;
-    json_array_append_new(arr, obj);
-    return 0;
-}
-
 json_t* mysql_auth_diagnostic_json(const SERV_LISTENER* port)
 {
     json_t* rval = json_array();
 
     MYSQL_AUTH* instance = (MYSQL_AUTH*)port->auth_instance;
-    char* err;
-    sqlite3* handle = get_handle(instance);
+    std::shared_ptr<const UserIndex> sIndex = get_user_index(instance);
 
-    if (sqlite3_exec(handle,
-                     "SELECT user, host FROM " MYSQLAUTH_USERS_TABLE_NAME,
-                     diag_cb_json,
-                     rval,
-                     &err) != SQLITE_OK)
+    if (sIndex)
     {
-        MXS_ERROR("Failed to print users: %s", err);
-        sqlite3_free(err);
+        for (const auto& user_host : sIndex->user_hosts())
+        {
+            json_t* obj = json_object();
+            json_object_set_new(obj, "user", json_string(user_host.first.c_str()));
+            json_object_set_new(obj, "host", json_string(user_host.second.c_str()));
+            json_array_append_new(rval, obj);
+        }
     }
 
     return rval;
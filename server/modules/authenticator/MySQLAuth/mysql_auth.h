@@ -35,6 +35,11 @@
 #include <maxscale/service.h>
 #include <maxscale/sqlite3.h>
 #include <maxscale/protocol/mysql.h>
+#include <maxscale/routingworker.hh>
+
+#include <memory>
+
+class UserIndex;
 
 MXS_BEGIN_DECLS
 
@@ -120,6 +125,7 @@ typedef struct mysql_auth
     bool      skip_auth;            /**< Authentication will always be successful */
     bool      check_permissions;
     bool      lower_case_table_names;   /**< Disable database case-sensitivity */
+    mxs::rworker_local<std::shared_ptr<const UserIndex>>* index; /**< The user index of each worker */
 } MYSQL_AUTH;
 
 /**
@@ -219,3 +225,25 @@ int validate_mysql_user(MYSQL_AUTH* instance,
                         size_t   scramble_len);
 
 MXS_END_DECLS
+
+/**
+ * @brief Index the users of the calling worker and make the index
+ * available to all workers
+ *
+ * Must be called whenever the users have been reloaded. As the index replaces
+ * the users of every worker, it should not be called if the loading failed.
+ *
+ * @param instance MySQLAuth instance
+ *
+ * @return True, if the users could be indexed
+ */
+bool update_user_index(MYSQL_AUTH* instance);
+
+/**
+ * @brief Get the user index of the calling worker
+ *
+ * @param instance MySQLAuth instance
+ *
+ * @return The index, or NULL if the users have not been loaded yet
+ */
+std::shared_ptr<const UserIndex> get_user_index(MYSQL_AUTH* instance);
@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "../mysql_auth.h"
+#include "../userindex.hh"
+#include <stdlib.h>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+
+// A spread of host patterns resembling what is found in mysql.user, including
+// netmasks merged by merge_netmask().
+const char* HOSTS[] =
+{
+    "%",
+    "localhost",
+    "127.0.0.1",
+    "192.168.%",
+    "10.0.%.1",
+    "10.0._.2",
+    "app-%.example.com",
+};
+
+const int N_HOSTS = sizeof(HOSTS) / sizeof(HOSTS[0]);
+
+// Databases, including grant patterns.
+const char* DBS[] =
+{
+    "test",
+    "Sales",
+    "app\\_%",
+    "app_db",
+};
+
+const int N_DBS = sizeof(DBS) / sizeof(DBS[0]);
+
+struct LOGIN
+{
+    string user;
+    string host;
+    string db;
+};
+
+bool exec(sqlite3* handle, const string& sql, int (* cb)(void*, int, char**, char**) = NULL, void* data = NULL)
+{
+    char* err;
+    bool rv = sqlite3_exec(handle, sql.c_str(), cb, data, &err) == SQLITE_OK;
+
+    if (!rv)
+    {
+        cerr << "error: " << err << ": " << sql << endl;
+        sqlite3_free(err);
+    }
+
+    return rv;
+}
+
+int password_cb(void* data, int columns, char** rows, char** row_names)
+{
+    string* pPassword = static_cast<string*>(data);
+    *pPassword = rows[0] ? rows[0] : "";
+    return 0;
+}
+
+string user_name(int i)
+{
+    stringstream ss;
+    ss << "user" << i;
+    return ss.str();
+}
+
+bool insert_user(sqlite3* handle, const char* zUser, const char* zHost, const char* zDb,
+                 bool anydb, const char* zPassword)
+{
+    char sql[sizeof(insert_user_query) + 512];
+    sprintf(sql, insert_user_query, zUser, zHost, zDb, anydb ? "1" : "0", zPassword);
+
+    return exec(handle, sql);
+}
+
+bool populate(sqlite3* handle, int n_users)
+{
+    bool rv = exec(handle, users_create_sql) && exec(handle, databases_create_sql);
+
+    for (int i = 0; rv && i < n_users; ++i)
+    {
+        string user = user_name(i);
+
+        // Each user has a few hosts, with or without global access and grants on a few databases.
+        for (int j = 0; rv && j < 3; ++j)
+        {
+            const char* zHost = HOSTS[(i + j) % N_HOSTS];
+            bool anydb = (i + j) % 5 == 0;
+            string password = (i % 7 == 0) ? "NULL" : "'" + user + "_" + zHost + "'";
+
+            for (int k = 0; rv && k < 2; ++k)
+            {
+                string db = (i + k) % 4 == 3 ? "NULL" : string("'") + DBS[(i + j + k) % N_DBS] + "'";
+
+                rv = insert_user(handle, user.c_str(), zHost, db.c_str(), anydb, password.c_str());
+            }
+        }
+    }
+
+    for (int i = 0; rv && i < N_DBS; ++i)
+    {
+        char sql[sizeof(insert_database_query) + 64];
+        sprintf(sql, insert_database_query, DBS[i]);
+
+        rv = exec(handle, sql);
+    }
+
+    return rv;
+}
+
+vector<LOGIN> create_logins(int n_users, int n_logins)
+{
+    const char* hosts[] =
+    {
+        "127.0.0.1", "192.168.0.17", "10.0.4.1", "10.0.4.2", "10.0.44.2",
+        "172.16.0.1", "app-1.example.com", "APP-2.example.COM", "localhost", ""
+    };
+    const int n_hosts = sizeof(hosts) / sizeof(hosts[0]);
+
+    const char* dbs[] =
+    {
+        "", "test", "TEST", "sales", "app_1", "appxdb", "other"
+    };
+    const int n_dbs = sizeof(dbs) / sizeof(dbs[0]);
+
+    vector<LOGIN> logins;
+
+    for (int i = 0; i < n_logins; ++i)
+    {
+        // Every tenth login is by an unknown user.
+        int user = (i % 10 == 9) ? n_users + i : rand() % n_users;
+
+        logins.push_back({user_name(user), hosts[rand() % n_hosts], dbs[rand() % n_dbs]});
+    }
+
+    return logins;
+}
+
+bool sqlite_find(sqlite3* handle, const LOGIN& login, string* pPassword)
+{
+    char sql[sizeof(mysqlauth_validate_user_query) + 512];
+    sprintf(sql, mysqlauth_validate_user_query,
+            login.user.c_str(), login.host.c_str(), login.host.c_str(), login.db.c_str(), login.db.c_str());
+
+    string password("<not found>");
+    exec(handle, sql, password_cb, &password);
+
+    bool found = password != "<not found>";
+
+    if (found)
+    {
+        *pPassword = password;
+    }
+
+    return found;
+}
+
+int test_equivalence(sqlite3* handle, const UserIndex& index, const vector<LOGIN>& logins)
+{
+    int rv = 0;
+
+    for (const LOGIN& login : logins)
+    {
+        string sqlite_password;
+        string index_password;
+
+        bool sqlite_found = sqlite_find(handle, login, &sqlite_password);
+        bool index_found = index.find(login.user.c_str(), login.host.c_str(), login.db.c_str(),
+                                      &index_password);
+
+        if (sqlite_found != index_found || sqlite_password != index_password)
+        {
+            cerr << "error: '" << login.user << "'@'" << login.host << "' to '" << login.db << "': "
+                 << "SQLite: " << sqlite_found << " '" << sqlite_password << "', "
+                 << "index: " << index_found << " '" << index_password << "'." << endl;
+            ++rv;
+        }
+    }
+
+    const char* databases[] = {"test", "sales", "Sales", "app_db", "nonexistent"};
+
+    for (const char* zDb : databases)
+    {
+        char sql[sizeof(mysqlauth_validate_database_query) + 64];
+        sprintf(sql, mysqlauth_validate_database_query, zDb);
+
+        string result("<not found>");
+        exec(handle, sql, password_cb, &result);
+
+        if ((result != "<not found>") != index.has_database(zDb))
+        {
+            cerr << "error: Existence of database '" << zDb << "' differs." << endl;
+            ++rv;
+        }
+    }
+
+    return rv;
+}
+
+template<class Find>
+double logins_per_second(const vector<LOGIN>& logins, Find find)
+{
+    auto start = chrono::steady_clock::now();
+    size_t found = 0;
+
+    for (const LOGIN& login : logins)
+    {
+        string password;
+
+        if (find(login, &password))
+        {
+            ++found;
+        }
+    }
+
+    chrono::duration<double> secs = chrono::steady_clock::now() - start;
+
+    return secs.count() > 0 ? logins.size() / secs.count() : 0;
+}
+
+/**
+ * Rows of one host interleaved with the rows of another, as returned by the UNION
+ * that loads the users. The host loaded in between must still be found first.
+ */
+int test_interleaved()
+{
+    int rv = 1;
+    sqlite3* handle;
+
+    if (sqlite3_open_v2(":memory:", &handle, db_flags, NULL) == SQLITE_OK)
+    {
+        if (exec(handle, users_create_sql) && exec(handle, databases_create_sql)
+            && insert_user(handle, "bob", "%", "'x'", false, "'a'")
+            && insert_user(handle, "bob", "127.0.0.1", "'y'", false, "'b'")
+            && insert_user(handle, "bob", "%", "'y'", false, "'a'"))
+        {
+            unique_ptr<UserIndex> sIndex = UserIndex::create(handle, false);
+
+            if (sIndex)
+            {
+                vector<LOGIN> logins =
+                {
+                    {"bob", "127.0.0.1", "y"},
+                    {"bob", "127.0.0.1", "x"},
+                    {"bob", "127.0.0.1", ""},
+                    {"bob", "192.168.0.1", "y"},
+                    {"bob", "192.168.0.1", "z"},
+                };
+
+                rv = test_equivalence(handle, *sIndex, logins);
+
+                string password;
+
+                if (!sIndex->find("bob", "127.0.0.1", "y", &password) || password != "b")
+                {
+                    cerr << "error: Expected the grant of 'bob'@'127.0.0.1' on 'y'." << endl;
+                    ++rv;
+                }
+            }
+        }
+
+        sqlite3_close_v2(handle);
+    }
+
+    return rv;
+}
+
+int test(int n_users, int n_logins)
+{
+    int rv = 1;
+    sqlite3* handle;
+
+    if (sqlite3_open_v2(":memory:", &handle, db_flags, NULL) == SQLITE_OK)
+    {
+        if (populate(handle, n_users))
+        {
+            unique_ptr<UserIndex> sIndex = UserIndex::create(handle, false);
+
+            if (sIndex)
+            {
+                vector<LOGIN> logins = create_logins(n_users, n_logins);
+
+                rv = test_equivalence(handle, *sIndex, logins);
+
+                double sqlite_rate = logins_per_second(logins, [handle](const LOGIN& login, string* pPw) {
+                                                           return sqlite_find(handle, login, pPw);
+                                                       });
+
+                const UserIndex& index = *sIndex;
+                double index_rate = logins_per_second(logins, [&index](const LOGIN& login, string* pPw) {
+                                                          return index.find(login.user.c_str(),
+                                                                            login.host.c_str(),
+                                                                            login.db.c_str(),
+                                                                            pPw);
+                                                      });
+
+                cout << n_users << " users, " << n_logins << " logins: "
+                     << (int)sqlite_rate << " logins/s with SQLite, "
+                     << (int)index_rate << " logins/s with the index." << endl;
+            }
+        }
+
+        sqlite3_close_v2(handle);
+    }
+
+    return rv;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int rv = EXIT_SUCCESS;
+
+    // A fixed seed, so that a failure can be reproduced.
+    srand(4711);
+
+    if (mxs_log_init(NULL, ".", MXS_LOG_TARGET_DEFAULT))
+    {
+        rv += test_interleaved();
+        rv += test(100, 10000);
+        rv += test(10000, 1000);
+
+        mxs_log_finish();
+    }
+    else
+    {
+        cerr << "error: Could not initialize log." << endl;
+        rv = EXIT_FAILURE;
+    }
+
+    return rv == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
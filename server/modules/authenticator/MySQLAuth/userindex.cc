@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "mysql_auth.h"
+#include "userindex.hh"
+
+#include <ctype.h>
+#include <strings.h>
+#include <algorithm>
+#include <new>
+
+namespace
+{
+
+inline std::string to_lower(std::string s)
+{
+    std::transform(s.begin(), s.end(), s.begin(), ::tolower);
+    return s;
+}
+
+/**
+ * Case-insensitive matching of a value against an SQL LIKE pattern,
+ * behaving like the LIKE operator of SQLite.
+ *
+ * @param zPattern  A lowercased pattern.
+ * @param zValue    The value to match.
+ *
+ * @return True, if the value matches the pattern.
+ */
+bool like(const char* zPattern, const char* zValue)
+{
+    // Position after the most recent '%' in the pattern, and the position
+    // in the value it is currently assumed to match up to.
+    const char* zStar = NULL;
+    const char* zResume = NULL;
+
+    while (*zValue)
+    {
+        if (*zPattern == '%')
+        {
+            zStar = ++zPattern;
+            zResume = zValue;
+        }
+        else if (*zPattern && (*zPattern == '_' || *zPattern == tolower((unsigned char)*zValue)))
+        {
+            ++zPattern;
+            ++zValue;
+        }
+        else if (zStar)
+        {
+            zPattern = zStar;
+            zValue = ++zResume;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (*zPattern == '%')
+    {
+        ++zPattern;
+    }
+
+    return *zPattern == 0;
+}
+}
+
+UserIndex::Pattern::Pattern(const std::string& pattern)
+    : m_pattern(to_lower(pattern))
+{
+    if (!has_wildcards(m_pattern))
+    {
+        m_type = EXACT;
+    }
+    else if (m_pattern == "%")
+    {
+        m_type = ANY;
+    }
+    else if (m_pattern.back() == '%' && !has_wildcards(m_pattern.substr(0, m_pattern.length() - 1)))
+    {
+        m_type = PREFIX;
+        m_pattern.pop_back();
+    }
+    else
+    {
+        m_type = LIKE;
+    }
+}
+
+bool UserIndex::Pattern::matches(const char* zValue) const
+{
+    bool rv = false;
+
+    switch (m_type)
+    {
+    case EXACT:
+        rv = strcasecmp(m_pattern.c_str(), zValue) == 0;
+        break;
+
+    case ANY:
+        rv = true;
+        break;
+
+    case PREFIX:
+        rv = strncasecmp(m_pattern.c_str(), zValue, m_pattern.length()) == 0;
+        break;
+
+    case LIKE:
+        rv = like(m_pattern.c_str(), zValue);
+        break;
+    }
+
+    return rv;
+}
+
+bool UserIndex::HostGrants::matches_db(const char* zDb) const
+{
+    bool rv = anydb || !*zDb;
+
+    if (!rv)
+    {
+        std::string db = to_lower(zDb);
+
+        rv = dbs.find(db) != dbs.end();
+
+        for (auto it = db_patterns.begin(); !rv && it != db_patterns.end(); ++it)
+        {
+            rv = it->matches(zDb);
+        }
+    }
+
+    return rv;
+}
+
+UserIndex::UserIndex(bool lower_case_table_names)
+    : m_lower_case_table_names(lower_case_table_names)
+{
+}
+
+// static
+std::unique_ptr<UserIndex> UserIndex::create(sqlite3* handle, bool lower_case_table_names)
+{
+    std::unique_ptr<UserIndex> sIndex(new(std::nothrow) UserIndex(lower_case_table_names));
+
+    if (sIndex)
+    {
+        char* err;
+
+        if (sqlite3_exec(handle, dump_users_query, add_user_cb, sIndex.get(), &err) != SQLITE_OK
+            || sqlite3_exec(handle, dump_databases_query, add_database_cb, sIndex.get(), &err) != SQLITE_OK)
+        {
+            MXS_ERROR("Failed to index users: %s", err);
+            sqlite3_free(err);
+            sIndex.reset();
+        }
+    }
+
+    return sIndex;
+}
+
+bool UserIndex::find(const char* zUser, const char* zHost, const char* zDb, std::string* pPassword) const
+{
+    bool rv = false;
+    auto it = m_users.find(zUser);
+
+    if (it != m_users.end())
+    {
+        for (const HostGrants& grants : it->second)
+        {
+            if ((!zHost || grants.host_pattern.matches(zHost)) && grants.matches_db(zDb))
+            {
+                *pPassword = grants.password;
+                rv = true;
+                break;
+            }
+        }
+    }
+
+    return rv;
+}
+
+bool UserIndex::has_database(const char* zDb) const
+{
+    return m_databases.find(m_lower_case_table_names ? to_lower(zDb) : zDb) != m_databases.end();
+}
+
+void UserIndex::add_user(const char* zUser,
+                         const char* zHost,
+                         const char* zDb,
+                         bool anydb,
+                         const char* zPassword)
+{
+    std::vector<HostGrants>& user_grants = m_users[zUser];
+    std::string host(zHost);
+    std::string password(zPassword ? zPassword : "");
+
+    // Consecutive rows of a user with the same host are grouped, keeping the order in
+    // which they were loaded, so that the first matching group is the one SQLite would
+    // have returned. Only the latest group may be extended, as merging a row into an
+    // earlier one would move it ahead of the rows of other hosts loaded in between.
+    if (user_grants.empty()
+        || user_grants.back().host != host
+        || user_grants.back().anydb != anydb
+        || user_grants.back().password != password)
+    {
+        user_grants.emplace_back(host, anydb, password);
+        m_user_hosts.emplace_back(zUser, host);
+    }
+
+    HostGrants& grants = user_grants.back();
+
+    if (zDb)
+    {
+        std::string db(zDb);
+
+        if (Pattern::has_wildcards(db))
+        {
+            grants.db_patterns.emplace_back(db);
+        }
+        else
+        {
+            grants.dbs.insert(to_lower(db));
+        }
+    }
+}
+
+void UserIndex::add_database(const char* zDb)
+{
+    m_databases.insert(m_lower_case_table_names ? to_lower(zDb) : zDb);
+}
+
+// static
+int UserIndex::add_user_cb(void* pData, int columns, char** pzRows, char** pzNames)
+{
+    mxb_assert(columns == 5);
+    UserIndex* pThis = static_cast<UserIndex*>(pData);
+
+    // A NULL user or host can never match in the queries, so such rows are ignored.
+    if (pzRows[0] && pzRows[1])
+    {
+        pThis->add_user(pzRows[0], pzRows[1], pzRows[2], pzRows[3] && strcmp(pzRows[3], "1") == 0, pzRows[4]);
+    }
+
+    return 0;
+}
+
+// static
+int UserIndex::add_database_cb(void* pData, int columns, char** pzRows, char** pzNames)
+{
+    mxb_assert(columns == 1);
+    UserIndex* pThis = static_cast<UserIndex*>(pData);
+
+    if (pzRows[0])
+    {
+        pThis->add_database(pzRows[0]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxscale/ccdefs.hh>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <maxscale/sqlite3.h>
+
+/**
+ * An immutable in-memory index of the users of a MySQLAuth instance.
+ *
+ * The index is created from the contents of the SQLite users database
+ * whenever the users are reloaded and it answers the same questions as
+ * the queries in mysql_auth.h, without any SQL having to be executed
+ * when a client logs in.
+ */
+class UserIndex
+{
+public:
+    UserIndex(const UserIndex&) = delete;
+    UserIndex& operator=(const UserIndex&) = delete;
+
+    /**
+     * Create an index of the users and databases in an SQLite database.
+     *
+     * @param handle                  Handle of the database to be indexed.
+     * @param lower_case_table_names  Whether database names are case-insensitive.
+     *
+     * @return A new index or NULL, if the database could not be read.
+     */
+    static std::unique_ptr<UserIndex> create(sqlite3* handle, bool lower_case_table_names);
+
+    /**
+     * Find the password of a user. Equivalent with @c mysqlauth_validate_user_query
+     * or, if @c zHost is NULL, with @c mysqlauth_skip_auth_query.
+     *
+     * @param zUser      The user name.
+     * @param zHost      The client address or hostname, or NULL if the host
+     *                   should not be checked.
+     * @param zDb        The requested default database, empty if there is none.
+     * @param pPassword  On success, the hex encoded password hash, which is
+     *                   empty if the user has no password.
+     *
+     * @return True, if there is a grant matching the user, host and database.
+     */
+    bool find(const char* zUser, const char* zHost, const char* zDb, std::string* pPassword) const;
+
+    /**
+     * @return True, if there are any grants for the user.
+     */
+    bool has_user(const char* zUser) const
+    {
+        return m_users.find(zUser) != m_users.end();
+    }
+
+    /**
+     * Check whether a database exists. Equivalent with
+     * @c mysqlauth_validate_database_query.
+     *
+     * @param zDb  The database name.
+     *
+     * @return True, if the database exists.
+     */
+    bool has_database(const char* zDb) const;
+
+    typedef std::vector<std::pair<std::string, std::string>> UserHosts;
+
+    /**
+     * @return All user and host combinations, in load order.
+     */
+    const UserHosts& user_hosts() const
+    {
+        return m_user_hosts;
+    }
+
+private:
+    /**
+     * A pre-compiled SQL LIKE pattern, matched case-insensitively.
+     */
+    class Pattern
+    {
+    public:
+        Pattern(const std::string& pattern);
+
+        bool matches(const char* zValue) const;
+
+        static bool has_wildcards(const std::string& pattern)
+        {
+            return pattern.find_first_of("%_") != std::string::npos;
+        }
+
+    private:
+        enum type_t
+        {
+            EXACT,  /**< No wildcards, e.g. "127.0.0.1". */
+            ANY,    /**< Only "%". */
+            PREFIX, /**< A trailing "%" being the only wildcard, e.g. a merged netmask "192.168.%". */
+            LIKE    /**< Anything else. */
+        };
+
+        type_t      m_type;
+        std::string m_pattern;  /**< Lowercased, for PREFIX without the trailing "%". */
+    };
+
+    /**
+     * Consecutively loaded grants of a user from a particular host pattern.
+     */
+    struct HostGrants
+    {
+        HostGrants(const std::string& host, bool anydb, const std::string& password)
+            : host(host)
+            , host_pattern(host)
+            , anydb(anydb)
+            , password(password)
+        {
+        }
+
+        bool matches_db(const char* zDb) const;
+
+        std::string                     host;         /**< The host, as loaded. */
+        Pattern                         host_pattern; /**< The host as a pattern. */
+        bool                            anydb;        /**< Whether all databases are accessible. */
+        std::string                     password;     /**< The password hash, possibly empty. */
+        std::unordered_set<std::string> dbs;          /**< Lowercased database names. */
+        std::vector<Pattern>            db_patterns;  /**< Database names with wildcards. */
+    };
+
+    typedef std::unordered_map<std::string, std::vector<HostGrants>> GrantsByUser;
+
+    UserIndex(bool lower_case_table_names);
+
+    void add_user(const char* zUser, const char* zHost, const char* zDb, bool anydb, const char* zPassword);
+    void add_database(const char* zDb);
+
+    static int add_user_cb(void* pData, int columns, char** pzRows, char** pzNames);
+    static int add_database_cb(void* pData, int columns, char** pzRows, char** pzNames);
+
+    bool                            m_lower_case_table_names;
+    GrantsByUser                    m_users;
+    std::unordered_set<std::string> m_databases;
+    UserHosts                       m_user_hosts;
+};
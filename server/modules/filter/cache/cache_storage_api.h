@@ -59,6 +59,12 @@ typedef enum cache_thread_model
     CACHE_THREAD_MODEL_MT
 } cache_thread_model_t;
 
+typedef enum cache_invalidate
+{
+    CACHE_INVALIDATE_NEVER,     /*< Entries are expired only by the TTLs. */
+    CACHE_INVALIDATE_CURRENT,   /*< Entries are invalidated when a table they depend upon is modified. */
+} cache_invalidate_t;
+
 typedef void* CACHE_STORAGE;
 
 typedef struct cache_key
@@ -93,6 +99,7 @@ typedef enum cache_storage_capabilities
     CACHE_STORAGE_CAP_LRU       = 0x04, /*< Storage capable of LRU eviction. */
     CACHE_STORAGE_CAP_MAX_COUNT = 0x08, /*< Storage capable of capping number of entries.*/
     CACHE_STORAGE_CAP_MAX_SIZE  = 0x10, /*< Storage capable of capping size of cache.*/
+    CACHE_STORAGE_CAP_INVALIDATION = 0x20, /*< Storage capable of invalidating entries by word.*/
 } cache_storage_capabilities_t;
 
 static inline bool cache_storage_has_cap(uint32_t capabilities, uint32_t mask)
@@ -139,6 +146,13 @@ typedef struct cache_storage_config_t
      * specify 0, unless CACHE_STORAGE_CAP_MAX_SIZE is returned at initialization.
      */
     uint64_t max_size;
+
+    /**
+     * How entries should be invalidated. The caller should specify
+     * CACHE_INVALIDATE_NEVER, unless CACHE_STORAGE_CAP_INVALIDATION is returned
+     * at initialization.
+     */
+    cache_invalidate_t invalidate;
 } CACHE_STORAGE_CONFIG;
 
 typedef struct cache_storage_api
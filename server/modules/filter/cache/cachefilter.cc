@@ -55,6 +55,7 @@ void cache_config_finish(CACHE_CONFIG& config)
     config.debug = 0;
     config.thread_model = CACHE_DEFAULT_THREAD_MODEL;
     config.selects = CACHE_DEFAULT_SELECTS;
+    config.invalidate = CACHE_DEFAULT_INVALIDATE;
 }
 
 /**
@@ -82,6 +83,7 @@ void cache_config_reset(CACHE_CONFIG& config)
 
     config.thread_model = CACHE_DEFAULT_THREAD_MODEL;
     config.selects = CACHE_DEFAULT_SELECTS;
+    config.invalidate = CACHE_DEFAULT_INVALIDATE;
 }
 
 /**
@@ -149,6 +151,14 @@ static const MXS_ENUM_VALUE parameter_cache_in_trxs_values[] =
     {NULL}
 };
 
+// Enumeration values for `invalidate`
+static const MXS_ENUM_VALUE parameter_invalidate_values[] =
+{
+    {"never",   CACHE_INVALIDATE_NEVER  },
+    {"current", CACHE_INVALIDATE_CURRENT},
+    {NULL}
+};
+
 extern "C" MXS_MODULE* MXS_CREATE_MODULE()
 {
     static modulecmd_arg_type_t show_argv[] =
@@ -254,6 +264,13 @@ extern "C" MXS_MODULE* MXS_CREATE_MODULE()
                 MXS_MODULE_PARAM_BOOL,
                 CACHE_ZDEFAULT_ENABLED
             },
+            {
+                "invalidate",
+                MXS_MODULE_PARAM_ENUM,
+                CACHE_ZDEFAULT_INVALIDATE,
+                MXS_MODULE_OPT_NONE,
+                parameter_invalidate_values
+            },
             {MXS_END_MODULE_PARAMS}
         }
     };
@@ -363,6 +380,9 @@ bool CacheFilter::process_params(MXS_CONFIG_PARAMETER* ppParams, CACHE_CONFIG& c
                                                                         "cache_in_transactions",
                                                                         parameter_cache_in_trxs_values));
     config.enabled = config_get_bool(ppParams, "enabled");
+    config.invalidate = static_cast<cache_invalidate_t>(config_get_enum(ppParams,
+                                                                        "invalidate",
+                                                                        parameter_invalidate_values));
 
     if (!config.storage)
     {
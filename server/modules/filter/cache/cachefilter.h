@@ -70,6 +70,9 @@ const cache_selects_t CACHE_DEFAULT_SELECTS = CACHE_SELECTS_ASSUME_CACHEABLE;
 #define CACHE_ZDEFAULT_CACHE_IN_TRXS "all_transactions"
 // Enabled
 #define CACHE_ZDEFAULT_ENABLED "true"
+// Invalidation
+#define CACHE_ZDEFAULT_INVALIDATE "never"
+const cache_invalidate_t CACHE_DEFAULT_INVALIDATE = CACHE_INVALIDATE_NEVER;
 
 typedef enum cache_in_trxs
 {
@@ -97,5 +100,6 @@ typedef struct cache_config
     cache_thread_model_t thread_model;      /**< Thread model. */
     cache_selects_t      selects;           /**< Assume/verify that selects are cacheable. */
     cache_in_trxs_t      cache_in_trxs;     /**< To cache or not to cache inside transactions. */
+    cache_invalidate_t   invalidate;        /**< How cached entries are invalidated. */
     bool                 enabled;           /**< Whether the cache is enabled or not. */
 } CACHE_CONFIG;
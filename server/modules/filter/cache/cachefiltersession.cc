@@ -13,6 +13,7 @@
 
 #define MXS_MODULE_NAME "cache"
 #include "cachefiltersession.hh"
+#include <algorithm>
 #include <new>
 #include <maxscale/alloc.h>
 #include <maxscale/modutil.h>
@@ -177,6 +178,52 @@ bool is_select_statement(GWBUF* pStmt)
 
     return is_select;
 }
+
+/**
+ * Get the invalidation words of a statement, that is, the fully qualified
+ * and lowercased names of the tables it accesses.
+ *
+ * @param pStmt       A COM_QUERY or COM_STMT_PREPARE packet.
+ * @param zDefaultDb  The default database, may be NULL.
+ * @param pWords      Vector the words will be appended to.
+ *
+ * @return True, if the statement could be completely parsed, false otherwise.
+ */
+bool get_invalidation_words(GWBUF* pStmt, const char* zDefaultDb, std::vector<std::string>* pWords)
+{
+    bool rv = false;
+
+    if (qc_parse(pStmt, QC_COLLECT_TABLES) == QC_QUERY_PARSED)
+    {
+        int n = 0;
+        char** pzNames = qc_get_table_names(pStmt, &n, true);
+
+        for (int i = 0; i < n; ++i)
+        {
+            std::string word;
+
+            if (!strchr(pzNames[i], '.') && zDefaultDb)
+            {
+                word += zDefaultDb;
+                word += '.';
+            }
+
+            word += pzNames[i];
+            std::transform(word.begin(), word.end(), word.begin(), ::tolower);
+
+            pWords->push_back(word);
+        }
+
+        if (pzNames)
+        {
+            qc_free_table_names(pzNames, n);
+        }
+
+        rv = true;
+    }
+
+    return rv;
+}
 }
 
 CacheFilterSession::CacheFilterSession(MXS_SESSION* pSession, Cache* pCache, char* zDefaultDb)
@@ -191,6 +238,8 @@ CacheFilterSession::CacheFilterSession(MXS_SESSION* pSession, Cache* pCache, cha
     , m_populate(pCache->config().enabled)
     , m_soft_ttl(pCache->config().soft_ttl)
     , m_hard_ttl(pCache->config().hard_ttl)
+    , m_invalidate(false)
+    , m_invalidate_trx(false)
 {
     m_key.data = 0;
 
@@ -293,6 +342,23 @@ int CacheFilterSession::routeQuery(GWBUF* pPacket)
 
     reset_response_state();
     m_state = CACHE_IGNORING_RESPONSE;
+    m_invalidation_words.clear();
+
+    if (!m_trx_invalidation.words.empty() || m_trx_invalidation.clear)
+    {
+        if (session_trx_is_ending(m_pSession))
+        {
+            // What the transaction modified is invalidated once the server
+            // has responded to the statement ending it.
+            m_invalidate_trx = true;
+        }
+        else if (!session_trx_is_active(m_pSession))
+        {
+            // The transaction has already ended, e.g. implicitly.
+            invalidate(m_trx_invalidation);
+            m_trx_invalidation = Invalidation();
+        }
+    }
 
     int rv = 1;
 
@@ -323,17 +389,15 @@ int CacheFilterSession::routeQuery(GWBUF* pPacket)
         break;
 
     case MXS_COM_STMT_PREPARE:
-        if (log_decisions())
-        {
-            MXS_NOTICE("COM_STMT_PREPARE, ignoring.");
-        }
+        route_COM_STMT_PREPARE(pPacket);
         break;
 
     case MXS_COM_STMT_EXECUTE:
-        if (log_decisions())
-        {
-            MXS_NOTICE("COM_STMT_EXECUTE, ignoring.");
-        }
+        route_COM_STMT_EXECUTE(pPacket);
+        break;
+
+    case MXS_COM_STMT_CLOSE:
+        route_COM_STMT_CLOSE(pPacket);
         break;
 
     case MXS_COM_QUERY:
@@ -356,6 +420,11 @@ int CacheFilterSession::clientReply(GWBUF* pData)
 {
     int rv;
 
+    if (m_invalidate || m_invalidate_trx)
+    {
+        handle_invalidation();
+    }
+
     if (m_res.pData)
     {
         gwbuf_append(m_res.pData, pData);
@@ -409,6 +478,10 @@ int CacheFilterSession::clientReply(GWBUF* pData)
         rv = handle_expecting_use_response();
         break;
 
+    case CACHE_EXPECTING_PS_RESPONSE:
+        rv = handle_expecting_ps_response();
+        break;
+
     case CACHE_IGNORING_RESPONSE:
         rv = handle_ignoring_response();
         break;
@@ -713,6 +786,56 @@ int CacheFilterSession::handle_expecting_use_response()
     return rv;
 }
 
+/**
+ * Called when a response to a COM_STMT_PREPARE of a modifying statement
+ * is received from the server.
+ */
+int CacheFilterSession::handle_expecting_ps_response()
+{
+    mxb_assert(m_state == CACHE_EXPECTING_PS_RESPONSE);
+    mxb_assert(m_res.pData);
+
+    int rv = 1;
+
+    size_t buflen = m_res.length;
+    mxb_assert(m_res.length == gwbuf_length(m_res.pData));
+
+    if (buflen >= MYSQL_HEADER_LEN + 1)     // We need the command byte.
+    {
+        // The OK response is followed by the 4 byte statement id.
+        uint8_t header[MYSQL_HEADER_LEN + 1 + 4];
+        gwbuf_copy_data(m_res.pData, 0, MYSQL_HEADER_LEN + 1, header);
+
+        bool done = true;
+
+        if (MYSQL_GET_COMMAND(header) == MYSQL_REPLY_OK)
+        {
+            if (buflen >= sizeof(header))
+            {
+                gwbuf_copy_data(m_res.pData, MYSQL_HEADER_LEN + 1, 4, &header[MYSQL_HEADER_LEN + 1]);
+
+                uint32_t id = gw_mysql_get_byte4(&header[MYSQL_HEADER_LEN + 1]);
+                m_ps_invalidations[id] = m_ps_invalidation;
+            }
+            else
+            {
+                // We need more data. We will be called again, when data is available.
+                done = false;
+            }
+        }
+
+        if (done)
+        {
+            m_ps_invalidation = Invalidation();
+
+            rv = send_upstream();
+            m_state = CACHE_IGNORING_RESPONSE;
+        }
+    }
+
+    return rv;
+}
+
 /**
  * Called when all data from the server is ignored.
  */
@@ -769,7 +892,7 @@ void CacheFilterSession::store_result()
     {
         m_res.pData = pData;
 
-        cache_result_t result = m_pCache->put_value(m_key, m_res.pData);
+        cache_result_t result = m_pCache->put_value(m_key, m_invalidation_words, m_res.pData);
 
         if (!CACHE_RESULT_IS_OK(result))
         {
@@ -791,6 +914,116 @@ void CacheFilterSession::store_result()
     }
 }
 
+/**
+ * Figure out what a statement invalidates.
+ *
+ * @param pPacket        A COM_QUERY or COM_STMT_PREPARE packet.
+ * @param pInvalidation  On return, what the statement invalidates, if it modifies data.
+ *
+ * @return True, if the statement modifies data, false otherwise.
+ */
+bool CacheFilterSession::get_invalidation(GWBUF* pPacket, Invalidation* pInvalidation) const
+{
+    bool rv = false;
+
+    uint32_t type_mask = qc_get_type_mask(pPacket);
+
+    // E.g. "START TRANSACTION READ WRITE" is classified as a write.
+    if (qc_query_is_type(type_mask, QUERY_TYPE_WRITE)
+        && !qc_query_is_type(type_mask, QUERY_TYPE_BEGIN_TRX))
+    {
+        pInvalidation->words.clear();
+
+        // If we cannot figure out what tables are modified, everything
+        // must be invalidated.
+        if (!get_invalidation_words(pPacket, m_zDefaultDb, &pInvalidation->words)
+            || pInvalidation->words.empty())
+        {
+            pInvalidation->clear = true;
+        }
+        else
+        {
+            pInvalidation->clear = false;
+        }
+
+        rv = true;
+    }
+
+    return rv;
+}
+
+/**
+ * Invalidate cache entries.
+ *
+ * @param invalidation  What to invalidate.
+ */
+void CacheFilterSession::invalidate(const Invalidation& invalidation)
+{
+    cache_result_t result;
+
+    if (invalidation.clear)
+    {
+        if (log_decisions())
+        {
+            MXS_NOTICE("Modified tables not known, clearing the cache.");
+        }
+
+        result = m_pCache->clear();
+    }
+    else
+    {
+        if (log_decisions())
+        {
+            MXS_NOTICE("Invalidating cache entries of %lu table(s).", invalidation.words.size());
+        }
+
+        result = m_pCache->invalidate(invalidation.words);
+    }
+
+    if (!CACHE_RESULT_IS_OK(result))
+    {
+        MXS_ERROR("Could not invalidate cache entries, stale data may be returned.");
+    }
+}
+
+/**
+ * Called when the first response to a modifying statement, or to the
+ * statement that ended a modifying transaction, arrives.
+ */
+void CacheFilterSession::handle_invalidation()
+{
+    if (m_invalidate)
+    {
+        if (session_trx_is_active(m_pSession) && !session_trx_is_ending(m_pSession))
+        {
+            // Other sessions will not see the modifications until the
+            // transaction commits, so the invalidation is postponed.
+            m_trx_invalidation.clear = m_trx_invalidation.clear || m_invalidation.clear;
+
+            if (!m_trx_invalidation.clear)
+            {
+                m_trx_invalidation.words.insert(m_trx_invalidation.words.end(),
+                                                m_invalidation.words.begin(),
+                                                m_invalidation.words.end());
+            }
+        }
+        else
+        {
+            invalidate(m_invalidation);
+        }
+
+        m_invalidate = false;
+    }
+
+    if (m_invalidate_trx)
+    {
+        invalidate(m_trx_invalidation);
+
+        m_trx_invalidation = Invalidation();
+        m_invalidate_trx = false;
+    }
+}
+
 /**
  * Whether the cache should be consulted.
  *
@@ -997,6 +1230,61 @@ CacheFilterSession::cache_action_t CacheFilterSession::get_cache_action(GWBUF* p
     return action;
 }
 
+/**
+ * Routes a COM_STMT_PREPARE packet.
+ *
+ * @param pPacket  A contiguous COM_STMT_PREPARE packet.
+ */
+void CacheFilterSession::route_COM_STMT_PREPARE(GWBUF* pPacket)
+{
+    if (invalidation_enabled() && get_invalidation(pPacket, &m_ps_invalidation))
+    {
+        // We need the statement id from the response.
+        m_state = CACHE_EXPECTING_PS_RESPONSE;
+    }
+    else if (log_decisions())
+    {
+        MXS_NOTICE("COM_STMT_PREPARE, ignoring.");
+    }
+}
+
+/**
+ * Routes a COM_STMT_EXECUTE packet.
+ *
+ * @param pPacket  A contiguous COM_STMT_EXECUTE packet.
+ */
+void CacheFilterSession::route_COM_STMT_EXECUTE(GWBUF* pPacket)
+{
+    if (invalidation_enabled())
+    {
+        auto it = m_ps_invalidations.find(mxs_mysql_extract_ps_id(pPacket));
+
+        if (it != m_ps_invalidations.end())
+        {
+            m_invalidation = it->second;
+            m_invalidate = true;
+        }
+    }
+
+    if (log_decisions())
+    {
+        MXS_NOTICE("COM_STMT_EXECUTE, ignoring.");
+    }
+}
+
+/**
+ * Routes a COM_STMT_CLOSE packet.
+ *
+ * @param pPacket  A contiguous COM_STMT_CLOSE packet.
+ */
+void CacheFilterSession::route_COM_STMT_CLOSE(GWBUF* pPacket)
+{
+    if (invalidation_enabled())
+    {
+        m_ps_invalidations.erase(mxs_mysql_extract_ps_id(pPacket));
+    }
+}
+
 /**
  * Routes a COM_QUERY packet.
  *
@@ -1014,6 +1302,11 @@ CacheFilterSession::routing_action_t CacheFilterSession::route_COM_QUERY(GWBUF*
     routing_action_t routing_action = ROUTING_CONTINUE;
     cache_action_t cache_action = get_cache_action(pPacket);
 
+    if (invalidation_enabled() && (cache_action == CACHE_IGNORE) && !is_select_statement(pPacket))
+    {
+        m_invalidate = get_invalidation(pPacket, &m_invalidation);
+    }
+
     if (cache_action != CACHE_IGNORE)
     {
         const CacheRules* pRules = m_pCache->should_store(m_zDefaultDb, pPacket);
@@ -1025,6 +1318,26 @@ CacheFilterSession::routing_action_t CacheFilterSession::route_COM_QUERY(GWBUF*
             if (CACHE_RESULT_IS_OK(result))
             {
                 routing_action = route_SELECT(cache_action, *pRules, pPacket);
+
+                if ((m_state == CACHE_EXPECTING_RESPONSE) && invalidation_enabled())
+                {
+                    if (!get_invalidation_words(pPacket, m_zDefaultDb, &m_invalidation_words))
+                    {
+                        // Without knowing the tables, the entry could never be invalidated.
+                        if (log_decisions())
+                        {
+                            MXS_NOTICE("Statement could not be parsed, not caching result.");
+                        }
+
+                        if (m_refreshing)
+                        {
+                            m_pCache->refreshed(m_key, this);
+                            m_refreshing = false;
+                        }
+
+                        m_state = CACHE_IGNORING_RESPONSE;
+                    }
+                }
             }
             else
             {
@@ -13,6 +13,9 @@
 #pragma once
 
 #include <maxscale/ccdefs.hh>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <maxscale/buffer.h>
 #include <maxscale/filter.hh>
 #include "cache.hh"
@@ -32,6 +35,7 @@ public:
         CACHE_EXPECTING_ROWS,           // A select has been sent, and we want more rows.
         CACHE_EXPECTING_NOTHING,        // We are not expecting anything from the server.
         CACHE_EXPECTING_USE_RESPONSE,   // A "USE DB" was issued.
+        CACHE_EXPECTING_PS_RESPONSE,    // A COM_STMT_PREPARE of a modifying statement was issued.
         CACHE_IGNORING_RESPONSE,        // We are not interested in the data received from the server.
     };
 
@@ -101,6 +105,7 @@ private:
     int handle_expecting_response();
     int handle_expecting_rows();
     int handle_expecting_use_response();
+    int handle_expecting_ps_response();
     int handle_ignoring_response();
 
     int send_upstream();
@@ -114,6 +119,28 @@ private:
 
     void store_result();
 
+    struct Invalidation
+    {
+        Invalidation()
+            : clear(false)
+        {
+        }
+
+        bool                     clear; /**< Whether the entire cache must be cleared. */
+        std::vector<std::string> words; /**< Otherwise, the words to invalidate. */
+    };
+
+    typedef std::unordered_map<uint32_t, Invalidation> InvalidationsById;
+
+    bool invalidation_enabled() const
+    {
+        return m_pCache->config().invalidate != CACHE_INVALIDATE_NEVER;
+    }
+
+    bool get_invalidation(GWBUF* pPacket, Invalidation* pInvalidation) const;
+    void invalidate(const Invalidation& invalidation);
+    void handle_invalidation();
+
     enum cache_action_t
     {
         CACHE_IGNORE           = 0,
@@ -140,6 +167,9 @@ private:
         ROUTING_CONTINUE,   /**< Continue normal routing activity. */
     };
 
+    void route_COM_STMT_PREPARE(GWBUF* pPacket);
+    void route_COM_STMT_EXECUTE(GWBUF* pPacket);
+    void route_COM_STMT_CLOSE(GWBUF* pPacket);
     routing_action_t route_COM_QUERY(GWBUF* pPacket);
     routing_action_t route_SELECT(cache_action_t action, const CacheRules& rules, GWBUF* pPacket);
 
@@ -181,16 +211,23 @@ private:
     CacheFilterSession(MXS_SESSION* pSession, Cache* pCache, char* zDefaultDb);
 
 private:
-    cache_session_state_t m_state;          /**< What state is the session in, what data is expected. */
-    Cache*                m_pCache;         /**< The cache instance the session is associated with. */
-    CACHE_RESPONSE_STATE  m_res;            /**< The response state. */
-    CACHE_KEY             m_key;            /**< Key storage. */
-    char*                 m_zDefaultDb;     /**< The default database. */
-    char*                 m_zUseDb;         /**< Pending default database. Needs server response. */
-    bool                  m_refreshing;     /**< Whether the session is updating a stale cache entry. */
-    bool                  m_is_read_only;   /**< Whether the current trx has been read-only in pratice. */
-    bool                  m_use;            /**< Whether the cache should be used in this session. */
-    bool                  m_populate;       /**< Whether the cache should be populated in this session. */
-    uint32_t              m_soft_ttl;       /**< The soft TTL used in the session. */
-    uint32_t              m_hard_ttl;       /**< The hard TTL used in the session. */
+    cache_session_state_t    m_state;              /**< What state is the session in, what data is expected. */
+    Cache*                   m_pCache;             /**< The cache instance the session is associated with. */
+    CACHE_RESPONSE_STATE     m_res;                /**< The response state. */
+    CACHE_KEY                m_key;                /**< Key storage. */
+    char*                    m_zDefaultDb;         /**< The default database. */
+    char*                    m_zUseDb;             /**< Pending default database. Needs server response. */
+    bool                     m_refreshing;         /**< Whether the session is updating a stale cache entry. */
+    bool                     m_is_read_only;       /**< Whether the current trx has been read-only in pratice. */
+    bool                     m_use;                /**< Whether the cache should be used in this session. */
+    bool                     m_populate;           /**< Whether the cache should be populated in this session. */
+    uint32_t                 m_soft_ttl;           /**< The soft TTL used in the session. */
+    uint32_t                 m_hard_ttl;           /**< The hard TTL used in the session. */
+    std::vector<std::string> m_invalidation_words; /**< The invalidation words of the SELECT being populated. */
+    bool                     m_invalidate;         /**< Whether m_invalidation should be acted upon at reply. */
+    Invalidation             m_invalidation;       /**< What the current statement invalidates. */
+    bool                     m_invalidate_trx;     /**< Whether m_trx_invalidation should be acted upon at reply. */
+    Invalidation             m_trx_invalidation;   /**< What the current transaction invalidates. */
+    Invalidation             m_ps_invalidation;    /**< What the statement being prepared invalidates. */
+    InvalidationsById        m_ps_invalidations;   /**< What prepared statements invalidate, by statement id. */
 };
@@ -16,6 +16,7 @@
 
 #include <maxbase/atomic.h>
 #include <maxscale/config.h>
+#include <maxscale/routingworker.hh>
 
 #include "cachest.hh"
 #include "storagefactory.hh"
@@ -136,9 +137,11 @@ cache_result_t CachePT::get_value(const CACHE_KEY& key,
     return thread_cache().get_value(key, flags, soft_ttl, hard_ttl, ppValue);
 }
 
-cache_result_t CachePT::put_value(const CACHE_KEY& key, const GWBUF* pValue)
+cache_result_t CachePT::put_value(const CACHE_KEY& key,
+                                  const std::vector<std::string>& invalidation_words,
+                                  const GWBUF* pValue)
 {
-    return thread_cache().put_value(key, pValue);
+    return thread_cache().put_value(key, invalidation_words, pValue);
 }
 
 cache_result_t CachePT::del_value(const CACHE_KEY& key)
@@ -146,6 +149,42 @@ cache_result_t CachePT::del_value(const CACHE_KEY& key)
     return thread_cache().del_value(key);
 }
 
+cache_result_t CachePT::invalidate(const std::vector<std::string>& words)
+{
+    // The cache of the calling thread is invalidated immediately, the caches
+    // of all other threads asynchronously in the thread in question.
+    cache_result_t rv = thread_cache().invalidate(words);
+
+    mxs::RoutingWorker* pOrigin = mxs::RoutingWorker::get_current();
+
+    mxs::RoutingWorker::broadcast([this, pOrigin, words]() {
+                                      if (mxs::RoutingWorker::get_current() != pOrigin)
+                                      {
+                                          thread_cache().invalidate(words);
+                                      }
+                                  },
+                                  mxs::RoutingWorker::EXECUTE_QUEUED);
+
+    return rv;
+}
+
+cache_result_t CachePT::clear()
+{
+    cache_result_t rv = thread_cache().clear();
+
+    mxs::RoutingWorker* pOrigin = mxs::RoutingWorker::get_current();
+
+    mxs::RoutingWorker::broadcast([this, pOrigin]() {
+                                      if (mxs::RoutingWorker::get_current() != pOrigin)
+                                      {
+                                          thread_cache().clear();
+                                      }
+                                  },
+                                  mxs::RoutingWorker::EXECUTE_QUEUED);
+
+    return rv;
+}
+
 // static
 CachePT* CachePT::Create(const std::string& name,
                          const CACHE_CONFIG* pConfig,
@@ -38,10 +38,16 @@ public:
                              uint32_t hard_ttl,
                              GWBUF**  ppValue) const;
 
-    cache_result_t put_value(const CACHE_KEY& key, const GWBUF* pValue);
+    cache_result_t put_value(const CACHE_KEY& key,
+                             const std::vector<std::string>& invalidation_words,
+                             const GWBUF* pValue);
 
     cache_result_t del_value(const CACHE_KEY& key);
 
+    cache_result_t invalidate(const std::vector<std::string>& words);
+
+    cache_result_t clear();
+
 private:
     typedef std::shared_ptr<Cache> SCache;
     typedef std::vector<SCache>    Caches;
@@ -30,10 +30,16 @@ public:
                              uint32_t hard_ttl,
                              GWBUF**  ppValue) const;
 
-    cache_result_t put_value(const CACHE_KEY& key, const GWBUF* pValue);
+    cache_result_t put_value(const CACHE_KEY& key,
+                             const std::vector<std::string>& invalidation_words,
+                             const GWBUF* pValue);
 
     cache_result_t del_value(const CACHE_KEY& key);
 
+    cache_result_t invalidate(const std::vector<std::string>& words);
+
+    cache_result_t clear();
+
 protected:
     CacheSimple(const std::string& name,
                 const CACHE_CONFIG* pConfig,
@@ -81,7 +81,9 @@ cache_result_t LRUStorage::do_get_value(const CACHE_KEY& key,
     return access_value(APPROACH_GET, key, flags, soft_ttl, hard_ttl, ppValue);
 }
 
-cache_result_t LRUStorage::do_put_value(const CACHE_KEY& key, const GWBUF* pvalue)
+cache_result_t LRUStorage::do_put_value(const CACHE_KEY& key,
+                                        const std::vector<std::string>& invalidation_words,
+                                        const GWBUF* pvalue)
 {
     cache_result_t result = CACHE_RESULT_ERROR;
 
@@ -124,6 +126,23 @@ cache_result_t LRUStorage::do_put_value(const CACHE_KEY& key, const GWBUF* pvalu
             m_stats.size += pNode->size();
 
             move_to_head(pNode);
+
+            if (m_config.invalidate != CACHE_INVALIDATE_NEVER)
+            {
+                remove_from_invalidation_index(pNode);
+
+                try
+                {
+                    add_to_invalidation_index(pNode, invalidation_words);
+                }
+                catch (const std::exception& x)
+                {
+                    // A value that cannot be invalidated must not stay around.
+                    MXS_ERROR("Could not index cache item for invalidation, deleting it.");
+                    do_del_value(key);
+                    result = CACHE_RESULT_OUT_OF_RESOURCES;
+                }
+            }
         }
         else if (!existed)
         {
@@ -164,6 +183,74 @@ cache_result_t LRUStorage::do_del_value(const CACHE_KEY& key)
     return result;
 }
 
+cache_result_t LRUStorage::do_invalidate(const std::vector<std::string>& words)
+{
+    cache_result_t result = CACHE_RESULT_OK;
+
+    // Deleting a value modifies the index, so the keys are collected first.
+    std::vector<CACHE_KEY> keys;
+
+    for (const auto& word : words)
+    {
+        NodesByWord::iterator i = m_nodes_by_word.find(word);
+
+        if (i != m_nodes_by_word.end())
+        {
+            for (Node* pNode : i->second)
+            {
+                keys.push_back(*pNode->key());
+            }
+        }
+    }
+
+    for (const auto& key : keys)
+    {
+        // A key appears more than once if the value was indexed by several
+        // of the words, in which case it is already gone the second time.
+        if (m_nodes_by_key.find(key) != m_nodes_by_key.end())
+        {
+            do_del_value(key);
+
+            if (m_nodes_by_key.find(key) == m_nodes_by_key.end())
+            {
+                ++m_stats.invalidations;
+            }
+            else
+            {
+                MXS_ERROR("Could not invalidate cache item.");
+                result = CACHE_RESULT_ERROR;
+            }
+        }
+    }
+
+    return result;
+}
+
+cache_result_t LRUStorage::do_clear()
+{
+    bool error = false;
+
+    while (!error && m_pHead)
+    {
+        Node* pHead = m_pHead;
+        mxb_assert(pHead->key());
+
+        do_del_value(*pHead->key());
+
+        if (m_pHead != pHead)
+        {
+            ++m_stats.invalidations;
+        }
+        else
+        {
+            MXS_ERROR("Could not remove cache item.");
+            error = true;
+        }
+    }
+
+    return error ? CACHE_RESULT_ERROR : CACHE_RESULT_OK;
+}
+
 cache_result_t LRUStorage::do_get_head(CACHE_KEY* pKey, GWBUF** ppValue) const
 {
     cache_result_t result = CACHE_RESULT_NOT_FOUND;
@@ -366,6 +453,8 @@ bool LRUStorage::free_node_data(Node* pNode)
             m_nodes_by_key.erase(i);
         }
 
+        remove_from_invalidation_index(pNode);
+
         mxb_assert(m_stats.size >= pNode->size());
         mxb_assert(m_stats.items > 0);
 
@@ -391,6 +480,7 @@ bool LRUStorage::free_node_data(Node* pNode)
  */
 void LRUStorage::free_node(Node* pNode) const
 {
+    remove_from_invalidation_index(pNode);
     remove_node(pNode);
     delete pNode;
 
@@ -464,6 +554,53 @@ void LRUStorage::move_to_head(Node* pNode) const
     mxb_assert(m_pTail->next() == NULL);
 }
 
+/**
+ * Index a node by invalidation words.
+ *
+ * @param pNode  The node to be indexed; must not be in the index already.
+ * @param words  The words to index the node with.
+ *
+ * @throw std::bad_alloc if memory is exhausted.
+ */
+void LRUStorage::add_to_invalidation_index(Node* pNode, const std::vector<std::string>& words)
+{
+    mxb_assert(pNode->invalidation_words().empty());
+
+    for (const auto& word : words)
+    {
+        // Register the word with the node first, so that a failure
+        // leaves the node and the index consistent.
+        pNode->invalidation_words().push_back(word);
+        m_nodes_by_word[word].insert(pNode);
+    }
+}
+
+/**
+ * Remove a node from the invalidation index. Safe to call also if the
+ * node is not in the index.
+ *
+ * @param pNode  The node to be removed.
+ */
+void LRUStorage::remove_from_invalidation_index(Node* pNode) const
+{
+    for (const auto& word : pNode->invalidation_words())
+    {
+        NodesByWord::iterator i = m_nodes_by_word.find(word);
+
+        if (i != m_nodes_by_word.end())
+        {
+            i->second.erase(pNode);
+
+            if (i->second.empty())
+            {
+                m_nodes_by_word.erase(i);
+            }
+        }
+    }
+
+    pNode->invalidation_words().clear();
+}
+
 cache_result_t LRUStorage::get_existing_node(NodesByKey::iterator& i, const GWBUF* pValue, Node** ppNode)
 {
     cache_result_t result = CACHE_RESULT_OK;
@@ -607,4 +744,5 @@ void LRUStorage::Stats::fill(json_t* pObject) const
     set_integer(pObject, "updates", updates);
     set_integer(pObject, "deletes", deletes);
     set_integer(pObject, "evictions", evictions);
+    set_integer(pObject, "invalidations", invalidations);
 }
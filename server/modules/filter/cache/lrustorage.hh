@@ -13,7 +13,10 @@
 #pragma once
 
 #include <maxscale/ccdefs.hh>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "cachefilter.h"
 #include "cache_storage_api.hh"
 #include "storage.hh"
@@ -49,6 +52,7 @@ protected:
      * @see Storage::put_value
      */
     cache_result_t do_put_value(const CACHE_KEY& key,
+                                const std::vector<std::string>& invalidation_words,
                                 const GWBUF* pValue);
 
     /**
@@ -56,6 +60,16 @@ protected:
      */
     cache_result_t do_del_value(const CACHE_KEY& key);
 
+    /**
+     * @see Storage::invalidate
+     */
+    cache_result_t do_invalidate(const std::vector<std::string>& words);
+
+    /**
+     * @see Storage::clear
+     */
+    cache_result_t do_clear();
+
     /**
      * @see Storage::get_head
      */
@@ -202,14 +216,26 @@ private:
             m_size = size;
         }
 
+        const std::vector<std::string>& invalidation_words() const
+        {
+            return m_invalidation_words;
+        }
+
+        std::vector<std::string>& invalidation_words()
+        {
+            return m_invalidation_words;
+        }
+
     private:
-        const CACHE_KEY* m_pKey;    /*< Points at the key stored in nodes_by_key_ below. */
-        size_t           m_size;    /*< The size of the data referred to by m_pKey. */
-        Node*            m_pNext;   /*< The next node in the LRU list. */
-        Node*            m_pPrev;   /*< The previous node in the LRU list. */
+        const CACHE_KEY*         m_pKey;                /*< Points at the key stored in nodes_by_key_ below. */
+        size_t                   m_size;                /*< The size of the data referred to by m_pKey. */
+        Node*                    m_pNext;               /*< The next node in the LRU list. */
+        Node*                    m_pPrev;               /*< The previous node in the LRU list. */
+        std::vector<std::string> m_invalidation_words;  /*< The words the node is indexed with. */
     };
 
-    typedef std::unordered_map<CACHE_KEY, Node*> NodesByKey;
+    typedef std::unordered_map<CACHE_KEY, Node*>                       NodesByKey;
+    typedef std::unordered_map<std::string, std::unordered_set<Node*>> NodesByWord;
 
     Node* vacate_lru();
     Node* vacate_lru(size_t space);
@@ -219,6 +245,9 @@ private:
     void  remove_node(Node* pNode) const;
     void  move_to_head(Node* pNode) const;
 
+    void add_to_invalidation_index(Node* pNode, const std::vector<std::string>& words);
+    void remove_from_invalidation_index(Node* pNode) const;
+
     cache_result_t get_existing_node(NodesByKey::iterator& i, const GWBUF* pvalue, Node** ppNode);
     cache_result_t get_new_node(const CACHE_KEY& key,
                                 const GWBUF* pValue,
@@ -236,6 +265,7 @@ private:
             , updates(0)
             , deletes(0)
             , evictions(0)
+            , invalidations(0)
         {
         }
 
@@ -248,6 +278,7 @@ private:
         uint64_t updates;   /*< How many times an existing key in the cache was updated. */
         uint64_t deletes;   /*< How many times an existing key in the cache was deleted. */
         uint64_t evictions; /*< How many times an item has been evicted from the cache. */
+        uint64_t invalidations; /*< How many times an item has been invalidated. */
     };
 
     const CACHE_STORAGE_CONFIG m_config;        /*< The configuration. */
@@ -256,6 +287,7 @@ private:
     const uint64_t             m_max_size;      /*< The maximum size of all cached items. */
     mutable Stats              m_stats;         /*< Cache statistics. */
     mutable NodesByKey         m_nodes_by_key;  /*< Mapping from cache keys to corresponding Node. */
+    mutable NodesByWord        m_nodes_by_word; /*< Mapping from invalidation words to Nodes. */
     mutable Node*              m_pHead;         /*< The node at the LRU list. */
     mutable Node*              m_pTail;         /*< The node at bottom of the LRU list.*/
 };
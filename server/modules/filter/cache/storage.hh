@@ -13,6 +13,8 @@
 #pragma once
 
 #include <maxscale/ccdefs.hh>
+#include <string>
+#include <vector>
 #include "cache_storage_api.h"
 
 class Storage
@@ -80,14 +82,24 @@ public:
     /**
      * Put a value to the cache.
      *
-     * @param key     A key generated with get_key.
-     * @param pValue  Pointer to GWBUF containing the value to be stored.
-     *                Must be one contiguous buffer.
+     * @param key                 A key generated with get_key.
+     * @param invalidation_words  Words that, if passed to @c invalidate, will
+     *                            cause the value to be removed. Ignored unless
+     *                            the storage was created with invalidation enabled.
+     * @param pValue              Pointer to GWBUF containing the value to be stored.
+     *                            Must be one contiguous buffer.
      * @return CACHE_RESULT_OK if item was successfully put,
      *         CACHE_RESULT_OUT_OF_RESOURCES if item could not be put, due to
      *         some resource having become exhausted, or some other error code.
      */
-    virtual cache_result_t put_value(const CACHE_KEY& key, const GWBUF* pValue) = 0;
+    virtual cache_result_t put_value(const CACHE_KEY& key,
+                                     const std::vector<std::string>& invalidation_words,
+                                     const GWBUF* pValue) = 0;
+
+    cache_result_t put_value(const CACHE_KEY& key, const GWBUF* pValue)
+    {
+        return put_value(key, std::vector<std::string>(), pValue);
+    }
 
     /**
      * Delete a value from the cache.
@@ -100,6 +112,26 @@ public:
      */
     virtual cache_result_t del_value(const CACHE_KEY& key) = 0;
 
+    /**
+     * Invalidate all values that were put with any of the specified words.
+     *
+     * @param words  The invalidation words.
+     *
+     * @return CACHE_RESULT_OK if the values could be invalidated,
+     *         CACHE_RESULT_OUT_OF_RESOURCES if the storage is incapable
+     *         of invalidating, and CACHE_RESULT_ERROR otherwise.
+     */
+    virtual cache_result_t invalidate(const std::vector<std::string>& words) = 0;
+
+    /**
+     * Remove all values from the storage.
+     *
+     * @return CACHE_RESULT_OK if the storage could be cleared,
+     *         CACHE_RESULT_OUT_OF_RESOURCES if the storage is incapable
+     *         of clearing, and CACHE_RESULT_ERROR otherwise.
+     */
+    virtual cache_result_t clear() = 0;
+
     /**
      * Get the head item from the storage. This is only intended for testing and
      * debugging purposes and if the storage is being used by different threads
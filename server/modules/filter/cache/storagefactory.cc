@@ -116,6 +116,7 @@ StorageFactory::StorageFactory(void* handle,
     m_caps |= CACHE_STORAGE_CAP_LRU;
     m_caps |= CACHE_STORAGE_CAP_MAX_COUNT;
     m_caps |= CACHE_STORAGE_CAP_MAX_SIZE;
+    m_caps |= CACHE_STORAGE_CAP_INVALIDATION;
 }
 
 StorageFactory::~StorageFactory()
@@ -159,6 +160,11 @@ Storage* StorageFactory::createStorage(const char* zName,
 
     uint32_t mask = CACHE_STORAGE_CAP_MAX_COUNT | CACHE_STORAGE_CAP_MAX_SIZE;
 
+    if (config.invalidate != CACHE_INVALIDATE_NEVER)
+    {
+        mask |= CACHE_STORAGE_CAP_INVALIDATION;
+    }
+
     if (!cache_storage_has_cap(m_storage_caps, mask))
     {
         // Since we will wrap the native storage with a LRUStorage, according
@@ -167,6 +173,7 @@ Storage* StorageFactory::createStorage(const char* zName,
         used_config.thread_model = CACHE_THREAD_MODEL_ST;
         used_config.max_count = 0;
         used_config.max_size = 0;
+        used_config.invalidate = CACHE_INVALIDATE_NEVER;
     }
 
     Storage* pStorage = createRawStorage(zName, used_config, argc, argv);
@@ -175,8 +182,8 @@ Storage* StorageFactory::createStorage(const char* zName,
     {
         if (!cache_storage_has_cap(m_storage_caps, mask))
         {
-            // Ok, so the cache cannot handle eviction. Let's decorate the
-            // real storage with a storage than can.
+            // Ok, so the cache cannot handle eviction or invalidation. Let's
+            // decorate the real storage with a storage than can.
 
             LRUStorage* pLruStorage = NULL;
 
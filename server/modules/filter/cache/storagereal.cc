@@ -47,8 +47,12 @@ cache_result_t StorageReal::get_value(const CACHE_KEY& key,
     return m_pApi->getValue(m_pStorage, &key, flags, soft_ttl, hard_ttl, ppValue);
 }
 
-cache_result_t StorageReal::put_value(const CACHE_KEY& key, const GWBUF* pValue)
+cache_result_t StorageReal::put_value(const CACHE_KEY& key,
+                                      const std::vector<std::string>& invalidation_words,
+                                      const GWBUF* pValue)
 {
+    // The storage API does not know about invalidation; if invalidation is
+    // needed, the storage factory decorates the real storage with an LRUStorage.
     return m_pApi->putValue(m_pStorage, &key, pValue);
 }
 
@@ -57,6 +61,16 @@ cache_result_t StorageReal::del_value(const CACHE_KEY& key)
     return m_pApi->delValue(m_pStorage, &key);
 }
 
+cache_result_t StorageReal::invalidate(const std::vector<std::string>& words)
+{
+    return CACHE_RESULT_OUT_OF_RESOURCES;
+}
+
+cache_result_t StorageReal::clear()
+{
+    return CACHE_RESULT_OUT_OF_RESOURCES;
+}
+
 cache_result_t StorageReal::get_head(CACHE_KEY* pKey, GWBUF** ppHead) const
 {
     return m_pApi->getHead(m_pStorage, pKey, ppHead);
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include <iostream>
+#include <maxscale/filtermodule.hh>
+#include <maxscale/mock/backend.hh>
+#include <maxscale/mock/client.hh>
+#include <maxscale/mock/routersession.hh>
+#include <maxscale/mock/session.hh>
+#include "../cachefilter.h"
+
+using namespace std;
+using maxscale::FilterModule;
+namespace mock = maxscale::mock;
+
+namespace
+{
+
+enum expectation_t
+{
+    FROM_BACKEND,
+    FROM_CACHE
+};
+
+int route(mock::Session& session,
+          mock::RouterSession& router_session,
+          const string& statement,
+          expectation_t expectation)
+{
+    int rv = 0;
+
+    cout << "Performing: \"" << statement << "\"" << flush;
+    session.route_query(mock::create_com_query(statement));
+
+    if (router_session.idle())
+    {
+        cout << ", cache was used." << endl;
+
+        if (expectation != FROM_CACHE)
+        {
+            cout << "ERROR: Statement did not reach backend." << endl;
+            ++rv;
+        }
+    }
+    else
+    {
+        cout << ", reached backend." << endl;
+        router_session.respond();
+
+        if (expectation != FROM_BACKEND)
+        {
+            cout << "ERROR: Statement was not provided from cache." << endl;
+            ++rv;
+        }
+    }
+
+    mxb_assert(router_session.idle());
+
+    return rv;
+}
+
+int test(mock::Session& session, mock::RouterSession& router_session)
+{
+    int rv = 0;
+
+    session.set_trx_state(SESSION_TRX_INACTIVE);
+    session.set_autocommit(true);
+
+    // Populate the cache.
+    rv += route(session, router_session, "SELECT a FROM tbl1", FROM_BACKEND);
+    rv += route(session, router_session, "SELECT a FROM tbl1", FROM_CACHE);
+    rv += route(session, router_session, "SELECT a FROM tbl2", FROM_BACKEND);
+    rv += route(session, router_session, "SELECT a FROM tbl2", FROM_CACHE);
+
+    // An autocommitted modification invalidates the entries of the table in question.
+    rv += route(session, router_session, "UPDATE tbl1 SET a = 1", FROM_BACKEND);
+    rv += route(session, router_session, "SELECT a FROM tbl1", FROM_BACKEND);
+    rv += route(session, router_session, "SELECT a FROM tbl1", FROM_CACHE);
+    rv += route(session, router_session, "SELECT a FROM tbl2", FROM_CACHE);
+
+    // A modification in a transaction invalidates when the transaction ends.
+    session.set_trx_state(SESSION_TRX_ACTIVE);
+    session.set_autocommit(false);
+
+    rv += route(session, router_session, "UPDATE tbl2 SET a = 1", FROM_BACKEND);
+
+    session.set_trx_state(SESSION_TRX_INACTIVE);
+    session.set_autocommit(true);
+
+    rv += route(session, router_session, "SELECT a FROM tbl1", FROM_CACHE);
+    rv += route(session, router_session, "SELECT a FROM tbl2", FROM_BACKEND);
+    rv += route(session, router_session, "SELECT a FROM tbl2", FROM_CACHE);
+
+    // A modification whose tables cannot be figured out clears the cache.
+    rv += route(session, router_session, "CALL modify_everything()", FROM_BACKEND);
+    rv += route(session, router_session, "SELECT a FROM tbl1", FROM_BACKEND);
+    rv += route(session, router_session, "SELECT a FROM tbl2", FROM_BACKEND);
+
+    return rv;
+}
+
+int test(FilterModule::Instance& filter_instance)
+{
+    int rv = 0;
+
+    mock::ResultSetBackend backend;
+    mock::RouterSession router_session(&backend);
+
+    mock::Client client("bob", "127.0.0.1");
+    mock::Session session(&client);
+
+    auto_ptr<FilterModule::Session> sFilter_session = filter_instance.newSession(&session);
+
+    if (sFilter_session.get())
+    {
+        router_session.set_as_downstream_on(sFilter_session.get());
+
+        client.set_as_upstream_on(*sFilter_session.get());
+
+        rv += test(session, router_session);
+    }
+    else
+    {
+        ++rv;
+    }
+
+    return rv;
+}
+
+int test(FilterModule& filter_module)
+{
+    int rv = 1;
+
+    auto_ptr<FilterModule::ConfigParameters> sParameters = filter_module.create_default_parameters();
+    sParameters->set_value("debug", "31");
+    sParameters->set_value("cached_data", "shared");
+    sParameters->set_value("invalidate", "current");
+
+    auto_ptr<FilterModule::Instance> sInstance = filter_module.createInstance("test", sParameters);
+
+    if (sInstance.get())
+    {
+        rv = test(*sInstance);
+    }
+
+    return rv;
+}
+
+int run()
+{
+    int rv = 1;
+
+    auto_ptr<FilterModule> sModule = FilterModule::load("cache");
+
+    if (sModule.get())
+    {
+        if (maxscale::Module::process_init())
+        {
+            if (maxscale::Module::thread_init())
+            {
+                rv = test(*sModule.get());
+
+                maxscale::Module::thread_finish();
+            }
+            else
+            {
+                cerr << "error: Could not perform thread initialization." << endl;
+            }
+
+            maxscale::Module::process_finish();
+        }
+        else
+        {
+            cerr << "error: Could not perform process initialization." << endl;
+        }
+    }
+    else
+    {
+        cerr << "error: Could not load filter module." << endl;
+    }
+
+    return rv;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int rv = 1;
+
+    if (mxs_log_init(NULL, ".", MXS_LOG_TARGET_DEFAULT))
+    {
+        if (qc_setup(NULL, QC_SQL_MODE_DEFAULT, "qc_sqlite", NULL))
+        {
+            if (qc_process_init(QC_INIT_SELF))
+            {
+                rv = run();
+
+                cout << rv << " failures." << endl;
+
+                qc_process_end(QC_INIT_SELF);
+            }
+            else
+            {
+                cerr << "error: Could not initialize query classifier." << endl;
+            }
+        }
+        else
+        {
+            cerr << "error: Could not setup query classifier." << endl;
+        }
+
+        mxs_log_finish();
+    }
+
+    return rv;
+}
@@ -441,10 +441,14 @@ void MariaDBMonitor::tick()
         mon_srv->mon_prev_status = status;
     }
 
-    // Query all servers for their status.
+    // Query all servers for their status. The servers may be queried concurrently, in which case
+    // update_server() must only touch the server it is called with.
+    probe_servers([this](MXS_MONITORED_SERVER* mon_srv) {
+                      update_server(get_server(mon_srv));
+                  });
+
     for (MariaDBServer* server : m_servers)
     {
-        update_server(server);
         if (server->m_topology_changed)
         {
             m_cluster_topology_changed = true;
@@ -18,6 +18,7 @@
 #include <iomanip>
 #include <thread>
 #include <maxscale/mysql_utils.h>
+#include <maxscale/server.hh>
 #include <maxscale/utils.hh>
 #include <set>
 
@@ -434,6 +435,9 @@ bool MariaDBServer::update_gtids(string* errmsg_out)
             m_gtid_current_pos = GtidList();
             m_gtid_binlog_pos = GtidList();
         }
+
+        // Let the routers know how far the server has replicated.
+        mxs::server_set_gtid_pos(m_server_base->server, m_gtid_current_pos.to_string());
     } // If query failed, do not update gtid:s.
     return rval;
 }
@@ -451,6 +451,38 @@ static inline void prepare_for_write(DCB* dcb, GWBUF* buffer)
     proto->track_state = GWBUF_SHOULD_TRACK_STATE(buffer);
 }
 
+/**
+ * Read the reply to a ping sent to a connection in the persistent pool
+ *
+ * @param dcb  Backend DCB in the persistent pool
+ *
+ * @return False if the connection should be discarded
+ */
+static bool read_pool_ping_reply(DCB* dcb)
+{
+    GWBUF* buffer = NULL;
+    bool rval = read_complete_packet(dcb, &buffer);
+
+    if (rval && buffer)
+    {
+        MySQLProtocol* proto = (MySQLProtocol*)dcb->protocol;
+
+        if (mxs_mysql_get_command(buffer) == MYSQL_REPLY_OK && dcb->readq == NULL)
+        {
+            dcb->flags &= ~DCBF_POOL_PING;
+            proto->ignore_replies--;
+        }
+        else
+        {
+            rval = false;
+        }
+
+        gwbuf_free(buffer);
+    }
+
+    return rval;
+}
+
 /*******************************************************************************
  *******************************************************************************
  *
@@ -483,8 +515,12 @@ static int gw_read_backend_event(DCB* dcb)
     if (dcb->persistentstart)
     {
         /** If a DCB gets a read event when it's in the persistent pool, it is
-         * treated as if it were an error. */
-        dcb->dcb_errhandle_called = true;
+         * treated as if it were an error unless it is the reply to a ping
+         * that was sent to keep the connection alive. */
+        if (!(dcb->flags & DCBF_POOL_PING) || !read_pool_ping_reply(dcb))
+        {
+            dcb->dcb_errhandle_called = true;
+        }
         return 0;
     }
 
@@ -496,6 +532,14 @@ static int gw_read_backend_event(DCB* dcb)
 
     MySQLProtocol* proto = (MySQLProtocol*)dcb->protocol;
 
+    if ((dcb->flags & DCBF_PREWARMED) && proto->protocol_auth_state == MXS_AUTH_STATE_COMPLETE)
+    {
+        /** A prewarmed connection has no router session and nothing is sent
+         * to it before it is placed into the pool. */
+        dcb->dcb_errhandle_called = true;
+        return 0;
+    }
+
     MXS_DEBUG("Read dcb %p fd %d protocol state %d, %s.",
               dcb,
               dcb->fd,
@@ -556,6 +600,7 @@ static int gw_read_backend_event(DCB* dcb)
             if (proto->protocol_auth_state == MXS_AUTH_STATE_COMPLETE)
             {
                 /** Authentication completed successfully */
+                dcb_handshake_complete(dcb);
                 GWBUF* localq = dcb->delayq;
                 dcb->delayq = NULL;
 
@@ -590,7 +635,13 @@ static void do_handle_error(DCB* dcb, mxs_error_action_t action, const char* err
     bool succp = true;
     MXS_SESSION* session = dcb->session;
 
-    if (!dcb->dcb_errhandle_called)
+    if (dcb->flags & DCBF_PREWARMED)
+    {
+        /** The connection was opened for the persistent pool and there is no
+         * router session to notify, the pool maintenance closes it. */
+        dcb->dcb_errhandle_called = true;
+    }
+    else if (!dcb->dcb_errhandle_called)
     {
         GWBUF* errbuf = mysql_create_custom_error(1, 0, errmsg);
         MXS_ROUTER_SESSION* rsession = static_cast<MXS_ROUTER_SESSION*>(session->router_session);
@@ -793,7 +844,7 @@ static int gw_read_and_write(DCB* dcb)
     int return_code = 0;
 
     /* read available backend data */
-    return_code = dcb_read(dcb, &read_buffer, 0);
+    return_code = mxs_mysql_backend_read(dcb, &read_buffer);
 
     if (return_code < 0)
     {
@@ -1179,7 +1230,7 @@ static int gw_MySQLWrite_backend(DCB* dcb, GWBUF* queue)
                                                   static_cast<MySQLProtocol*>(dcb->protocol));
         int rc = 0;
 
-        if (dcb_write(dcb, buf))
+        if (mxs_mysql_backend_write(dcb, buf))
         {
             MXS_INFO("Sent COM_CHANGE_USER");
             backend_protocol->ignore_replies++;
@@ -1271,7 +1322,7 @@ static int gw_MySQLWrite_backend(DCB* dcb, GWBUF* queue)
                 }
 
                 /** Write to backend */
-                rc = dcb_write(dcb, queue);
+                rc = mxs_mysql_backend_write(dcb, queue);
             }
         }
         break;
@@ -1463,7 +1514,7 @@ static int backend_write_delayqueue(DCB* dcb, GWBUF* buffer)
     }
     else
     {
-        rc = dcb_write(dcb, buffer);
+        rc = mxs_mysql_backend_write(dcb, buffer);
     }
 
     if (rc == 0)
@@ -1438,7 +1438,7 @@ static void gw_process_one_new_client(DCB* client_dcb)
      * This guarantees that the first event for the DCB is processed only after the following
      * task has been processed by the owning thread.
      */
-    mxs::RoutingWorker* worker = mxs::RoutingWorker::pick_worker();
+    mxs::RoutingWorker* worker = mxs::RoutingWorker::pick_worker(client_dcb->remote);
 
     worker->execute([=]() {
                         client_dcb->protocol = mysql_protocol_init(client_dcb, client_dcb->fd);
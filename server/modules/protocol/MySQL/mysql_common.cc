@@ -16,11 +16,15 @@
  */
 
 #include <netinet/tcp.h>
+#include <zlib.h>
 
 #include <set>
 #include <sstream>
 #include <map>
+#include <vector>
 
+#include <maxbase/atomic.hh>
+#include <maxbase/stopwatch.hh>
 #include <maxscale/alloc.h>
 #include <maxscale/clock.h>
 #include <maxscale/log.h>
@@ -64,6 +68,9 @@ MySQLProtocol* mysql_protocol_init(DCB* dcb, int fd)
     p->num_eof_packets = 0;
     p->large_query = false;
     p->track_state = false;
+    p->compress = false;
+    p->compress_seq = 0;
+    p->compressed_readq = NULL;
     /*< Assign fd with protocol */
     p->fd = fd;
     p->owner_dcb = dcb;
@@ -80,6 +87,7 @@ bool mysql_protocol_done(DCB* dcb)
     if (p->protocol_state == MYSQL_PROTOCOL_ACTIVE)
     {
         gwbuf_free(p->stored_query);
+        gwbuf_free(p->compressed_readq);
         p->protocol_state = MYSQL_PROTOCOL_DONE;
         rval = true;
     }
@@ -557,7 +565,7 @@ bool read_complete_packet(DCB* dcb, GWBUF** readbuf)
     bool rval = false;
     GWBUF* localbuf = NULL;
 
-    if (dcb_read(dcb, &localbuf, 0) >= 0)
+    if (mxs_mysql_backend_read(dcb, &localbuf) >= 0)
     {
         rval = true;
         dcb->last_read = mxs_clock();
@@ -812,20 +820,21 @@ static uint8_t* load_hashed_password(uint8_t* scramble, uint8_t* payload, uint8_
  * We start by taking the default bitmask and removing any bits not set in
  * the bitmask contained in the connection structure. Then add SSL flag if
  * the connection requires SSL (set from the MaxScale configuration). The
- * compression flag may be set, although compression is NOT SUPPORTED. If a
+ * compression flag is set if the compressed protocol is requested. If a
  * database name has been specified in the function call, the relevant flag
  * is set.
  *
  * @param conn  The MySQLProtocol structure for the connection
  * @param db_specified Whether the connection request specified a database
- * @param compress Whether compression is requested - NOT SUPPORTED
+ * @param compress Whether compression is requested
  * @return Bit mask (32 bits)
  * @note Capability bits are defined in maxscale/protocol/mysql.h
  */
 static uint32_t create_capabilities(MySQLProtocol* conn,
                                     bool with_ssl,
                                     bool db_specified,
-                                    uint64_t capabilities)
+                                    uint64_t capabilities,
+                                    bool compress)
 {
     uint32_t final_capabilities;
 
@@ -864,6 +873,11 @@ static uint32_t create_capabilities(MySQLProtocol* conn,
 
     final_capabilities |= (int)GW_MYSQL_CAPABILITIES_PLUGIN_AUTH;
 
+    if (compress)
+    {
+        final_capabilities |= (uint32_t)GW_MYSQL_CAPABILITIES_COMPRESS;
+    }
+
     return final_capabilities;
 }
 
@@ -871,7 +885,8 @@ GWBUF* gw_generate_auth_response(MYSQL_session* client,
                                  MySQLProtocol* conn,
                                  bool with_ssl,
                                  bool ssl_established,
-                                 uint64_t service_capabilities)
+                                 uint64_t service_capabilities,
+                                 bool compress)
 {
     uint8_t client_capabilities[4] = {0, 0, 0, 0};
     uint8_t* curr_passwd = NULL;
@@ -881,7 +896,7 @@ GWBUF* gw_generate_auth_response(MYSQL_session* client,
         curr_passwd = client->client_sha1;
     }
 
-    uint32_t capabilities = create_capabilities(conn, with_ssl, client->db[0], service_capabilities);
+    uint32_t capabilities = create_capabilities(conn, with_ssl, client->db[0], service_capabilities, compress);
     gw_mysql_set_byte4(client_capabilities, capabilities);
 
     /**
@@ -984,14 +999,25 @@ mxs_auth_state_t gw_send_backend_auth(DCB* dcb)
     bool with_ssl = dcb->server->server_ssl;
     bool ssl_established = dcb->ssl_state == SSL_ESTABLISHED;
 
+    MySQLProtocol* proto = (MySQLProtocol*)dcb->protocol;
+
+    /**
+     * Other authenticators write their authentication exchange directly to
+     * the DCB, so the compressed protocol is only used with the default one.
+     */
+    bool compress = dcb->server->compression
+        && (proto->server_capabilities & GW_MYSQL_CAPABILITIES_COMPRESS)
+        && strcasecmp(dcb->server->authenticator, "MySQLBackendAuth") == 0;
+
     MYSQL_session client;
     gw_get_shared_session_auth_info(dcb->session->client_dcb, &client);
 
     GWBUF* buffer = gw_generate_auth_response(&client,
-                                              (MySQLProtocol*)dcb->protocol,
+                                              proto,
                                               with_ssl,
                                               ssl_established,
-                                              dcb->service->capabilities);
+                                              dcb->service->capabilities,
+                                              compress);
     mxb_assert(buffer);
 
     if (with_ssl && !ssl_established)
@@ -1003,6 +1029,9 @@ mxs_auth_state_t gw_send_backend_auth(DCB* dcb)
     }
     else if (dcb_write(dcb, buffer))
     {
+        // Everything after the handshake response is compressed, including the reply to it.
+        proto->compress = compress;
+        proto->compress_seq = 0;
         rval = MXS_AUTH_STATE_RESPONSE_SENT;
     }
 
@@ -1024,7 +1053,7 @@ int send_mysql_native_password_response(DCB* dcb)
     data[3] = 2;    // This is the third packet after the COM_CHANGE_USER
     calculate_hash(proto->scramble, curr_passwd, data + MYSQL_HEADER_LEN);
 
-    return dcb_write(dcb, buffer);
+    return mxs_mysql_backend_write(dcb, buffer);
 }
 
 bool send_auth_switch_request_packet(DCB* dcb)
@@ -1044,6 +1073,243 @@ bool send_auth_switch_request_packet(DCB* dcb)
     return dcb_write(dcb, buffer) != 0;
 }
 
+/** The length of the header of a compressed packet */
+#define MYSQL_COMPRESSED_HEADER_LEN 7
+
+/** Payloads shorter than this are not worth compressing */
+#define MYSQL_MIN_COMPRESS_LEN 50
+
+/**
+ * Create a compressed packet.
+ *
+ * @param proto  The protocol of the connection.
+ * @param pData  The data to put in the packet.
+ * @param len    The length of the data, at most GW_MYSQL_MAX_PACKET_LEN.
+ *
+ * @return The compressed packet, or NULL if memory allocation failed.
+ */
+static GWBUF* create_compressed_packet(MySQLProtocol* proto, const uint8_t* pData, size_t len)
+{
+    uLongf compressed_len = 0;
+    std::vector<uint8_t> compressed;
+
+    if (len >= MYSQL_MIN_COMPRESS_LEN)
+    {
+        compressed_len = compressBound(len);
+        compressed.resize(compressed_len);
+
+        if (compress(&compressed[0], &compressed_len, pData, len) != Z_OK || compressed_len >= len)
+        {
+            // Incompressible data is sent as such.
+            compressed_len = 0;
+        }
+    }
+
+    size_t payload_len = compressed_len ? compressed_len : len;
+    GWBUF* buffer = gwbuf_alloc(MYSQL_COMPRESSED_HEADER_LEN + payload_len);
+
+    if (buffer)
+    {
+        uint8_t* ptr = GWBUF_DATA(buffer);
+        gw_mysql_set_byte3(ptr, payload_len);
+        ptr[3] = proto->compress_seq++;
+        gw_mysql_set_byte3(ptr + 4, compressed_len ? len : 0);
+        memcpy(ptr + MYSQL_COMPRESSED_HEADER_LEN, compressed_len ? &compressed[0] : pData, payload_len);
+    }
+
+    return buffer;
+}
+
+int mxs_mysql_backend_write(DCB* dcb, GWBUF* buffer)
+{
+    MySQLProtocol* proto = (MySQLProtocol*)dcb->protocol;
+    int rval = 0;
+
+    if (!proto->compress)
+    {
+        rval = dcb_write(dcb, buffer);
+    }
+    else if ((buffer = gwbuf_make_contiguous(buffer)))
+    {
+        maxbase::StopWatch sw;
+        const uint8_t* pData = GWBUF_DATA(buffer);
+        size_t len = GWBUF_LENGTH(buffer);
+
+        if (MYSQL_GET_PACKET_NO(pData) == 0)
+        {
+            // A new command, which restarts the sequence of the compressed packets.
+            proto->compress_seq = 0;
+        }
+
+        GWBUF* compressed = NULL;
+        size_t compressed_len = 0;
+        bool ok = true;
+
+        for (size_t offset = 0; ok && offset < len; offset += GW_MYSQL_MAX_PACKET_LEN)
+        {
+            GWBUF* packet = create_compressed_packet(proto, pData + offset,
+                                                     MXS_MIN(len - offset, GW_MYSQL_MAX_PACKET_LEN));
+
+            if (packet)
+            {
+                compressed_len += GWBUF_LENGTH(packet);
+                compressed = gwbuf_append(compressed, packet);
+            }
+            else
+            {
+                ok = false;
+            }
+        }
+
+        gwbuf_free(buffer);
+
+        SERVER_STATS* stats = &dcb->server->stats;
+        mxb::atomic::add(&stats->compressed_out, compressed_len, mxb::atomic::RELAXED);
+        mxb::atomic::add(&stats->uncompressed_out, len, mxb::atomic::RELAXED);
+        mxb::atomic::add(&stats->compression_time,
+                         std::chrono::duration_cast<std::chrono::microseconds>(sw.split()).count(),
+                         mxb::atomic::RELAXED);
+
+        if (ok)
+        {
+            rval = dcb_write(dcb, compressed);
+        }
+        else
+        {
+            gwbuf_free(compressed);
+        }
+    }
+
+    return rval;
+}
+
+/**
+ * Decompress the complete compressed packets read from a backend.
+ *
+ * @param dcb  The backend DCB.
+ * @param ppBuffer  On return, the decompressed data, NULL if there was none.
+ *
+ * @return True, if the data could be decompressed.
+ */
+static bool decompress_packets(DCB* dcb, GWBUF** ppBuffer)
+{
+    MySQLProtocol* proto = (MySQLProtocol*)dcb->protocol;
+    maxbase::StopWatch sw;
+    size_t compressed_len = 0;
+    size_t uncompressed_len = 0;
+    bool ok = true;
+
+    uint8_t header[MYSQL_COMPRESSED_HEADER_LEN];
+
+    while (ok && gwbuf_copy_data(proto->compressed_readq, 0, sizeof(header), header) == sizeof(header))
+    {
+        size_t payload_len = gw_mysql_get_byte3(header);
+        size_t original_len = gw_mysql_get_byte3(header + 4);
+
+        if (gwbuf_length(proto->compressed_readq) < MYSQL_COMPRESSED_HEADER_LEN + payload_len)
+        {
+            // An incomplete packet
+            break;
+        }
+
+        proto->compress_seq = header[3] + 1;
+        proto->compressed_readq = gwbuf_consume(proto->compressed_readq, MYSQL_COMPRESSED_HEADER_LEN);
+        GWBUF* payload = gwbuf_split(&proto->compressed_readq, payload_len);
+        GWBUF* packet = NULL;
+
+        if (original_len == 0)
+        {
+            // Sent as such, as it was too short to be compressed.
+            packet = payload;
+            uncompressed_len += payload_len;
+        }
+        else if ((payload = gwbuf_make_contiguous(payload)) && (packet = gwbuf_alloc(original_len)))
+        {
+            uLongf len = original_len;
+
+            if (uncompress(GWBUF_DATA(packet), &len, GWBUF_DATA(payload), payload_len) != Z_OK
+                || len != original_len)
+            {
+                MXS_ERROR("Failed to decompress a packet of %lu bytes from '%s'.",
+                          payload_len, dcb->server->name);
+                gwbuf_free(packet);
+                packet = NULL;
+                ok = false;
+            }
+
+            gwbuf_free(payload);
+            uncompressed_len += original_len;
+        }
+        else
+        {
+            gwbuf_free(payload);
+            ok = false;
+        }
+
+        compressed_len += MYSQL_COMPRESSED_HEADER_LEN + payload_len;
+        *ppBuffer = gwbuf_append(*ppBuffer, packet);
+    }
+
+    SERVER_STATS* stats = &dcb->server->stats;
+    mxb::atomic::add(&stats->compressed_in, compressed_len, mxb::atomic::RELAXED);
+    mxb::atomic::add(&stats->uncompressed_in, uncompressed_len, mxb::atomic::RELAXED);
+    mxb::atomic::add(&stats->compression_time,
+                     std::chrono::duration_cast<std::chrono::microseconds>(sw.split()).count(),
+                     mxb::atomic::RELAXED);
+
+    return ok;
+}
+
+int mxs_mysql_backend_read(DCB* dcb, GWBUF** ppBuffer)
+{
+    MySQLProtocol* proto = (MySQLProtocol*)dcb->protocol;
+    int rval = 0;
+
+    if (!proto->compress)
+    {
+        rval = dcb_read(dcb, ppBuffer, 0);
+    }
+    else
+    {
+        // The read queue holds data that has already been decompressed, so
+        // it is kept apart from what is read from the network.
+        GWBUF* readq = gwbuf_append(dcb->readq, dcb->fakeq);
+        dcb->readq = NULL;
+        dcb->fakeq = NULL;
+
+        GWBUF* raw = NULL;
+        GWBUF* decompressed = NULL;
+
+        if (dcb_read(dcb, &raw, 0) >= 0)
+        {
+            proto->compressed_readq = gwbuf_append(proto->compressed_readq, raw);
+
+            if (decompress_packets(dcb, &decompressed))
+            {
+                *ppBuffer = gwbuf_append(*ppBuffer, gwbuf_append(readq, decompressed));
+                readq = NULL;
+                rval = gwbuf_length(*ppBuffer);
+            }
+            else
+            {
+                gwbuf_free(decompressed);
+                rval = -1;
+            }
+        }
+        else
+        {
+            rval = -1;
+        }
+
+        if (readq)
+        {
+            dcb_readq_prepend(dcb, readq);
+        }
+    }
+
+    return rval;
+}
+
 /**
  * Decode mysql server handshake
  *
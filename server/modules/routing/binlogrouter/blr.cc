@@ -211,6 +211,8 @@ extern "C" MXS_MODULE* MXS_CREATE_MODULE()
              DEF_LONG_BURST},
             {"burstsize",                                MXS_MODULE_PARAM_SIZE,
              DEF_BURST_SIZE},
+            {"readahead_size",                           MXS_MODULE_PARAM_SIZE,
+             DEF_READAHEAD_SIZE},
             {"heartbeat",                                MXS_MODULE_PARAM_COUNT,
              BLR_HEARTBEAT_DEFAULT_INTERVAL},
             {"connect_retry",                            MXS_MODULE_PARAM_COUNT,
@@ -344,6 +346,7 @@ static MXS_ROUTER* createInstance(SERVICE* service, MXS_CONFIG_PARAMETER* params
     inst->short_burst = config_get_integer(params, "shortburst");
     inst->long_burst = config_get_integer(params, "longburst");
     inst->burst_size = config_get_size(params, "burstsize");
+    inst->readahead_size = config_get_size(params, "readahead_size");
     inst->binlogdir = config_copy_string(params, "binlogdir");
     inst->heartbeat = config_get_integer(params, "heartbeat");
     inst->retry_interval = config_get_integer(params, "connect_retry");
@@ -1650,6 +1653,12 @@ static void diagnostics(MXS_ROUTER* router, DCB* dcb)
                "\tAverage events per packet:                   %.1f\n",
                router_inst->stats.n_reads != 0 ?
                ((double)router_inst->stats.n_binlogs / router_inst->stats.n_reads) : 0);
+    dcb_printf(dcb,
+               "\tNumber of read-ahead chunks read:            %lu\n",
+               router_inst->stats.n_readahead_reads);
+    dcb_printf(dcb,
+               "\tNumber of events sent from read-ahead:       %lu\n",
+               router_inst->stats.n_readahead_hits);
 
     pthread_mutex_lock(&router_inst->lock);
     if (router_inst->stats.lastReply)
@@ -2106,6 +2115,8 @@ static json_t* diagnostics_json(const MXS_ROUTER* router)
         ((double)router_inst->stats.n_binlogs / router_inst->stats.n_reads) : 0;
 
     json_object_set_new(rval, "average_events_per_packets", json_real(average_packets));
+    json_object_set_new(rval, "readahead_reads", json_integer(router_inst->stats.n_readahead_reads));
+    json_object_set_new(rval, "readahead_hits", json_integer(router_inst->stats.n_readahead_hits));
 
     pthread_mutex_lock(&router_inst->lock);
     if (router_inst->stats.lastReply)
@@ -218,6 +218,12 @@ typedef enum
 #define DEF_SHORT_BURST "15"
 #define DEF_LONG_BURST  "500"
 #define DEF_BURST_SIZE  "1024000"           /* 1 Mb */
+#define DEF_READAHEAD_SIZE "1048576"        /* 1 MiB */
+
+/* Alignment of the file offsets of the binlog read-ahead chunks */
+#define BLR_READAHEAD_ALIGN 4096
+/* Number of read-ahead chunks kept per binlog file */
+#define BLR_READAHEAD_CHUNKS 4
 
 /**
  * master reconnect backoff constants
@@ -505,6 +511,24 @@ typedef struct
     mutable pthread_mutex_t lock;   /*< The spinlock for the cache */
 } BLCACHE;
 
+/**
+ * A chunk of a binlog file read ahead of the slaves that are catching up.
+ *
+ * The chunks are shared by all the slaves reading the same file, so a slave
+ * whose position is within one gets its events without any file access.
+ * The buffers of those events point into the chunk and hold a reference
+ * to it, so the events are not copied.
+ * A few chunks are kept per file so that slaves at different positions
+ * do not keep replacing each other's chunk.
+ */
+typedef struct blr_readahead
+{
+    int           refcnt;       /*< Reference count, modified atomically */
+    unsigned long pos;          /*< File offset of the first byte */
+    unsigned long len;          /*< Number of bytes in the chunk */
+    uint8_t       data[1];      /*< The contents of the file */
+} BLR_READAHEAD;
+
 typedef struct blfile
 {
     char binlog_name[BINLOG_FNAMELEN + 1];
@@ -514,6 +538,9 @@ typedef struct blfile
     BLCACHE*                cache;      /*< Record cache for this file */
     mutable pthread_mutex_t lock;       /*< The file lock */
     MARIADB_GTID_ELEMS      gtid_elms;  /*< Elements for file prefix */
+    BLR_READAHEAD*          readahead[BLR_READAHEAD_CHUNKS];
+    /*< Read-ahead chunks, protected by lock */
+    int                     readahead_next;/*< The chunk that is replaced next */
     struct blfile*          next;       /*< Next file in list */
 } BLFILE;
 
@@ -646,6 +673,8 @@ typedef struct
     uint64_t n_rotates;         /*< Number of binlog rotate events */
     uint64_t n_cachehits;       /*< Number of hits on the binlog cache */
     uint64_t n_cachemisses;     /*< Number of misses on the binlog cache */
+    uint64_t n_readahead_reads; /*< Number of read-ahead chunks read */
+    uint64_t n_readahead_hits;  /*< Number of events sent from read-ahead chunks */
     int      n_registered;      /*< Number of registered slaves */
     int      n_masterstarts;    /*< Number of times connection restarted */
     int      n_delayedreconnects;
@@ -798,6 +827,7 @@ struct ROUTER_INSTANCE : public MXS_ROUTER
     unsigned int            short_burst;/*< Short burst for slave catchup */
     unsigned int            long_burst; /*< Long burst for slave catchup */
     unsigned long           burst_size; /*< Maximum size of burst to send */
+    unsigned long           readahead_size;/*< Size of binlog read-ahead chunks, 0 if disabled */
     unsigned long           heartbeat;  /*< Configured heartbeat value */
     ROUTER_STATS            stats;      /*< Statistics for this router */
     int                     active_logs;
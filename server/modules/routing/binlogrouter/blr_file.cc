@@ -955,6 +955,237 @@ BLFILE* blr_open_binlog(ROUTER_INSTANCE* router,
     return file;
 }
 
+/**
+ * Release a reference to a read-ahead chunk
+ *
+ * @param chunk The chunk to release, may be NULL
+ */
+static void blr_readahead_release(BLR_READAHEAD* chunk)
+{
+    if (chunk && atomic_add(&chunk->refcnt, -1) == 1)
+    {
+        MXS_FREE(chunk);
+    }
+}
+
+/**
+ * Release the read-ahead chunk an event buffer points into
+ *
+ * @param data The chunk
+ */
+static void blr_readahead_done(void* data)
+{
+    blr_readahead_release(static_cast<BLR_READAHEAD*>(data));
+}
+
+/**
+ * Check whether a read-ahead chunk contains a complete event
+ *
+ * @param chunk The read-ahead chunk
+ * @param pos   Position of the event in the binlog file
+ * @return      True if the header and the body of the event are in the chunk
+ */
+static bool blr_readahead_has_event(BLR_READAHEAD* chunk, unsigned long pos)
+{
+    bool rval = false;
+
+    if (pos >= chunk->pos && pos - chunk->pos + BINLOG_EVENT_HDR_LEN <= chunk->len)
+    {
+        unsigned long offset = pos - chunk->pos;
+        uint32_t event_size = extract_field(&chunk->data[offset + 9], 32);
+
+        rval = event_size >= BINLOG_EVENT_HDR_LEN && offset + event_size <= chunk->len;
+    }
+
+    return rval;
+}
+
+/**
+ * Read a new read-ahead chunk, starting at the aligned offset preceding
+ * the requested position, and replace the oldest chunk of the file with it
+ *
+ * In the binlog file currently being written, only the part before the
+ * latest safe position is read, as anything after it may still change.
+ *
+ * @param router    The router instance
+ * @param file      File record
+ * @param pos       Position of the event that is needed
+ * @return          The chunk with a reference for the caller, or NULL if the
+ *                  event is not available as a whole
+ */
+static BLR_READAHEAD* blr_readahead_fill(ROUTER_INSTANCE* router, BLFILE* file, unsigned long pos)
+{
+    BLR_READAHEAD* chunk = NULL;
+    unsigned long start = pos & ~((unsigned long)BLR_READAHEAD_ALIGN - 1);
+    unsigned long size = router->readahead_size;
+
+    pthread_mutex_lock(&router->binlog_lock);
+    pthread_mutex_lock(&file->lock);
+
+    if (blr_compare_binlogs(router,
+                            &file->gtid_elms,
+                            router->binlog_name,
+                            file->binlog_name))
+    {
+        size = pos < router->binlog_position ?
+            MXS_MIN(size, router->binlog_position - start) : 0;
+    }
+
+    pthread_mutex_unlock(&file->lock);
+    pthread_mutex_unlock(&router->binlog_lock);
+
+    if (size > pos - start + BINLOG_EVENT_HDR_LEN)
+    {
+        /**
+         * An event that does not fit in the chunk is read directly from the
+         * file, so its size is checked before the whole chunk is read.
+         */
+        uint8_t hdbuf[BINLOG_EVENT_HDR_LEN];
+
+        if (pread(file->fd, hdbuf, BINLOG_EVENT_HDR_LEN, pos) != BINLOG_EVENT_HDR_LEN
+            || pos - start + extract_field(&hdbuf[9], 32) > size)
+        {
+            size = 0;
+        }
+    }
+
+    if (size > pos - start + BINLOG_EVENT_HDR_LEN
+        && (chunk = (BLR_READAHEAD*)MXS_MALLOC(sizeof(BLR_READAHEAD) + size - 1)) != NULL)
+    {
+        ssize_t n = pread(file->fd, chunk->data, size, start);
+
+        chunk->refcnt = 2;      // One for the file and one for the caller
+        chunk->pos = start;
+        chunk->len = n > 0 ? n : 0;
+
+        if (blr_readahead_has_event(chunk, pos))
+        {
+            atomic_add_uint64(&router->stats.n_readahead_reads, 1);
+
+            pthread_mutex_lock(&file->lock);
+            BLR_READAHEAD* old_chunk = file->readahead[file->readahead_next];
+            file->readahead[file->readahead_next] = chunk;
+            file->readahead_next = (file->readahead_next + 1) % BLR_READAHEAD_CHUNKS;
+            pthread_mutex_unlock(&file->lock);
+
+            blr_readahead_release(old_chunk);
+        }
+        else
+        {
+            MXS_FREE(chunk);
+            chunk = NULL;
+        }
+    }
+
+    return chunk;
+}
+
+/**
+ * Get a read-ahead chunk containing the event at a position
+ *
+ * An existing chunk of the file is used if one contains the event,
+ * otherwise a new chunk is read.
+ *
+ * @param router    The router instance
+ * @param file      File record
+ * @param pos       Position of the event
+ * @return          The chunk with a reference for the caller, or NULL if the
+ *                  event must be read directly from the file
+ */
+static BLR_READAHEAD* blr_readahead_get(ROUTER_INSTANCE* router, BLFILE* file, unsigned long pos)
+{
+    BLR_READAHEAD* chunk = NULL;
+
+    if (router->readahead_size > 0)
+    {
+        pthread_mutex_lock(&file->lock);
+
+        for (int i = 0; !chunk && i < BLR_READAHEAD_CHUNKS; i++)
+        {
+            if (file->readahead[i] && blr_readahead_has_event(file->readahead[i], pos))
+            {
+                chunk = file->readahead[i];
+                atomic_add(&chunk->refcnt, 1);
+            }
+        }
+
+        pthread_mutex_unlock(&file->lock);
+
+        if (!chunk)
+        {
+            chunk = blr_readahead_fill(router, file, pos);
+        }
+    }
+
+    return chunk;
+}
+
+/**
+ * Read an unencrypted replication event from a read-ahead chunk
+ *
+ * @param router    The router instance
+ * @param file      File record
+ * @param chunk     Read-ahead chunk containing the event
+ * @param pos       Position of binlog record to read
+ * @param hdr       Binlog header to populate
+ * @param errmsg    Allocated BINLOG_ERROR_MSG_LEN bytes message error buffer
+ * @return          The binlog record wrapped in a GWBUF structure
+ */
+static GWBUF* blr_readahead_read_event(ROUTER_INSTANCE* router,
+                                       BLFILE* file,
+                                       BLR_READAHEAD* chunk,
+                                       unsigned long pos,
+                                       REP_HEADER* hdr,
+                                       char* errmsg)
+{
+    GWBUF* result = NULL;
+    uint8_t* ptr = &chunk->data[pos - chunk->pos];
+
+    hdr->timestamp = EXTRACT32(ptr);
+    hdr->event_type = ptr[4];
+    hdr->serverid = EXTRACT32(&ptr[5]);
+    hdr->event_size = extract_field(&ptr[9], 32);
+    hdr->next_pos = EXTRACT32(&ptr[13]);
+    hdr->flags = EXTRACT16(&ptr[17]);
+
+    if (!blr_binlog_event_check(router,
+                                pos,
+                                hdr,
+                                file->binlog_name,
+                                errmsg))
+    {
+        hdr->ok = SLAVE_POS_READ_ERR;
+    }
+    else if ((result = gwbuf_alloc(0)) == NULL)
+    {
+        snprintf(errmsg,
+                 BINLOG_ERROR_MSG_LEN,
+                 "Failed to allocate memory for binlog entry, "
+                 "size %d, event at %lu in binlog file '%s'",
+                 hdr->event_size,
+                 pos,
+                 file->binlog_name);
+        hdr->ok = SLAVE_POS_READ_ERR;
+    }
+    else
+    {
+        /**
+         * The event is not copied, the buffer points into the chunk and holds
+         * a reference to it until the buffer is freed. The contents of a chunk
+         * never change once it has been read.
+         */
+        atomic_add(&chunk->refcnt, 1);
+        result->start = ptr;
+        result->end = ptr + hdr->event_size;
+        gwbuf_add_buffer_object(result, GWBUF_BINLOG_READAHEAD, chunk, blr_readahead_done);
+
+        atomic_add_uint64(&router->stats.n_readahead_hits, 1);
+        hdr->ok = SLAVE_POS_READ_OK;
+    }
+
+    return result;
+}
+
 /**
  * Read a replication event into a GWBUF structure.
  *
@@ -994,6 +1225,19 @@ GWBUF* blr_read_binlog(ROUTER_INSTANCE* router,
         return NULL;
     }
 
+    /**
+     * Unencrypted events that have been read ahead are served from memory,
+     * without the file having to be checked and read for every event.
+     */
+    BLR_READAHEAD* chunk;
+
+    if (enc_ctx == NULL && (chunk = blr_readahead_get(router, file, pos)) != NULL)
+    {
+        result = blr_readahead_read_event(router, file, chunk, pos, hdr, errmsg);
+        blr_readahead_release(chunk);
+        return result;
+    }
+
     pthread_mutex_lock(&file->lock);
     if (fstat(file->fd, &statb) == 0)
     {
@@ -1444,6 +1688,10 @@ void blr_close_binlog(ROUTER_INSTANCE* router, BLFILE* file)
     {
         close(file->fd);
         file->fd = -1;
+        for (int i = 0; i < BLR_READAHEAD_CHUNKS; i++)
+        {
+            blr_readahead_release(file->readahead[i]);
+        }
         MXS_FREE(file);
     }
 }
@@ -1741,6 +1741,7 @@ struct subcommand alteroptions[] =
         "ssl_cert_verify_depth       Certificate verification depth\n"
         "ssl_verify_peer_certificate Peer certificate verification\n"
         "persistpoolmax              Persisted connection pool size\n"
+        "persistpoolmin              Persisted connection pool minimum size\n"
         "persistmaxtime              Persisted connection maximum idle time\n"
         "\n"
         "To configure SSL for a newly created server, the 'ssl', 'ssl_cert',\n"
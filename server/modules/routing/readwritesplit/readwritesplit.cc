@@ -235,6 +235,20 @@ RWSplit* RWSplit::create(SERVICE* service, MXS_CONFIG_PARAMETER* params)
         return NULL;
     }
 
+    if (config.connection_multiplexing && config.disable_sescmd_history)
+    {
+        MXS_ERROR("Both 'connection_multiplexing' and 'disable_sescmd_history' are enabled: "
+                  "Connections cannot be reacquired without session command history.");
+        return NULL;
+    }
+
+    if (config.lazy_connect && config.disable_sescmd_history)
+    {
+        MXS_ERROR("Both 'lazy_connect' and 'disable_sescmd_history' are enabled: "
+                  "Slaves cannot be connected later without session command history.");
+        return NULL;
+    }
+
     return new(std::nothrow) RWSplit(service, config);
 }
 
@@ -279,6 +293,9 @@ void RWSplit::diagnostics(DCB* dcb)
     dcb_printf(dcb,
                "\tdisable_sescmd_history:    %s\n",
                cnf.disable_sescmd_history ? "true" : "false");
+    dcb_printf(dcb,
+               "\tcompact_sescmd_history:    %s\n",
+               cnf.compact_sescmd_history ? "true" : "false");
     dcb_printf(dcb,
                "\tmax_sescmd_history:        %lu\n",
                cnf.max_sescmd_history);
@@ -294,6 +311,9 @@ void RWSplit::diagnostics(DCB* dcb)
     dcb_printf(dcb,
                "\tcausal_reads_timeout:       %s\n",
                cnf.causal_reads_timeout.c_str());
+    dcb_printf(dcb,
+               "\tcausal_reads_mode:       %s\n",
+               causal_reads_mode_to_str(cnf.causal_reads_mode));
     dcb_printf(dcb,
                "\tmaster_reconnection:       %s\n",
                cnf.master_reconnection ? "true" : "false");
@@ -303,6 +323,21 @@ void RWSplit::diagnostics(DCB* dcb)
     dcb_printf(dcb,
                "\tdelayed_retry_timeout:       %lu\n",
                cnf.delayed_retry_timeout);
+    dcb_printf(dcb,
+               "\tconnection_multiplexing:       %s\n",
+               cnf.connection_multiplexing ? "true" : "false");
+    dcb_printf(dcb,
+               "\tconnection_multiplexing_idle_time:       %d\n",
+               cnf.connection_multiplexing_idle_time);
+    dcb_printf(dcb,
+               "\thedged_reads:       %s\n",
+               cnf.hedged_reads ? "true" : "false");
+    dcb_printf(dcb,
+               "\thedged_read_delay:       %d\n",
+               cnf.hedged_read_delay);
+    dcb_printf(dcb,
+               "\tlazy_connect:       %s\n",
+               cnf.lazy_connect ? "true" : "false");
 
     dcb_printf(dcb, "\n");
 
@@ -343,6 +378,30 @@ void RWSplit::diagnostics(DCB* dcb)
     dcb_printf(dcb,
                "\tNumber of replayed transactions:        %" PRIu64 "\n",
                stats().n_trx_replay);
+    dcb_printf(dcb,
+               "\tNumber of released idle connections:    %" PRIu64 "\n",
+               stats().n_released);
+    dcb_printf(dcb,
+               "\tNumber of reacquired connections:       %" PRIu64 "\n",
+               stats().n_reacquired);
+    dcb_printf(dcb,
+               "\tNumber of causal reads without a wait:  %" PRIu64 "\n",
+               stats().n_causal_no_wait);
+    dcb_printf(dcb,
+               "\tNumber of hedged reads:                 %" PRIu64 "\n",
+               stats().n_hedged);
+    dcb_printf(dcb,
+               "\tNumber of hedged reads won:             %" PRIu64 "\n",
+               stats().n_hedges_won);
+    dcb_printf(dcb,
+               "\tNumber of compacted session commands:   %" PRIu64 "\n",
+               stats().n_compacted);
+    dcb_printf(dcb,
+               "\tNumber of slaves connected on demand:   %" PRIu64 "\n",
+               stats().n_lazy_connected);
+    dcb_printf(dcb,
+               "\tNumber of slave connections avoided:    %" PRIu64 "\n",
+               stats().n_lazy_avoided);
 
     if (*weightby)
     {
@@ -403,6 +462,14 @@ json_t* RWSplit::diagnostics_json() const
     json_object_set_new(rval, "rw_transactions", json_integer(stats().n_rw_trx));
     json_object_set_new(rval, "ro_transactions", json_integer(stats().n_ro_trx));
     json_object_set_new(rval, "replayed_transactions", json_integer(stats().n_trx_replay));
+    json_object_set_new(rval, "released_connections", json_integer(stats().n_released));
+    json_object_set_new(rval, "reacquired_connections", json_integer(stats().n_reacquired));
+    json_object_set_new(rval, "causal_reads_without_wait", json_integer(stats().n_causal_no_wait));
+    json_object_set_new(rval, "hedged_reads", json_integer(stats().n_hedged));
+    json_object_set_new(rval, "hedged_reads_won", json_integer(stats().n_hedges_won));
+    json_object_set_new(rval, "compacted_session_commands", json_integer(stats().n_compacted));
+    json_object_set_new(rval, "lazy_connections", json_integer(stats().n_lazy_connected));
+    json_object_set_new(rval, "avoided_connections", json_integer(stats().n_lazy_avoided));
 
     const char* weightby = serviceGetWeightingParameter(service());
 
@@ -504,12 +571,20 @@ extern "C" MXS_MODULE* MXS_CREATE_MODULE()
                 MXS_MODULE_OPT_NONE,
                 master_failure_mode_values
             },
+            {
+                "causal_reads_mode",
+                MXS_MODULE_PARAM_ENUM,
+                "wait",
+                MXS_MODULE_OPT_NONE,
+                causal_reads_mode_values
+            },
             {"max_slave_replication_lag",  MXS_MODULE_PARAM_INT,     "-1"           },
             {"max_slave_connections",      MXS_MODULE_PARAM_STRING,  MAX_SLAVE_COUNT},
             {"retry_failed_reads",         MXS_MODULE_PARAM_BOOL,    "true"         },
             {"prune_sescmd_history",       MXS_MODULE_PARAM_BOOL,    "false"        },
             {"disable_sescmd_history",     MXS_MODULE_PARAM_BOOL,    "false"        },
             {"max_sescmd_history",         MXS_MODULE_PARAM_COUNT,   "50"           },
+            {"compact_sescmd_history",     MXS_MODULE_PARAM_BOOL,    "true"         },
             {"strict_multi_stmt",          MXS_MODULE_PARAM_BOOL,    "false"        },
             {"strict_sp_calls",            MXS_MODULE_PARAM_BOOL,    "false"        },
             {"master_accept_reads",        MXS_MODULE_PARAM_BOOL,    "false"        },
@@ -522,6 +597,11 @@ extern "C" MXS_MODULE* MXS_CREATE_MODULE()
             {"transaction_replay",         MXS_MODULE_PARAM_BOOL,    "false"        },
             {"transaction_replay_max_size",MXS_MODULE_PARAM_SIZE,    "1Mi"          },
             {"optimistic_trx",             MXS_MODULE_PARAM_BOOL,    "false"        },
+            {"connection_multiplexing",    MXS_MODULE_PARAM_BOOL,    "false"        },
+            {"connection_multiplexing_idle_time", MXS_MODULE_PARAM_COUNT, "1"       },
+            {"hedged_reads",               MXS_MODULE_PARAM_BOOL,    "false"        },
+            {"hedged_read_delay",          MXS_MODULE_PARAM_COUNT,   "0"            },
+            {"lazy_connect",               MXS_MODULE_PARAM_BOOL,    "false"        },
             {MXS_END_MODULE_PARAMS}
         }
     };
@@ -38,6 +38,8 @@
 #include <maxscale/protocol/rwbackend.hh>
 #include <maxscale/session_stats.hh>
 
+#include "server_load.hh"
+
 enum backend_type_t
 {
     BE_UNDEFINED = -1,
@@ -66,7 +68,8 @@ enum select_criteria_t
     LEAST_ROUTER_CONNECTIONS,   /**< connections established by this router */
     LEAST_BEHIND_MASTER,
     LEAST_CURRENT_OPERATIONS,
-    ADAPTIVE_ROUTING
+    ADAPTIVE_ROUTING,
+    POWER_OF_TWO_CHOICES
 };
 
 /**
@@ -79,6 +82,15 @@ enum failure_mode
     RW_ERROR_ON_WRITE           /**< Don't close the connection but send an error for writes */
 };
 
+/**
+ * Controls how causal reads are done
+ */
+enum causal_reads_mode_t
+{
+    CAUSAL_READS_WAIT,          /**< Always wait for the slave to catch up */
+    CAUSAL_READS_TRACK          /**< Prefer slaves known to have caught up, wait only if there are none */
+};
+
 /**
  * Enum values for router parameters
  */
@@ -96,6 +108,7 @@ static const MXS_ENUM_VALUE slave_selection_criteria_values[] =
     {"LEAST_BEHIND_MASTER",      LEAST_BEHIND_MASTER     },
     {"LEAST_CURRENT_OPERATIONS", LEAST_CURRENT_OPERATIONS},
     {"ADAPTIVE_ROUTING",         ADAPTIVE_ROUTING        },
+    {"POWER_OF_TWO_CHOICES",     POWER_OF_TWO_CHOICES    },
     {NULL}
 };
 
@@ -107,6 +120,13 @@ static const MXS_ENUM_VALUE master_failure_mode_values[] =
     {NULL}
 };
 
+static const MXS_ENUM_VALUE causal_reads_mode_values[] =
+{
+    {"wait",  CAUSAL_READS_WAIT },
+    {"track", CAUSAL_READS_TRACK},
+    {NULL}
+};
+
 #define BREF_IS_NOT_USED(s)       ((s)->bref_state & ~BREF_IN_USE)
 #define BREF_IS_IN_USE(s)         ((s)->bref_state & BREF_IN_USE)
 #define BREF_IS_WAITING_RESULT(s) ((s)->bref_num_result_wait > 0)
@@ -137,6 +157,15 @@ using BackendSelectFunction = std::function
     <SRWBackendVector::iterator (SRWBackendVector& sBackends)>;
 BackendSelectFunction get_backend_select_function(select_criteria_t);
 
+/**
+ * Get the load of a server as seen by the current routing worker
+ *
+ * @param server The server
+ *
+ * @return The load of the server
+ */
+ServerLoad& local_server_load(const SERVER* server);
+
 struct Config
 {
     Config(MXS_CONFIG_PARAMETER* params)
@@ -153,6 +182,7 @@ struct Config
         , max_sescmd_history(config_get_integer(params, "max_sescmd_history"))
         , prune_sescmd_history(config_get_bool(params, "prune_sescmd_history"))
         , disable_sescmd_history(config_get_bool(params, "disable_sescmd_history"))
+        , compact_sescmd_history(config_get_bool(params, "compact_sescmd_history"))
         , master_accept_reads(config_get_bool(params, "master_accept_reads"))
         , strict_multi_stmt(config_get_bool(params, "strict_multi_stmt"))
         , strict_sp_calls(config_get_bool(params, "strict_sp_calls"))
@@ -163,12 +193,20 @@ struct Config
         , max_slave_connections(0)
         , causal_reads(config_get_bool(params, "causal_reads"))
         , causal_reads_timeout(config_get_string(params, "causal_reads_timeout"))
+        , causal_reads_mode(
+            (causal_reads_mode_t)config_get_enum(
+                params, "causal_reads_mode", causal_reads_mode_values))
         , master_reconnection(config_get_bool(params, "master_reconnection"))
         , delayed_retry(config_get_bool(params, "delayed_retry"))
         , delayed_retry_timeout(config_get_integer(params, "delayed_retry_timeout"))
         , transaction_replay(config_get_bool(params, "transaction_replay"))
         , trx_max_size(config_get_size(params, "transaction_replay_max_size"))
         , optimistic_trx(config_get_bool(params, "optimistic_trx"))
+        , connection_multiplexing(config_get_bool(params, "connection_multiplexing"))
+        , connection_multiplexing_idle_time(config_get_integer(params, "connection_multiplexing_idle_time"))
+        , hedged_reads(config_get_bool(params, "hedged_reads"))
+        , hedged_read_delay(config_get_integer(params, "hedged_read_delay"))
+        , lazy_connect(config_get_bool(params, "lazy_connect"))
     {
         if (causal_reads)
         {
@@ -208,6 +246,7 @@ struct Config
     uint64_t     max_sescmd_history;    /**< Maximum amount of session commands to store */
     bool         prune_sescmd_history;  /**< Prune session command history */
     bool         disable_sescmd_history;/**< Disable session command history */
+    bool         compact_sescmd_history;/**< Remove overridden commands from the history */
     bool         master_accept_reads;   /**< Use master for reads */
     bool         strict_multi_stmt;     /**< Force non-multistatement queries to be routed to
                                          * the master after a multistatement query. */
@@ -221,12 +260,21 @@ struct Config
     int         max_slave_connections;  /**< Maximum number of slaves for each connection*/
     bool        causal_reads;           /**< Enable causual read */
     std::string causal_reads_timeout;   /**< Timeout, second parameter of function master_wait_gtid */
+    causal_reads_mode_t causal_reads_mode;  /**< How slaves are synchronized for causal reads */
     bool        master_reconnection;    /**< Allow changes in master server */
     bool        delayed_retry;          /**< Delay routing if no target found */
     uint64_t    delayed_retry_timeout;  /**< How long to delay until an error is returned */
     bool        transaction_replay;     /**< Replay failed transactions */
     size_t      trx_max_size;           /**< Max transaction size for replaying */
     bool        optimistic_trx;         /**< Enable optimistic transactions */
+    bool        connection_multiplexing;/**< Release the connections of idle sessions */
+    int         connection_multiplexing_idle_time;  /**< Seconds idle before the connections are
+                                                     * released */
+    bool        hedged_reads;           /**< Send slow reads to a second slave */
+    int         hedged_read_delay;      /**< Milliseconds to wait before hedging a read, 0 for
+                                         * a delay based on the response time of the slave */
+    bool        lazy_connect;           /**< Connect to the slaves when the first read is
+                                         * routed to them */
 };
 
 /**
@@ -242,6 +290,18 @@ struct Stats
     uint64_t n_trx_replay = 0;      /**< Number of replayed transactions */
     uint64_t n_ro_trx = 0;          /**< Read-only transaction count */
     uint64_t n_rw_trx = 0;          /**< Read-write transaction count */
+    uint64_t n_released = 0;        /**< Number of times the connections of an idle session
+                                     * were released */
+    uint64_t n_reacquired = 0;      /**< Number of times released connections were reacquired */
+    uint64_t n_causal_no_wait = 0;  /**< Number of causal reads routed to a slave known to have
+                                     * caught up, without waiting for it */
+    uint64_t n_hedged = 0;          /**< Number of reads sent to a second slave */
+    uint64_t n_hedges_won = 0;      /**< Number of hedged reads the second slave replied to first */
+    uint64_t n_compacted = 0;       /**< Number of commands removed from session command histories
+                                     * because later commands overrode them */
+    uint64_t n_lazy_connected = 0;  /**< Number of slave connections created when a read needed them */
+    uint64_t n_lazy_avoided = 0;    /**< Number of slave connections never created because no read
+                                     * needed them */
 };
 
 using maxscale::ServerStats;
@@ -368,11 +428,30 @@ static inline const char* select_criteria_to_str(select_criteria_t type)
     case ADAPTIVE_ROUTING:
         return "ADAPTIVE_ROUTING";
 
+    case POWER_OF_TWO_CHOICES:
+        return "POWER_OF_TWO_CHOICES";
+
     default:
         return "UNDEFINED_CRITERIA";
     }
 }
 
+static inline const char* causal_reads_mode_to_str(causal_reads_mode_t type)
+{
+    switch (type)
+    {
+    case CAUSAL_READS_WAIT:
+        return "wait";
+
+    case CAUSAL_READS_TRACK:
+        return "track";
+
+    default:
+        mxb_assert(false);
+        return "UNDEFINED_MODE";
+    }
+}
+
 static inline const char* failure_mode_to_str(enum failure_mode type)
 {
     switch (type)
@@ -26,6 +26,7 @@
 #include <maxscale/modutil.hh>
 #include <maxscale/router.h>
 #include <maxscale/server.h>
+#include <maxscale/server.hh>
 #include <maxscale/session_command.hh>
 #include <maxscale/utils.hh>
 
@@ -89,6 +90,12 @@ bool RWSplitSession::prepare_target(SRWBackend& target, route_target_t route_tar
                                "should have unfinished session commands.");
             m_expected_responses++;
         }
+
+        if (rval && target->is_slave() && m_slaves_deferred > 0)
+        {
+            --m_slaves_deferred;
+            mxb::atomic::add(&m_router->stats().n_lazy_connected, 1, mxb::atomic::RELAXED);
+        }
     }
 
     return rval;
@@ -181,6 +188,40 @@ bool RWSplitSession::track_optimistic_trx(GWBUF** buffer)
     return store_stmt;
 }
 
+/**
+ * Check whether a statement leaves state on the connections that the session
+ * command history cannot recreate, which prevents connection multiplexing.
+ *
+ * @param querybuf     The statement
+ * @param route_target Where the statement is routed
+ * @param command      The command of the statement
+ * @param qtype        The type of the statement
+ *
+ * @return True if the connections must be kept for the rest of the session
+ */
+bool RWSplitSession::pins_connections(GWBUF* querybuf, route_target_t route_target,
+                                      uint8_t command, uint32_t qtype) const
+{
+    bool rval = false;
+    uint8_t flags = 0;
+
+    if (qc_query_is_type(qtype, QUERY_TYPE_USERVAR_WRITE) && !TARGET_IS_ALL(route_target))
+    {
+        // Only user variable writes routed to all servers are added to the history. Others, e.g.
+        // with use_sql_variables_in=master or a routing hint, are done on one server only.
+        rval = true;
+    }
+    else if (command == MXS_COM_STMT_EXECUTE
+             && gwbuf_copy_data(querybuf, MYSQL_PS_ID_OFFSET + MYSQL_PS_ID_SIZE, 1, &flags) == 1
+             && flags != 0)
+    {
+        // An open cursor is tied to the connection
+        rval = true;
+    }
+
+    return rval;
+}
+
 /**
  * Routing function. Find out query type, backend type, and target DCB(s).
  * Then route query to found target(s).
@@ -201,6 +242,12 @@ bool RWSplitSession::route_single_stmt(GWBUF* querybuf)
     route_target_t route_target = info.target();
 
     SRWBackend target;
+    bool hedge_read = false;
+
+    if (m_config.connection_multiplexing && !m_multiplex_pinned)
+    {
+        m_multiplex_pinned = pins_connections(querybuf, route_target, command, qtype);
+    }
 
     if (TARGET_IS_ALL(route_target))
     {
@@ -275,6 +322,8 @@ bool RWSplitSession::route_single_stmt(GWBUF* querybuf)
                     {
                         store_stmt = true;
                     }
+
+                    hedge_read = command == MXS_COM_QUERY;
                 }
             }
         }
@@ -338,6 +387,10 @@ bool RWSplitSession::route_single_stmt(GWBUF* querybuf)
                     m_exec_map[stmt_id] = target;
                     MXS_INFO("COM_STMT_EXECUTE on %s: %s", target->name(), target->uri());
                 }
+                else if (succp && hedge_read && can_hedge_read())
+                {
+                    schedule_hedged_read(querybuf, target);
+                }
             }
         }
         else if (can_retry_query() || can_continue_trx_replay())
@@ -551,6 +604,9 @@ bool RWSplitSession::route_session_write(GWBUF* querybuf, uint8_t command, uint3
         // Close to the history limit, remove the oldest command
         prune_to_position(m_sescmd_list.front()->get_position());
         m_sescmd_list.pop_front();
+
+        // The history no longer recreates the session state
+        m_multiplex_pinned = true;
     }
 
     if (m_config.disable_sescmd_history)
@@ -572,6 +628,7 @@ bool RWSplitSession::route_session_write(GWBUF* querybuf, uint8_t command, uint3
             /** The command doesn't generate a response so we increment the
              * completed session command count */
             m_recv_sescmd++;
+            compact_history(sescmd, MYSQL_REPLY_OK);
         }
     }
     else
@@ -689,6 +746,26 @@ SRWBackend RWSplitSession::get_slave_backend(int max_rlag)
         }
     }
 
+    if (causal_reads_track())
+    {
+        // Prefer the slaves known to have replicated the latest write of this session,
+        // they can be read from without waiting for them to catch up.
+        SRWBackendVector synced;
+
+        for (auto candidate : candidates)
+        {
+            if ((*candidate)->is_slave() && mxs::server_has_gtid_pos((*candidate)->server(), m_gtid_pos))
+            {
+                synced.push_back(candidate);
+            }
+        }
+
+        if (!synced.empty())
+        {
+            candidates.swap(synced);
+        }
+    }
+
     SRWBackendVector::const_iterator rval = find_best_backend(candidates,
                                                               m_config.backend_select_fct,
                                                               m_config.master_accept_reads);
@@ -696,6 +773,119 @@ SRWBackend RWSplitSession::get_slave_backend(int max_rlag)
     return (rval == candidates.end()) ? SRWBackend() : **rval;
 }
 
+/**
+ * Check whether the read that was just routed to a slave can be hedged, that
+ * is, sent to a second slave if the first one is slow to reply. Only reads done
+ * outside of transactions whose state is fully described by the session command
+ * history qualify, as the connection to the slower server is closed.
+ */
+bool RWSplitSession::can_hedge_read() const
+{
+    return m_config.hedged_reads
+           && m_hedge_state == HEDGE_NONE
+           && m_expected_responses == 1
+           && !(m_config.causal_reads && !m_gtid_pos.empty())
+           && !session_trx_is_active(m_client->session)
+           && !m_qc.large_query()
+           && m_qc.load_data_state() == QueryClassifier::LOAD_DATA_INACTIVE
+           && !m_is_replay_active
+           && m_otrx_state == OTRX_INACTIVE
+           && can_recover_servers();
+}
+
+/**
+ * Arrange for a read to be sent to a second slave if the first one has not
+ * started replying to it once the hedging delay has passed.
+ *
+ * @param querybuf The read
+ * @param target   The slave the read was routed to
+ */
+void RWSplitSession::schedule_hedged_read(GWBUF* querybuf, SRWBackend& target)
+{
+    int delay = m_config.hedged_read_delay;
+
+    if (delay == 0 && server_response_time_num_samples(target->server()) > 0)
+    {
+        // A reply that takes three times as long as usual is considered late
+        delay = MXS_MAX(3000 * server_response_time_average(target->server()), 1);
+    }
+
+    if (delay > 0)
+    {
+        m_hedge_state = HEDGE_PENDING;
+        m_hedge_first = target;
+        m_hedge_query.copy_from(querybuf);
+        m_hedge_call_id = mxb::Worker::get_current()->delayed_call(delay,
+                                                                   &RWSplitSession::send_hedged_read,
+                                                                   this);
+    }
+}
+
+bool RWSplitSession::send_hedged_read(mxb::Worker::Call::action_t action)
+{
+    m_hedge_call_id = 0;
+
+    if (action == mxb::Worker::Call::EXECUTE && m_hedge_state == HEDGE_PENDING)
+    {
+        SRWBackend target = get_hedge_backend();
+
+        if (target && target->write(gwbuf_clone(m_hedge_query.get()), mxs::Backend::EXPECT_RESPONSE))
+        {
+            MXS_INFO("No reply from '%s' in time, hedging read to '%s'",
+                     m_hedge_first->name(), target->name());
+
+            m_hedge_state = HEDGE_SENT;
+            m_hedge_second = target;
+            m_expected_responses++;
+            track_request_started(target);
+
+            target->select_started();
+            target->response_stat().query_started();
+
+            mxb::atomic::add(&m_router->stats().n_hedged, 1, mxb::atomic::RELAXED);
+            mxb::atomic::add(&target->server()->stats.packets, 1, mxb::atomic::RELAXED);
+            m_server_stats[target->server()].total++;
+        }
+        else
+        {
+            end_hedged_read();
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Find the slave a read is hedged to. Only idle connections that are already
+ * open are considered, a new connection would take too long to be of use.
+ *
+ * @return The slave or an empty reference if there is none
+ */
+SRWBackend RWSplitSession::get_hedge_backend()
+{
+    SRWBackendVector candidates;
+    int max_rlag = get_max_replication_lag();
+
+    for (auto& backend : m_backends)
+    {
+        if (backend != m_hedge_first
+            && backend->in_use()
+            && backend->is_slave()
+            && !backend->has_session_commands()
+            && !backend->is_waiting_result()
+            && rpl_lag_is_ok(backend, max_rlag))
+        {
+            candidates.push_back(&backend);
+        }
+    }
+
+    SRWBackendVector::const_iterator rval = find_best_backend(candidates,
+                                                              m_config.backend_select_fct,
+                                                              false);
+
+    return (rval == candidates.end()) ? SRWBackend() : **rval;
+}
+
 SRWBackend RWSplitSession::get_master_backend()
 {
     SRWBackend rval;
@@ -1199,12 +1389,20 @@ bool RWSplitSession::handle_got_target(GWBUF* querybuf, SRWBackend& target, bool
     if (m_config.causal_reads && cmd == COM_QUERY && !m_gtid_pos.empty()
         && target->is_slave())
     {
-        // Perform the causal read only when the query is routed to a slave
-        send_buf = add_prefix_wait_gtid(target->server(), send_buf);
-        m_wait_gtid = WAITING_FOR_HEADER;
+        if (causal_reads_track() && mxs::server_has_gtid_pos(target->server(), m_gtid_pos))
+        {
+            // The slave has already replicated the latest write of this session
+            mxb::atomic::add(&m_router->stats().n_causal_no_wait, 1, mxb::atomic::RELAXED);
+        }
+        else
+        {
+            // Perform the causal read only when the query is routed to a slave
+            send_buf = add_prefix_wait_gtid(target->server(), send_buf);
+            m_wait_gtid = WAITING_FOR_HEADER;
 
-        // The storage for causal reads is done inside add_prefix_wait_gtid
-        store = false;
+            // The storage for causal reads is done inside add_prefix_wait_gtid
+            store = false;
+        }
     }
 
     if (m_qc.load_data_state() != QueryClassifier::LOAD_DATA_ACTIVE
@@ -1259,6 +1457,7 @@ bool RWSplitSession::handle_got_target(GWBUF* querybuf, SRWBackend& target, bool
         {
             /** The server will reply to this command */
             m_expected_responses++;
+            track_request_started(target);
 
             if (m_qc.load_data_state() == QueryClassifier::LOAD_DATA_END)
             {
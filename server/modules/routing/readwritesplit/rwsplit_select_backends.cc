@@ -18,6 +18,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <algorithm>
 #include <sstream>
 #include <functional>
 #include <random>
@@ -178,6 +179,62 @@ SRWBackendVector::iterator backend_cmp_response_time(SRWBackendVector& sBackends
     return sBackends.begin() + winner;
 }
 
+namespace
+{
+// The load of the servers as seen by this worker and the random numbers for picking between them
+thread_local std::unordered_map<const SERVER*, ServerLoad> server_loads;
+thread_local std::mt19937 p2c_random_engine;
+}
+
+ServerLoad& local_server_load(const SERVER* server)
+{
+    return server_loads[server];
+}
+
+/**
+ * Pick two servers at random and choose the one with the lower product of response
+ * time and requests in progress. Servers whose response time is not yet known are
+ * expected to be as fast as the fastest known one.
+ */
+SRWBackendVector::iterator backend_cmp_p2c(SRWBackendVector& sBackends)
+{
+    const int SZ = sBackends.size();
+    double costs[SZ];
+    double fastest = 0;
+    double now = ServerLoad::now();
+
+    for (int i = 0; i < SZ; ++i)
+    {
+        double latency = local_server_load((**sBackends[i]).server()).latency(now);
+
+        if (latency > 0 && (fastest == 0 || latency < fastest))
+        {
+            fastest = latency;
+        }
+    }
+
+    if (fastest == 0)
+    {
+        // Nothing is known yet, compare the requests in progress
+        fastest = 1;
+    }
+
+    for (int i = 0; i < SZ; ++i)
+    {
+        SERVER_REF* server = (**sBackends[i]).backend();
+        costs[i] = server->server_weight ?
+            local_server_load(server->server).cost(fastest, now) / server->server_weight :
+            std::numeric_limits<double>::max();
+    }
+
+    size_t winner = power_of_two_choices(costs, SZ, [](size_t n) {
+                                             return std::uniform_int_distribution<size_t>(0, n - 1)(
+                                                 p2c_random_engine);
+                                         });
+
+    return sBackends.begin() + winner;
+}
+
 BackendSelectFunction get_backend_select_function(select_criteria_t sc)
 {
     switch (sc)
@@ -196,6 +253,9 @@ BackendSelectFunction get_backend_select_function(select_criteria_t sc)
 
     case ADAPTIVE_ROUTING:
         return backend_cmp_response_time;
+
+    case POWER_OF_TWO_CHOICES:
+        return backend_cmp_p2c;
     }
 
     assert(false && "incorrect use of select_criteria_t");
@@ -436,6 +496,16 @@ bool RWSplit::select_connect_backend_servers(MXS_SESSION* session,
 
     mxb_assert(slaves_connected <= max_nslaves || max_nslaves == 0);
 
+    if (cnf.lazy_connect)
+    {
+        // The slaves are connected when the first read is routed to them. One is connected
+        // only if there is no other connection, so that the session can route something.
+        bool in_use = std::any_of(backends.begin(), backends.end(), [](const SRWBackend& b) {
+                                      return b->in_use();
+                                  });
+        max_nslaves = std::min(max_nslaves, slaves_connected + (in_use ? 0 : 1));
+    }
+
     SRWBackendVector candidates;
     for (auto& sBackend : backends)
     {
@@ -20,6 +20,8 @@
 #include <stdlib.h>
 #include <stdint.h>
 
+#include <algorithm>
+
 #include <maxscale/router.h>
 
 using namespace maxscale;
@@ -82,6 +84,52 @@ static void discard_if_response_differs(SRWBackend backend,
     }
 }
 
+/**
+ * Get the session state that a session command sets
+ *
+ * @param sescmd The session command
+ *
+ * @return The state the command sets
+ */
+static SescmdState get_sescmd_state(SessionCommand& sescmd)
+{
+    SescmdState state;
+
+    switch (sescmd.get_command())
+    {
+    case MXS_COM_QUERY:
+        state = get_query_state(sescmd.to_string());
+        break;
+
+    case MXS_COM_INIT_DB:
+        state = init_db_state();
+        break;
+
+    case MXS_COM_STMT_PREPARE:
+        state = stmt_prepare_state(sescmd.get_position());
+        break;
+
+    case MXS_COM_STMT_CLOSE:
+        {
+            GWBUF* buffer = sescmd.deep_copy_buffer();
+
+            if (buffer)
+            {
+                uint8_t id[MYSQL_PS_ID_SIZE];
+                gwbuf_copy_data(buffer, MYSQL_PS_ID_OFFSET, sizeof(id), id);
+                gwbuf_free(buffer);
+                state = stmt_close_state(gw_mysql_get_byte4(id));
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return state;
+}
+
 void RWSplitSession::process_sescmd_response(SRWBackend& backend, GWBUF** ppPacket)
 {
     if (backend->has_session_commands())
@@ -115,6 +163,7 @@ void RWSplitSession::process_sescmd_response(SRWBackend& backend, GWBUF** ppPack
                 /** Store the master's response so that the slave responses can
                  * be compared to it */
                 m_sescmd_responses[id] = cmd;
+                compact_history(sescmd, cmd);
 
                 if (cmd == MYSQL_REPLY_ERR)
                 {
@@ -178,6 +227,7 @@ void RWSplitSession::process_sescmd_response(SRWBackend& backend, GWBUF** ppPack
 
             m_sescmd_list.clear();
             m_sescmd_responses.clear();
+            m_sescmd_compaction.clear();
 
             // Push the response back as the first executed session command
             m_sescmd_list.push_back(latest);
@@ -190,3 +240,70 @@ void RWSplitSession::process_sescmd_response(SRWBackend& backend, GWBUF** ppPack
         }
     }
 }
+
+/**
+ * Remove a session command that later commands have made unnecessary from the history
+ *
+ * @param pos The position of the command
+ *
+ * @return True if the command was in the history
+ */
+bool RWSplitSession::remove_from_history(uint64_t pos)
+{
+    auto it = std::find_if(m_sescmd_list.rbegin(), m_sescmd_list.rend(), [pos](const SSessionCommand& s) {
+                               return s->get_position() == pos;
+                           });
+    bool found = it != m_sescmd_list.rend();
+
+    if (found)
+    {
+        MXS_INFO("Removing session command no. %lu from the history", pos);
+        m_sescmd_list.erase(std::next(it).base());
+        mxb::atomic::add(&m_router->stats().n_compacted, 1, mxb::atomic::RELAXED);
+
+        // The response is still needed if a backend has yet to execute the command
+        bool pending = false;
+
+        for (const auto& backend : m_backends)
+        {
+            if (backend->in_use() && backend->has_session_commands()
+                && backend->next_session_command()->get_position() <= pos)
+            {
+                pending = true;
+                break;
+            }
+        }
+
+        if (!pending)
+        {
+            m_sescmd_responses.erase(pos);
+        }
+    }
+
+    return found;
+}
+
+/**
+ * Compact the session command history
+ *
+ * Removes the earlier command that set the same session state as the given
+ * command, as long as no command in between could depend on it. This keeps
+ * the history from growing when the same variables are set over and over again
+ * and reduces the number of commands executed when new connections are created.
+ * The commands must be passed to this function in the order they were executed.
+ *
+ * @param sescmd   The completed session command
+ * @param response The response to the command
+ */
+void RWSplitSession::compact_history(SSessionCommand& sescmd, uint8_t response)
+{
+    if (m_config.compact_sescmd_history)
+    {
+        // A failed command does not change the session state but it may have failed because of it
+        SescmdState state = response != MYSQL_REPLY_ERR ? get_sescmd_state(*sescmd) : SescmdState();
+
+        m_sescmd_compaction.add(sescmd->get_position(), state, [this](uint64_t pos) {
+                                    return remove_from_history(pos);
+                                });
+    }
+}
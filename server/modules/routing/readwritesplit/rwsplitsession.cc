@@ -18,6 +18,7 @@
 #include <maxscale/modutil.hh>
 #include <maxscale/poll.h>
 #include <maxscale/clock.h>
+#include <maxscale/server.hh>
 
 using namespace maxscale;
 
@@ -46,6 +47,12 @@ RWSplitSession::RWSplitSession(RWSplit* instance,
     , m_is_replay_active(false)
     , m_can_replay_trx(true)
     , m_server_stats(instance->local_server_stats())
+    , m_release_call_id(0)
+    , m_idle_since(0)
+    , m_multiplex_pinned(false)
+    , m_hedge_state(HEDGE_NONE)
+    , m_hedge_call_id(0)
+    , m_slaves_deferred(0)
 {
     if (m_config.rw_max_slave_conn_percent)
     {
@@ -81,6 +88,14 @@ RWSplitSession* RWSplitSession::create(RWSplit* router, MXS_SESSION* session)
             if ((rses = new RWSplitSession(router, session, backends, master)))
             {
                 router->stats().n_sessions += 1;
+
+                if (rses->m_config.lazy_connect)
+                {
+                    // The slaves that would have been connected right away
+                    auto counts = get_slave_counts(backends, master);
+                    rses->m_slaves_deferred = MXS_MAX(MXS_MIN(counts.first, router->max_slave_count())
+                                                      - counts.second, 0);
+                }
             }
 
             for (auto& b : backends)
@@ -108,8 +123,19 @@ void close_all_connections(SRWBackendList& backends)
 
 void RWSplitSession::close()
 {
+    if (m_release_call_id)
+    {
+        mxb::Worker::get_current()->cancel_delayed_call(m_release_call_id);
+        m_release_call_id = 0;
+    }
+
+    end_hedged_read();
+    mxb::atomic::add(&m_router->stats().n_lazy_avoided, m_slaves_deferred, mxb::atomic::RELAXED);
+    m_slaves_deferred = 0;
+    m_released.clear();
     gwbuf_free(m_query_queue);
     close_all_connections(m_backends);
+    release_abandoned_requests();
     m_current_query.reset();
 
     for (auto& backend : m_backends)
@@ -143,6 +169,21 @@ int32_t RWSplitSession::routeQuery(GWBUF* querybuf)
         return 1;
     }
 
+    if (!m_released.empty())
+    {
+        if (mxs_mysql_get_command(querybuf) == MXS_COM_QUIT)
+        {
+            // No need to reconnect only to disconnect
+            gwbuf_free(querybuf);
+            return 1;
+        }
+        else if (!reacquire_connections())
+        {
+            gwbuf_free(querybuf);
+            return 0;
+        }
+    }
+
     if (m_query_queue == NULL
         && (m_expected_responses == 0
             || m_qc.load_data_state() == QueryClassifier::LOAD_DATA_ACTIVE
@@ -428,6 +469,12 @@ GWBUF* RWSplitSession::handle_causal_read_reply(GWBUF* writebuf, SRWBackend& bac
         if (m_wait_gtid == WAITING_FOR_HEADER)
         {
             writebuf = discard_master_wait_gtid_result(writebuf);
+
+            if (m_wait_gtid == UPDATING_PACKETS && m_config.causal_reads_mode == CAUSAL_READS_TRACK)
+            {
+                // The slave has caught up, the next reads need not wait for it
+                mxs::server_advance_gtid_pos(backend->server(), m_gtid_pos);
+            }
         }
 
         if (m_wait_gtid == UPDATING_PACKETS && writebuf)
@@ -616,6 +663,11 @@ void RWSplitSession::clientReply(GWBUF* writebuf, DCB* backend_dcb)
         return;
     }
 
+    if (m_hedge_state != HEDGE_NONE)
+    {
+        handle_hedged_reply(backend);
+    }
+
     if ((writebuf = handle_causal_read_reply(writebuf, backend)) == NULL)
     {
         return;     // Nothing to route, return
@@ -630,6 +682,7 @@ void RWSplitSession::clientReply(GWBUF* writebuf, DCB* backend_dcb)
     {
         /** Got a complete reply, decrement expected response count */
         m_expected_responses--;
+        track_request_ended(backend);
 
         session_book_server_response(m_pSession, backend->backend()->server, m_expected_responses == 0);
 
@@ -777,6 +830,286 @@ void RWSplitSession::clientReply(GWBUF* writebuf, DCB* backend_dcb)
          * before all responses have been received.
          */
         close_stale_connections();
+
+        if (m_config.connection_multiplexing)
+        {
+            schedule_release();
+        }
+    }
+}
+
+/**
+ * Check whether the backend connections can be released while the session is
+ * idle. The state of a connection must be fully recoverable by replaying the
+ * session command history, so nothing may be in progress and nothing may have
+ * been done that the history does not record. The servers must also have a
+ * persistent connection pool to return the connections to.
+ *
+ * @return True if the connections can be released
+ */
+bool RWSplitSession::can_release_connections() const
+{
+    bool rval = m_config.connection_multiplexing
+        && !m_multiplex_pinned
+        && can_recover_servers()
+        && m_expected_responses == 0
+        && !m_query_queue
+        && !session_trx_is_active(m_client->session)
+        && !m_target_node
+        && !m_qc.have_tmp_tables()
+        && m_qc.load_data_state() == QueryClassifier::LOAD_DATA_INACTIVE
+        && !m_qc.large_query()
+        && !m_is_replay_active
+        && m_otrx_state == OTRX_INACTIVE
+        && m_wait_gtid == NONE;
+
+    if (rval)
+    {
+        int n_in_use = 0;
+
+        for (const auto& backend : m_backends)
+        {
+            if (backend->in_use())
+            {
+                if (backend->has_session_commands() || !backend->reply_is_complete()
+                    || backend->server()->persistpoolmax == 0)
+                {
+                    // Without a connection pool, releasing would only close and reopen the connection
+                    rval = false;
+                    break;
+                }
+
+                ++n_in_use;
+            }
+        }
+
+        rval = rval && n_in_use > 0;
+    }
+
+    return rval;
+}
+
+/**
+ * Called when the session becomes idle. Releases the connections right away or
+ * makes sure that a check is done once the idle time has passed.
+ */
+void RWSplitSession::schedule_release()
+{
+    if (can_release_connections())
+    {
+        if (m_config.connection_multiplexing_idle_time == 0)
+        {
+            release_connections();
+        }
+        else
+        {
+            m_idle_since = mxs_clock();
+
+            if (!m_release_call_id)
+            {
+                m_release_call_id = mxb::Worker::get_current()->delayed_call(
+                    m_config.connection_multiplexing_idle_time * 1000,
+                    &RWSplitSession::release_idle_connections,
+                    this);
+            }
+        }
+    }
+}
+
+bool RWSplitSession::release_idle_connections(mxb::Worker::Call::action_t action)
+{
+    bool repeat = false;
+
+    if (action == mxb::Worker::Call::EXECUTE && can_release_connections())
+    {
+        int64_t idle_time = MXS_SEC_TO_CLOCK(m_config.connection_multiplexing_idle_time);
+
+        if (mxs_clock() - m_idle_since >= idle_time)
+        {
+            release_connections();
+        }
+        else
+        {
+            // The session was used since the call was scheduled, check again later
+            repeat = true;
+        }
+    }
+
+    if (!repeat)
+    {
+        m_release_call_id = 0;
+    }
+
+    return repeat;
+}
+
+/**
+ * Close the backend connections of an idle session. The connections are placed
+ * into the persistent connection pool of the servers, if they have one, from
+ * where any session of the same user can take them.
+ */
+void RWSplitSession::release_connections()
+{
+    mxb_assert(m_released.empty());
+
+    for (auto& backend : m_backends)
+    {
+        if (backend->in_use())
+        {
+            backend->set_close_reason("Returned to the connection pool while idle");
+            backend->close(mxs::Backend::CLOSE_IDLE);
+            m_released.push_back(backend);
+        }
+    }
+
+    MXS_INFO("Released %lu idle connections", m_released.size());
+    mxb::atomic::add(&m_router->stats().n_released, 1, mxb::atomic::RELAXED);
+}
+
+/**
+ * Reconnect to the servers whose connections were released. The session command
+ * history is replayed on the new connections and the query being routed is
+ * queued until that is done.
+ *
+ * @return True if at least one connection could be created
+ */
+bool RWSplitSession::reacquire_connections()
+{
+    int n_connected = 0;
+
+    for (auto& backend : m_released)
+    {
+        if (backend->can_connect() && backend->connect(m_client->session, &m_sescmd_list))
+        {
+            ++n_connected;
+
+            if (backend->is_waiting_result())
+            {
+                m_expected_responses++;
+            }
+        }
+    }
+
+    m_released.clear();
+
+    if (n_connected == 0)
+    {
+        MXS_ERROR("Could not reacquire any of the connections released while the session was idle.");
+    }
+    else
+    {
+        mxb::atomic::add(&m_router->stats().n_reacquired, 1, mxb::atomic::RELAXED);
+    }
+
+    return n_connected > 0;
+}
+
+/**
+ * Called when a reply starts arriving while a read is being hedged. The server
+ * that replies first gets to answer the read and the connection to the other
+ * one, if the read was sent to it, is closed as its reply is not needed.
+ *
+ * @param backend The backend the reply is coming from
+ */
+void RWSplitSession::handle_hedged_reply(SRWBackend& backend)
+{
+    if (m_hedge_state == HEDGE_SENT)
+    {
+        SRWBackend loser = backend == m_hedge_first ? m_hedge_second : m_hedge_first;
+        mxb_assert(backend == m_hedge_first || backend == m_hedge_second);
+
+        if (backend == m_hedge_second)
+        {
+            mxb::atomic::add(&m_router->stats().n_hedges_won, 1, mxb::atomic::RELAXED);
+        }
+
+        MXS_INFO("Hedged read answered by '%s', closing connection to '%s'",
+                 backend->name(), loser->name());
+
+        // Record how long the slower server took so far, it is at least this slow
+        loser->response_stat().query_ended();
+        track_request_ended(loser);
+        loser->set_close_reason("Lost a hedged read to '" + std::string(backend->name()) + "'");
+        loser->close();
+        m_expected_responses--;
+        m_prev_target = backend;
+    }
+
+    end_hedged_read();
+}
+
+/**
+ * Stop hedging the current read
+ */
+void RWSplitSession::end_hedged_read()
+{
+    if (m_hedge_call_id)
+    {
+        mxb::Worker::get_current()->cancel_delayed_call(m_hedge_call_id);
+        m_hedge_call_id = 0;
+    }
+
+    m_hedge_state = HEDGE_NONE;
+    m_hedge_first.reset();
+    m_hedge_second.reset();
+    m_hedge_query.reset();
+}
+
+/**
+ * Count a request sent to a server in the load of the server, if the load is
+ * used for choosing the slaves
+ *
+ * @param backend The backend the request was sent to
+ */
+void RWSplitSession::track_request_started(SRWBackend& backend)
+{
+    if (m_config.slave_selection_criteria == POWER_OF_TWO_CHOICES)
+    {
+        release_abandoned_requests();
+        local_server_load(backend->server()).request_started();
+        m_load_started.emplace_back(backend.get(), ServerLoad::now());
+    }
+}
+
+/**
+ * Remove a request from the load of a server once the server has replied to it
+ * and add the response time to the load
+ *
+ * @param backend The backend that replied
+ */
+void RWSplitSession::track_request_ended(SRWBackend& backend)
+{
+    for (auto it = m_load_started.begin(); it != m_load_started.end(); ++it)
+    {
+        if (it->first == backend.get())
+        {
+            ServerLoad& load = local_server_load(backend->server());
+            double now = ServerLoad::now();
+            load.request_ended();
+            load.add_sample(now - it->second, now);
+            m_load_started.erase(it);
+            break;
+        }
+    }
+}
+
+/**
+ * Remove the requests to which no reply is coming, because the connection was
+ * closed, from the load of the servers
+ */
+void RWSplitSession::release_abandoned_requests()
+{
+    for (auto it = m_load_started.begin(); it != m_load_started.end();)
+    {
+        if (!it->first->in_use() || !it->first->is_waiting_result())
+        {
+            local_server_load(it->first->server()).request_ended();
+            it = m_load_started.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
     }
 }
 
@@ -1065,39 +1398,55 @@ bool RWSplitSession::handle_error_new_connection(DCB* backend_dcb, GWBUF* errmsg
     SRWBackend& backend = get_backend_from_dcb(backend_dcb);
     MXS_SESSION* ses = backend_dcb->session;
     bool route_stored = false;
+    bool hedge_continues = false;
+
+    if (m_hedge_state != HEDGE_NONE && (backend == m_hedge_first || backend == m_hedge_second))
+    {
+        // If the read was sent to two servers, the other one can still answer it
+        hedge_continues = m_hedge_state == HEDGE_SENT;
+        end_hedged_read();
+    }
 
     if (backend->is_waiting_result())
     {
         mxb_assert(m_expected_responses > 0);
         m_expected_responses--;
 
-        /**
-         * A query was sent through the backend and it is waiting for a reply.
-         * Try to reroute the statement to a working server or send an error
-         * to the client.
-         */
-        GWBUF* stored = m_current_query.release();
-
-        if (stored && m_config.retry_failed_reads)
+        if (hedge_continues)
         {
-            MXS_INFO("Re-routing failed read after server '%s' failed", backend->name());
-            retry_query(stored, 0);
+            MXS_INFO("Server '%s' failed during a hedged read, waiting for the other server",
+                     backend->name());
         }
         else
         {
-            gwbuf_free(stored);
+            /**
+             * A query was sent through the backend and it is waiting for a reply.
+             * Try to reroute the statement to a working server or send an error
+             * to the client.
+             */
+            GWBUF* stored = m_current_query.release();
 
-            if (!backend->has_session_commands())
+            if (stored && m_config.retry_failed_reads)
             {
-                /** The backend was not executing a session command so the client
-                 * is expecting a response. Send an error so they know to proceed. */
-                m_client->func.write(m_client, gwbuf_clone(errmsg));
+                MXS_INFO("Re-routing failed read after server '%s' failed", backend->name());
+                retry_query(stored, 0);
             }
-
-            if (m_expected_responses == 0)
+            else
             {
-                // This was the last response, try to route pending queries
-                route_stored = true;
+                gwbuf_free(stored);
+
+                if (!backend->has_session_commands())
+                {
+                    /** The backend was not executing a session command so the client
+                     * is expecting a response. Send an error so they know to proceed. */
+                    m_client->func.write(m_client, gwbuf_clone(errmsg));
+                }
+
+                if (m_expected_responses == 0)
+                {
+                    // This was the last response, try to route pending queries
+                    route_stored = true;
+                }
             }
         }
     }
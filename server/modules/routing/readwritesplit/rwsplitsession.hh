@@ -13,9 +13,11 @@
 #pragma once
 
 #include "readwritesplit.hh"
+#include "sescmd_compaction.hh"
 #include "trx.hh"
 
 #include <string>
+#include <vector>
 
 #include <maxscale/buffer.hh>
 #include <maxscale/modutil.h>
@@ -40,6 +42,9 @@ typedef std::list<std::pair<mxs::SRWBackend, uint8_t>> SlaveResponseList;
 /** Map of COM_STMT_EXECUTE targets by internal ID */
 typedef std::unordered_map<uint32_t, mxs::SRWBackend> ExecMap;
 
+/** Requests counted in the load of the servers and when they were sent */
+typedef std::vector<std::pair<mxs::RWBackend*, double>> LoadStartList;
+
 /**
  * The client session of a RWSplit instance
  */
@@ -77,6 +82,13 @@ public:
         UPDATING_PACKETS
     };
 
+    enum hedge_state
+    {
+        HEDGE_NONE,     // No hedged read in progress
+        HEDGE_PENDING,  // Read sent to one slave, a second one is used if it does not reply in time
+        HEDGE_SENT      // Read sent to two slaves, the first one to reply is used
+    };
+
     virtual ~RWSplitSession()
     {
     }
@@ -146,6 +158,7 @@ public:
     RWSplit*                m_router;           /**< The router instance */
     mxs::SessionCommandList m_sescmd_list;      /**< List of executed session commands */
     ResponseMap             m_sescmd_responses; /**< Response to each session command */
+    SescmdCompaction        m_sescmd_compaction;/**< Compaction of the session command history */
     SlaveResponseList       m_slave_responses;  /**< Slaves that replied before the master */
     uint64_t                m_sent_sescmd;      /**< ID of the last sent session command*/
     uint64_t                m_recv_sescmd;      /**< ID of the most recently completed session
@@ -173,6 +186,24 @@ public:
                                      * This avoids the lookup involved in getting the worker-local value from
                                      * the worker's container.*/
 
+    mxs::SRWBackendList m_released;             /**< Backends released while the session was idle */
+    uint32_t            m_release_call_id;      /**< The delayed call releasing the backends */
+    int64_t             m_idle_since;           /**< When the session became idle, in ticks */
+    bool                m_multiplex_pinned;     /**< Whether the session state prevents the
+                                                 * releasing of the backends */
+
+    hedge_state     m_hedge_state;              /**< State of the hedged read */
+    mxs::SRWBackend m_hedge_first;              /**< The slave the read was routed to */
+    mxs::SRWBackend m_hedge_second;             /**< The slave the read was hedged to */
+    mxs::Buffer     m_hedge_query;              /**< The read being hedged */
+    uint32_t        m_hedge_call_id;            /**< The delayed call hedging the read */
+
+    LoadStartList   m_load_started;             /**< When the requests counted in the server
+                                                 * load were sent */
+
+    int m_slaves_deferred;                      /**< Number of slave connections not created when
+                                                 * the session started, with lazy_connect */
+
 private:
     RWSplitSession(RWSplit* instance,
                    MXS_SESSION* session,
@@ -181,6 +212,8 @@ private:
 
     void process_sescmd_response(mxs::SRWBackend& backend, GWBUF** ppPacket);
     void compress_history(mxs::SSessionCommand& sescmd);
+    void compact_history(mxs::SSessionCommand& sescmd, uint8_t response);
+    bool remove_from_history(uint64_t pos);
 
     void prune_to_position(uint64_t pos);
     bool route_session_write(GWBUF* querybuf, uint8_t command, uint32_t type);
@@ -189,6 +222,24 @@ private:
     bool route_stored_query();
     void close_stale_connections();
 
+    bool pins_connections(GWBUF* querybuf, route_target_t route_target, uint8_t command, uint32_t qtype) const;
+    bool can_release_connections() const;
+    void schedule_release();
+    bool release_idle_connections(mxb::Worker::Call::action_t action);
+    void release_connections();
+    bool reacquire_connections();
+
+    bool            can_hedge_read() const;
+    void            schedule_hedged_read(GWBUF* querybuf, mxs::SRWBackend& target);
+    bool            send_hedged_read(mxb::Worker::Call::action_t action);
+    mxs::SRWBackend get_hedge_backend();
+    void            handle_hedged_reply(mxs::SRWBackend& backend);
+    void            end_hedged_read();
+
+    void track_request_started(mxs::SRWBackend& backend);
+    void track_request_ended(mxs::SRWBackend& backend);
+    void release_abandoned_requests();
+
     mxs::SRWBackend get_hinted_backend(char* name);
     mxs::SRWBackend get_slave_backend(int max_rlag);
     mxs::SRWBackend get_master_backend();
@@ -289,6 +340,13 @@ private:
         return !m_config.disable_sescmd_history || m_recv_sescmd == 0;
     }
 
+    // Whether causal reads should prefer the slaves known to have caught up
+    inline bool causal_reads_track() const
+    {
+        return m_config.causal_reads && m_config.causal_reads_mode == CAUSAL_READS_TRACK
+               && !m_gtid_pos.empty();
+    }
+
     inline bool is_large_query(GWBUF* buf)
     {
         uint32_t buflen = gwbuf_length(buf);
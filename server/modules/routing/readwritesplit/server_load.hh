@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxscale/ccdefs.hh>
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <chrono>
+
+// The load of a server as seen by one routing worker, for POWER_OF_TWO_CHOICES
+class ServerLoad
+{
+public:
+    // How much weight a new response time sample has in the average
+    static constexpr double ALPHA = 0.2;
+
+    // In how many seconds the average halves when no replies are received, so that
+    // a server that is avoided because it was slow is eventually tried again
+    static constexpr double HALF_LIFE = 1.0;
+
+    /**
+     * @return The current time in seconds, for the functions that take the time
+     */
+    static double now()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * Called when a request is sent to the server
+     */
+    void request_started()
+    {
+        ++m_outstanding;
+    }
+
+    /**
+     * Called when the server has replied to a request or the request was abandoned
+     */
+    void request_ended()
+    {
+        if (m_outstanding > 0)
+        {
+            --m_outstanding;
+        }
+    }
+
+    /**
+     * Add a response time sample
+     *
+     * @param seconds The response time of a request
+     * @param now     The current time in seconds
+     */
+    void add_sample(double seconds, double now)
+    {
+        double current = latency(now);
+        m_latency = current > 0 ? current + ALPHA * (seconds - current) : seconds;
+        m_updated = now;
+    }
+
+    /**
+     * The weighted average response time
+     *
+     * @param now The current time in seconds
+     *
+     * @return The average in seconds, 0 if not yet known
+     */
+    double latency(double now) const
+    {
+        return now > m_updated ? m_latency * exp2((m_updated - now) / HALF_LIFE) : m_latency;
+    }
+
+    /**
+     * @return The number of requests sent to the server that have not been replied to
+     */
+    int64_t outstanding() const
+    {
+        return m_outstanding;
+    }
+
+    /**
+     * The expected cost of sending one more request to the server
+     *
+     * @param latency The response time to use if the own one is not yet known
+     * @param now     The current time in seconds
+     *
+     * @return The cost, the lower the better
+     */
+    double cost(double latency, double now) const
+    {
+        double own = this->latency(now);
+        return (own > 0 ? own : latency) * (m_outstanding + 1);
+    }
+
+private:
+    double  m_latency = 0;      // The average at the time of the last update
+    double  m_updated = 0;      // When the average was last updated
+    int64_t m_outstanding = 0;
+};
+
+/**
+ * Pick one of the candidates with the power of two choices: two different
+ * candidates are picked at random and the cheaper one of them is chosen. This
+ * avoids sending every request to the same server the way always choosing the
+ * cheapest one would, while still steering the load away from expensive ones.
+ *
+ * @param costs   The costs of the candidates, the lower the better
+ * @param n       The number of candidates, at least one
+ * @param random  Function returning a random integer from 0 to the given value minus one
+ *
+ * @return The index of the chosen candidate
+ */
+template<class Random>
+size_t power_of_two_choices(const double* costs, size_t n, Random random)
+{
+    size_t rval = 0;
+
+    if (n > 1)
+    {
+        size_t a = random(n);
+        size_t b = random(n - 1);
+
+        if (b >= a)
+        {
+            ++b;
+        }
+
+        rval = costs[b] < costs[a] ? b : a;
+    }
+
+    return rval;
+}
@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxscale/ccdefs.hh>
+
+#include <ctype.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// The compaction of the session command history, for compact_sescmd_history
+
+/**
+ * What a session command depends on, in addition to its own contents
+ */
+enum sescmd_reads
+{
+    SESCMD_READS_NOTHING,       /**< Only literal values */
+    SESCMD_READS_VARIABLES,     /**< The variables and the default database */
+    SESCMD_READS_EVERYTHING     /**< Anything set by the earlier commands */
+};
+
+/**
+ * The session state that a session command sets
+ */
+struct SescmdState
+{
+    std::string  key;                               /**< The state, empty if not known */
+    sescmd_reads reads = SESCMD_READS_EVERYTHING;   /**< What the command depends on */
+    bool         drops = false;                     /**< Whether the state is removed */
+    bool         statement = false;                 /**< Whether the state is a prepared statement */
+};
+
+/**
+ * Split a query into words, numbers, quoted strings and single characters. The
+ * words and backquoted identifiers are lowercased and the quotes of the
+ * identifiers are removed. The queries with comments, escapes, double quotes or
+ * non-ASCII characters are not split, as their meaning can depend on the SQL
+ * mode or the character set of the connection.
+ *
+ * @param sql    The query
+ * @param tokens The tokens of the query
+ *
+ * @return True if the query was split
+ */
+inline bool split_query(const std::string& sql, std::vector<std::string>* tokens)
+{
+    bool rval = true;
+    size_t i = 0;
+
+    while (i < sql.length() && rval)
+    {
+        unsigned char c = sql[i];
+        size_t start = i++;
+
+        if (isspace(c))
+        {
+        }
+        else if (c < 0x20 || c > 0x7e || c == '#' || c == '"' || c == '\\'
+                 || (c == '-' && i < sql.length() && sql[i] == '-')
+                 || (c == '/' && i < sql.length() && sql[i] == '*'))
+        {
+            rval = false;
+        }
+        else if (isalnum(c) || c == '_' || c == '$')
+        {
+            while (i < sql.length() && (isalnum(sql[i]) || sql[i] == '_' || sql[i] == '$'
+                                        || (sql[i] == '.' && isdigit(c))))
+            {
+                ++i;
+            }
+
+            std::string word = sql.substr(start, i - start);
+            std::transform(word.begin(), word.end(), word.begin(), ::tolower);
+            tokens->push_back(word);
+        }
+        else if (c == '\'' || c == '`')
+        {
+            while (i < sql.length() && sql[i] != c && sql[i] >= 0x20 && sql[i] <= 0x7e && sql[i] != '\\')
+            {
+                ++i;
+            }
+
+            if (i == sql.length() || sql[i] != c)
+            {
+                rval = false;
+            }
+            else if (c == '`')
+            {
+                std::string word = sql.substr(start + 1, i++ - start - 1);
+                std::transform(word.begin(), word.end(), word.begin(), ::tolower);
+                tokens->push_back(word);
+            }
+            else
+            {
+                tokens->push_back(sql.substr(start, ++i - start));
+            }
+        }
+        else if ((c == '@' && i < sql.length() && sql[i] == '@')
+                 || (c == ':' && i < sql.length() && sql[i] == '='))
+        {
+            tokens->push_back(sql.substr(start, ++i - start));
+        }
+        else
+        {
+            tokens->push_back(std::string(1, c));
+        }
+    }
+
+    return rval;
+}
+
+/**
+ * Get the session state that a query sets
+ *
+ * Only the queries that assign a literal value to one variable, change the
+ * default database or character set, or prepare and deallocate statements by
+ * name are understood.
+ *
+ * @param sql The query
+ *
+ * @return The state the query sets
+ */
+inline SescmdState get_query_state(const std::string& sql)
+{
+    SescmdState state;
+    std::vector<std::string> tokens;
+
+    if (split_query(sql, &tokens))
+    {
+        size_t i = 0;
+        auto accept = [&](const char* token) {
+                bool found = i < tokens.size() && tokens[i] == token;
+                i += found;
+                return found;
+            };
+        auto accept_name = [&](std::string* name) {
+                bool found = i < tokens.size() && (isalnum(tokens[i][0]) || tokens[i][0] == '_');
+                *name = found ? tokens[i++] : "";
+                return found;
+            };
+        auto accept_string = [&]() {
+                bool found = i < tokens.size() && tokens[i][0] == '\'';
+                i += found;
+                return found;
+            };
+        auto accept_number = [&]() {
+                size_t sign = i < tokens.size() && (tokens[i] == "-" || tokens[i] == "+");
+                bool found = i + sign < tokens.size() && isdigit(tokens[i + sign][0]);
+                i += found ? sign + 1 : 0;
+                return found;
+            };
+        auto at_end = [&]() {
+                accept(";");
+                return i == tokens.size();
+            };
+
+        std::string name;
+        std::string value;
+        std::string key;
+        sescmd_reads reads = SESCMD_READS_NOTHING;
+        bool drops = false;
+
+        if (accept("use"))
+        {
+            if (accept_name(&name))
+            {
+                key = "db";
+            }
+        }
+        else if (accept("set"))
+        {
+            if (accept("names"))
+            {
+                if ((accept_name(&name) || accept_string())
+                    && (!accept("collate") || accept_name(&name) || accept_string()))
+                {
+                    key = "names";
+                }
+            }
+            else if (accept("@"))
+            {
+                // The value of a user variable can be anything, so only literals are accepted
+                if (accept_name(&name) && (accept("=") || accept(":="))
+                    && (accept_number() || accept_string() || accept("null")))
+                {
+                    key = "user:" + name;
+                }
+            }
+            else
+            {
+                // SET SESSION var, SET @@var or SET @@session.var
+                if (accept("@@"))
+                {
+                    if ((accept("session") || accept("local")) && !accept("."))
+                    {
+                        i = tokens.size();
+                    }
+                }
+                else if (!accept("session"))
+                {
+                    accept("local");
+                }
+
+                static const char* not_variables[] =
+                {
+                    "global", "transaction", "character", "charset", "password", "role", "default",
+                    "statement", "names"
+                };
+
+                if (accept_name(&name)
+                    && std::find(std::begin(not_variables), std::end(not_variables), name)
+                    == std::end(not_variables)
+                    && (accept("=") || accept(":="))
+                    && (accept_number() || accept_string() || accept_name(&value)))
+                {
+                    key = "var:" + name;
+                }
+            }
+        }
+        else if (accept("prepare"))
+        {
+            if (accept_name(&name) && accept("from") && (accept_string() || (accept("@") && accept_name(&value))))
+            {
+                key = "ps:" + name;
+                reads = SESCMD_READS_VARIABLES;
+            }
+        }
+        else if (accept("deallocate") || accept("drop"))
+        {
+            if (accept("prepare") && accept_name(&name))
+            {
+                key = "ps:" + name;
+                drops = true;
+            }
+        }
+
+        if (!key.empty() && at_end())
+        {
+            state.key = key;
+            state.reads = reads;
+            state.drops = drops;
+            state.statement = key.compare(0, 3, "ps:") == 0;
+        }
+    }
+
+    return state;
+}
+
+/**
+ * @return The state set by a COM_INIT_DB
+ */
+inline SescmdState init_db_state()
+{
+    SescmdState state;
+    state.key = "db";
+    state.reads = SESCMD_READS_NOTHING;
+    return state;
+}
+
+/**
+ * The binary protocol statements are identified by the internal ID, which is
+ * the position of the COM_STMT_PREPARE in the history.
+ *
+ * @param pos The position of the COM_STMT_PREPARE
+ *
+ * @return The state set by the COM_STMT_PREPARE
+ */
+inline SescmdState stmt_prepare_state(uint64_t pos)
+{
+    SescmdState state;
+    state.key = "stmt:" + std::to_string(pos);
+    state.reads = SESCMD_READS_VARIABLES;
+    state.statement = true;
+    return state;
+}
+
+/**
+ * @param id The internal ID of the statement
+ *
+ * @return The state removed by a COM_STMT_CLOSE
+ */
+inline SescmdState stmt_close_state(uint32_t id)
+{
+    SescmdState state;
+    state.key = "stmt:" + std::to_string(id);
+    state.reads = SESCMD_READS_NOTHING;
+    state.drops = true;
+    state.statement = true;
+    return state;
+}
+
+/**
+ * Finds the session commands that later commands have made unnecessary
+ *
+ * When a command sets the same session state as an earlier command, the earlier
+ * one is removed as long as no command in between could depend on it.
+ */
+class SescmdCompaction
+{
+public:
+    /**
+     * Add a completed session command. The commands must be added in the order
+     * they were executed, except that the commands without a response may be
+     * added before the responses to the earlier commands have arrived.
+     *
+     * @param pos    The position of the command
+     * @param state  The state the command sets, the default state if the command failed
+     * @param remove Function that removes the command at the given position from the
+     *               history and returns true if the command was there
+     */
+    template<class Remove>
+    void add(uint64_t pos, const SescmdState& state, Remove remove)
+    {
+        if (!state.key.empty())
+        {
+            auto it = m_keys.find(state.key);
+            bool removed = false;
+
+            if (it != m_keys.end())
+            {
+                uint64_t barrier = state.statement ? m_barrier : std::max(m_barrier, m_var_barrier);
+                removed = it->second >= barrier && remove(it->second);
+            }
+
+            if (removed && state.drops)
+            {
+                // Nothing is left to remove on new connections
+                remove(pos);
+                m_keys.erase(it);
+            }
+            else
+            {
+                m_keys[state.key] = pos;
+            }
+        }
+
+        if (state.reads == SESCMD_READS_EVERYTHING)
+        {
+            m_barrier = std::max(m_barrier, pos);
+        }
+        else if (state.reads == SESCMD_READS_VARIABLES)
+        {
+            m_var_barrier = std::max(m_var_barrier, pos);
+        }
+    }
+
+    /**
+     * Forget the added commands, when the history is reset
+     */
+    void clear()
+    {
+        m_keys.clear();
+        m_barrier = 0;
+        m_var_barrier = 0;
+    }
+
+private:
+    std::unordered_map<std::string, uint64_t> m_keys;   // The latest command that set each state
+    uint64_t m_barrier = 0;     // The latest command that can depend on anything
+    uint64_t m_var_barrier = 0; // The latest command that can depend on the variables
+};
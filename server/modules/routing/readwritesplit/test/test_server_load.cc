@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "../server_load.hh"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+using std::cout;
+
+namespace
+{
+
+bool close_to(double a, double b)
+{
+    return fabs(a - b) < 1e-12;
+}
+
+/**
+ * A simulated server that handles one request at a time in the order they arrive.
+ */
+struct Server
+{
+    double     service_time;    // How long a request takes, in seconds
+    double     free_at = 0;     // When the server has handled the requests it has been sent
+    ServerLoad load;
+};
+
+struct Phase
+{
+    const char* name;
+    double      service_times[3];   // The service times of the servers during the phase
+    double      min_share;          // The smallest acceptable share of the first server
+    double      max_share;          // The largest acceptable share of the first server
+};
+
+/**
+ * Send requests to three servers chosen with the power of two choices, one request
+ * every millisecond, and check which share of the requests the first server gets.
+ * The first server is degraded for the second phase, after which it recovers.
+ *
+ * @return Number of errors
+ */
+int test_simulation()
+{
+    const int N_REQUESTS = 20000;
+    const double INTERVAL = 0.001;
+    const Phase phases[] =
+    {
+        {"normal",    {0.001, 0.001, 0.001}, 0.25, 0.42},
+        {"degraded",  {0.010, 0.001, 0.001}, 0.00, 0.05},
+        {"recovered", {0.001, 0.001, 0.001}, 0.25, 0.42},
+    };
+
+    std::mt19937 random_engine(4711);
+    auto random = [&](size_t n) {
+            return std::uniform_int_distribution<size_t>(0, n - 1)(random_engine);
+        };
+
+    std::vector<Server> servers(3);
+    std::multimap<double, std::pair<int, double>> replies;  // Reply time -> server and send time
+    double now = 0;
+    int errors = 0;
+
+    for (const auto& phase : phases)
+    {
+        int counts[3] = {};
+
+        for (int i = 0; i < 3; ++i)
+        {
+            servers[i].service_time = phase.service_times[i];
+        }
+
+        for (int n = 0; n < N_REQUESTS; ++n)
+        {
+            now += INTERVAL;
+
+            // Deliver the replies due by now
+            while (!replies.empty() && replies.begin()->first <= now)
+            {
+                auto reply = *replies.begin();
+                replies.erase(replies.begin());
+
+                ServerLoad& load = servers[reply.second.first].load;
+                load.request_ended();
+                load.add_sample(reply.first - reply.second.second, reply.first);
+            }
+
+            double costs[3];
+            double fastest = 0;
+
+            for (const auto& server : servers)
+            {
+                double latency = server.load.latency(now);
+
+                if (latency > 0 && (fastest == 0 || latency < fastest))
+                {
+                    fastest = latency;
+                }
+            }
+
+            for (int i = 0; i < 3; ++i)
+            {
+                costs[i] = servers[i].load.cost(fastest > 0 ? fastest : 1, now);
+            }
+
+            int chosen = power_of_two_choices(costs, 3, random);
+            Server& server = servers[chosen];
+
+            server.load.request_started();
+            server.free_at = std::max(server.free_at, now) + server.service_time;
+            replies.emplace(server.free_at, std::make_pair(chosen, now));
+            ++counts[chosen];
+        }
+
+        double share = (double)counts[0] / N_REQUESTS;
+
+        cout << phase.name << ": " << counts[0] << ", " << counts[1] << ", " << counts[2]
+             << " requests, share of the first server " << share << "\n";
+
+        if (share < phase.min_share || share > phase.max_share)
+        {
+            cout << "Share of the first server is not between " << phase.min_share
+                 << " and " << phase.max_share << ".\n";
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+/**
+ * Test the average response time and the picking of the candidates.
+ *
+ * @return Number of errors
+ */
+int test_load()
+{
+    int errors = 0;
+    ServerLoad load;
+
+    load.add_sample(0.010, 10);
+
+    if (!close_to(load.latency(10), 0.010))
+    {
+        cout << "The first sample should be the average.\n";
+        errors++;
+    }
+
+    load.add_sample(0.020, 10);
+
+    if (!close_to(load.latency(10), 0.010 + ServerLoad::ALPHA * 0.010))
+    {
+        cout << "A sample should move the average by ALPHA of the difference.\n";
+        errors++;
+    }
+
+    if (!close_to(load.latency(10 + 2 * ServerLoad::HALF_LIFE), load.latency(10) / 4))
+    {
+        cout << "The average should halve in HALF_LIFE seconds without samples.\n";
+        errors++;
+    }
+
+    load.request_ended();
+
+    if (load.outstanding() != 0)
+    {
+        cout << "The number of outstanding requests should not go below zero.\n";
+        errors++;
+    }
+
+    const double costs[] = {3, 1, 2};
+    int counts[3] = {};
+    std::mt19937 random_engine(4711);
+
+    for (int i = 0; i < 3000; ++i)
+    {
+        ++counts[power_of_two_choices(costs, 3, [&](size_t n) {
+                                          return std::uniform_int_distribution<size_t>(0, n - 1)(
+                                              random_engine);
+                                      })];
+    }
+
+    // The most expensive one never wins, the cheapest one wins both of its pairs
+    if (counts[0] != 0 || counts[1] < counts[2])
+    {
+        cout << "Wrong picks: " << counts[0] << ", " << counts[1] << ", " << counts[2] << ".\n";
+        errors++;
+    }
+
+    return errors;
+}
+}
+
+int main()
+{
+    int result = 0;
+    result += test_load();
+    result += test_simulation();
+    return result;
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "../sescmd_compaction.hh"
+
+#include <algorithm>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+using std::cout;
+
+namespace
+{
+
+/**
+ * A session command of a test. The queries are numbered from one in the order
+ * they are listed, which is also their position in the history.
+ */
+struct Command
+{
+    std::string query;          // The query, or empty for a binary protocol command
+    bool        ok;             // Whether the command succeeded
+    SescmdState state;          // The state of a binary protocol command
+};
+
+Command query(const std::string& sql, bool ok = true)
+{
+    return Command {sql, ok, SescmdState()};
+}
+
+Command binary(const SescmdState& state)
+{
+    return Command {"", true, state};
+}
+
+/**
+ * Pass the commands to the compaction and check which ones remain in the history
+ *
+ * @param name      Name of the test
+ * @param commands  The commands
+ * @param expected  The positions of the commands expected to remain
+ *
+ * @return Number of errors
+ */
+int test(const char* name, const std::vector<Command>& commands, const std::list<uint64_t>& expected)
+{
+    SescmdCompaction compaction;
+    std::list<uint64_t> history;
+    uint64_t pos = 0;
+
+    for (const auto& cmd : commands)
+    {
+        history.push_back(++pos);
+
+        SescmdState state;
+
+        if (cmd.ok)
+        {
+            state = cmd.query.empty() ? cmd.state : get_query_state(cmd.query);
+        }
+
+        compaction.add(pos, state, [&](uint64_t p) {
+                           auto it = std::find(history.begin(), history.end(), p);
+                           bool found = it != history.end();
+
+                           if (found)
+                           {
+                               history.erase(it);
+                           }
+
+                           return found;
+                       });
+    }
+
+    int errors = 0;
+
+    if (history != expected)
+    {
+        cout << name << ": expected the commands";
+
+        for (auto p : expected)
+        {
+            cout << " " << p;
+        }
+
+        cout << " to remain, got";
+
+        for (auto p : history)
+        {
+            cout << " " << p;
+        }
+
+        cout << ".\n";
+        errors++;
+    }
+
+    return errors;
+}
+
+/**
+ * Check that the queries that must not be compacted are not understood
+ *
+ * @return Number of errors
+ */
+int test_not_understood()
+{
+    const char* queries[] =
+    {
+        "SET @@global.max_connections=100",
+        "SET GLOBAL max_connections=100",
+        "SET autocommit=1, @a=2",
+        "SET a=1, b=2",
+        "SET @a=@b",
+        "SET @a=@a+1",
+        "SET @a=NOW()",
+        "SET /* comment */ autocommit=1",
+        "SET autocommit=1 -- comment",
+        "SET autocommit=1 # comment",
+        "SET @a='x\\'y'",
+        "SET @a=\"x\"",
+        "SET @a='\xc3\xa9'",
+        "SET @a='unterminated",
+        "SET TRANSACTION ISOLATION LEVEL READ COMMITTED",
+        "SET PASSWORD = PASSWORD('x')",
+        "SET STATEMENT max_statement_time=1 FOR SELECT 1",
+        "USE db; SELECT 1",
+        "SELECT 1",
+    };
+
+    int errors = 0;
+
+    for (auto sql : queries)
+    {
+        SescmdState state = get_query_state(sql);
+
+        if (!state.key.empty() || state.reads != SESCMD_READS_EVERYTHING)
+        {
+            cout << "`" << sql << "` should not be understood, got the key '" << state.key << "'.\n";
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+/**
+ * Check the keys of the queries that can be compacted
+ *
+ * @return Number of errors
+ */
+int test_understood()
+{
+    const std::pair<const char*, const char*> queries[] =
+    {
+        {"SET autocommit=1",                      "var:autocommit"},
+        {"set AUTOCOMMIT = 0;",                   "var:autocommit"},
+        {"SET SESSION autocommit=ON",             "var:autocommit"},
+        {"SET @@autocommit=1",                    "var:autocommit"},
+        {"SET @@session.sql_mode='ANSI'",         "var:sql_mode"},
+        {"SET @A := -1.5",                        "user:a"},
+        {"SET @a = NULL",                         "user:a"},
+        {"SET NAMES utf8mb4 COLLATE utf8mb4_bin", "names"},
+        {"USE `Test`",                            "db"},
+        {"PREPARE s FROM 'SELECT 1'",             "ps:s"},
+        {"DEALLOCATE PREPARE S",                  "ps:s"},
+        {"DROP PREPARE `s`",                      "ps:s"},
+    };
+
+    int errors = 0;
+
+    for (const auto& q : queries)
+    {
+        SescmdState state = get_query_state(q.first);
+
+        if (state.key != q.second)
+        {
+            cout << "`" << q.first << "` should have the key '" << q.second << "', got '"
+                 << state.key << "'.\n";
+            errors++;
+        }
+    }
+
+    return errors;
+}
+}
+
+int main()
+{
+    int errors = 0;
+
+    errors += test_not_understood();
+    errors += test_understood();
+
+    errors += test("Same variable",
+                   {query("SET autocommit=0"), query("USE db1"), query("SET autocommit=1"),
+                    query("USE db2"), query("SET NAMES latin1"), query("SET NAMES utf8")},
+                   {3, 4, 6});
+
+    errors += test("User variable read in between",
+                   {query("SET @a=1"), query("SET @b=@a"), query("SET @a=2")},
+                   {1, 2, 3});
+
+    errors += test("User variable read by PREPARE in between",
+                   {query("SET @q='SELECT 1'"), query("PREPARE s FROM @q"), query("SET @q='SELECT 2'")},
+                   {1, 2, 3});
+
+    errors += test("Database read by PREPARE in between",
+                   {query("USE db1"), query("PREPARE s FROM 'SELECT * FROM t'"), query("USE db2")},
+                   {1, 2, 3});
+
+    errors += test("Global variable in between",
+                   {query("SET @a=1"), query("SET @@global.x=1"), query("SET @a=2")},
+                   {1, 2, 3});
+
+    errors += test("Multiple assignments in between",
+                   {query("SET @a=1"), query("SET a=1, b=2"), query("SET @a=2")},
+                   {1, 2, 3});
+
+    errors += test("Comment in between",
+                   {query("SET @a=1"), query("SET /* x */ @a=3"), query("SET @a=2")},
+                   {1, 2, 3});
+
+    errors += test("Escape in between",
+                   {query("SET @a=1"), query("SET @b='x\\'y'"), query("SET @a=2")},
+                   {1, 2, 3});
+
+    errors += test("Re-prepared statement",
+                   {query("PREPARE s FROM 'SELECT 1'"), query("PREPARE t FROM @q"),
+                    query("PREPARE s FROM 'SELECT 2'")},
+                   {2, 3});
+
+    errors += test("Deallocated statement",
+                   {query("SET @a=1"), query("PREPARE s FROM 'SELECT 1'"), query("DEALLOCATE PREPARE s")},
+                   {1});
+
+    errors += test("Deallocated statement read in between",
+                   {query("PREPARE s FROM 'SELECT 1'"), query("EXECUTE s"), query("DEALLOCATE PREPARE s")},
+                   {1, 2, 3});
+
+    errors += test("Closed binary statement",
+                   {binary(stmt_prepare_state(1)), binary(stmt_prepare_state(2)),
+                    binary(stmt_close_state(1))},
+                   {2});
+
+    errors += test("Closed binary statement with another ID",
+                   {binary(stmt_prepare_state(1)), binary(stmt_close_state(2))},
+                   {1, 2});
+
+    errors += test("Failed command",
+                   {query("SET @a=1"), query("SET @a=2", false)},
+                   {1, 2});
+
+    errors += test("Command after a failed one",
+                   {query("SET @a=1"), query("SET @a=2", false), query("SET @a=3")},
+                   {1, 2, 3});
+
+    errors += test("Failed deallocation",
+                   {query("PREPARE s FROM 'SELECT 1'"), query("DEALLOCATE PREPARE s", false)},
+                   {1, 2});
+
+    return errors;
+}